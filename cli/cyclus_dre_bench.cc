@@ -0,0 +1,164 @@
+// Replays exchange graphs captured from simulations (see ExchangeCapture)
+// through one or more solvers and reports how each one did, e.g.:
+//
+//   CYCLUS_CAPTURE_DRE=run.dre cyclus input.xml
+//   cyclus_dre_bench --solver greedy --solver network run.dre
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "error.h"
+#include "exchange_capture.h"
+#include "exchange_graph.h"
+#include "exchange_solver.h"
+#include "greedy_solver.h"
+#include "hybrid_solver.h"
+#include "network_solver.h"
+#include "platform.h"
+#if CYCLUS_HAS_COIN
+#include "prog_solver.h"
+#endif
+
+namespace po = boost::program_options;
+
+using namespace cyclus;
+
+static std::string usage =
+    "Usage:   cyclus_dre_bench [opts] capture-file [capture-file ...]";
+
+// Returns the names of all solvers that can be benchmarked.
+static std::vector<std::string> SolverNames() {
+  std::vector<std::string> names;
+  names.push_back("greedy");
+#if CYCLUS_HAS_COIN
+  names.push_back("coin-or");
+#endif
+  names.push_back("network");
+  names.push_back("hybrid");
+  return names;
+}
+
+// Returns a new solver by its input file name, or NULL if there is none.
+static ExchangeSolver* NewSolver(const std::string& name, bool exclusive) {
+  if (name == "greedy") {
+    return new GreedySolver(exclusive);
+  } else if (name == "network") {
+    return new NetworkSolver(exclusive);
+  } else if (name == "hybrid") {
+    return new HybridSolver(exclusive);
+#if CYCLUS_HAS_COIN
+  } else if (name == "coin-or") {
+    return new ProgSolver("cbc", exclusive);
+#endif
+  }
+  return NULL;
+}
+
+// Solves a fresh copy of the captured graph repeat times with the named solver
+// and prints one result row with the fastest time.
+static void Bench(const std::string& file, int record,
+                  const ExchangeCapture& cap, const std::string& fp,
+                  const std::string& name, bool exclusive, int repeat) {
+  typedef std::chrono::steady_clock Clock;
+  double secs = std::numeric_limits<double>::max();
+  double obj = 0;
+  ExchangeGraph::Ptr g;
+  for (int i = 0; i < repeat; ++i) {
+    g = ExchangeGraph::FromFingerprint(fp);
+    ExchangeSolver* solver = NewSolver(name, exclusive);
+    Clock::time_point start = Clock::now();
+    obj = solver->Solve(g.get());
+    secs = std::min(
+        secs, std::chrono::duration<double>(Clock::now() - start).count());
+    delete solver;
+  }
+
+  double qty = 0;
+  const std::vector<Match>& matches = g->matches();
+  for (int i = 0; i < matches.size(); ++i) {
+    qty += matches[i].second;
+  }
+  std::cout << file << "\t" << record << "\t" << cap.time << "\t"
+            << cap.restype << "\t" << name << "\t" << g->arcs().size() << "\t"
+            << secs << "\t" << obj << "\t" << matches.size() << "\t" << qty
+            << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  po::options_description desc("Allowed options");
+  desc.add_options()
+      ("help,h", "produce help message")
+      ("solver,s", po::value<std::vector<std::string> >(),
+       "solver to benchmark (may be repeated), one of greedy, coin-or, "
+       "network, or hybrid; all available solvers by default")
+      ("exclusive", po::value<bool>()->default_value(
+           ExchangeSolver::kDefaultExclusive),
+       "whether solvers allow exclusive orders")
+      ("repeat,r", po::value<int>()->default_value(1),
+       "solve each graph this many times and report the fastest")
+      ("capture-file", po::value<std::vector<std::string> >(),
+       "exchange capture file(s) to replay");
+  po::positional_options_description p;
+  p.add("capture-file", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc).positional(p).run(), vm);
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << "\n\n" << usage << "\n\n" << desc << "\n";
+    return 1;
+  }
+  if (vm.count("help") > 0 || vm.count("capture-file") == 0) {
+    std::cout << usage << "\n\n" << desc << "\n";
+    return vm.count("help") > 0 ? 0 : 1;
+  }
+
+  std::vector<std::string> solvers = SolverNames();
+  if (vm.count("solver") > 0) {
+    solvers = vm["solver"].as<std::vector<std::string> >();
+  }
+  for (int i = 0; i < solvers.size(); ++i) {
+    ExchangeSolver* s = NewSolver(solvers[i], true);
+    if (s == NULL) {
+      std::cerr << "unknown or unavailable solver: " << solvers[i] << "\n";
+      return 1;
+    }
+    delete s;
+  }
+  bool exclusive = vm["exclusive"].as<bool>();
+  int repeat = std::max(1, vm["repeat"].as<int>());
+
+  std::cout << "File\tRecord\tTime\tResourceType\tSolver\tArcs\tSeconds\t"
+            << "Objective\tMatches\tMatchedQty\n";
+  std::vector<std::string> files =
+      vm["capture-file"].as<std::vector<std::string> >();
+  for (int f = 0; f < files.size(); ++f) {
+    std::ifstream is(files[f].c_str(), std::ios::in | std::ios::binary);
+    if (!is) {
+      std::cerr << "could not open capture file " << files[f] << "\n";
+      return 1;
+    }
+
+    try {
+      ExchangeCapture cap;
+      for (int record = 0; cap.Read(is); ++record) {
+        std::string fp = cap.graph->Fingerprint();
+        for (int i = 0; i < solvers.size(); ++i) {
+          Bench(files[f], record, cap, fp, solvers[i], exclusive, repeat);
+        }
+      }
+    } catch (Error& e) {
+      std::cerr << files[f] << ": " << e.what() << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
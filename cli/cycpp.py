@@ -629,7 +629,11 @@ class NoteDecorationFilter(DecorationFilter):
         #pragma cyclus note <dict>
 
     This evals the contents of dict and merges them in as the class-level
-    annotations dict.
+    annotations dict. The 'threadsafe' key, if present, must be a bool and
+    declares that the kernel may call the agent's Tick, Tock, and Decision
+    methods concurrently with those of other thread safe agents. Likewise, the
+    'reentrant' key declares that the agent's request and bid queries may be
+    made concurrently with those of other re-entrant traders.
     """
     regex = re.compile(r"\s*#\s*pragma\s+cyclus\s+note\s+(.*)")
 
@@ -638,6 +642,11 @@ class NoteDecorationFilter(DecorationFilter):
         context = state.context
         classname = state.classname()
         annotations = self._eval()
+        for key in ('threadsafe', 'reentrant'):
+            flag = annotations.get(key, False)
+            if not isinstance(flag, bool):
+                msg = "the {0!r} note of {1} must be a bool, got {2!r}"
+                raise TypeError(msg.format(key, classname, flag))
         state.ensure_class_context(classname)
         self.update(context[classname], annotations)
 
@@ -604,7 +604,7 @@ cdef extern from "bid_portfolio.h" namespace "cyclus":
         void AddConstraint(const CapacityConstraint[T]&)
         Trader* bidder()
         std_string commodity()
-        set[bid_ptr]& bids()
+        vector[bid_ptr]& bids()
         set[CapacityConstraint[T]]& constraints()
 
 
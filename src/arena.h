@@ -0,0 +1,96 @@
+#ifndef CYCLUS_SRC_ARENA_H_
+#define CYCLUS_SRC_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cyclus {
+
+/// @class Arena
+///
+/// @brief An Arena is a monotonic pool of objects of a single type. Objects
+/// are constructed in place in blocks that grow geometrically, so creating n
+/// objects costs O(log n) allocations. Objects never move and are never freed
+/// individually; they are all destroyed, in the order they were created, when
+/// the arena is cleared or destroyed. An arena is not synchronized; each one
+/// is filled by a single thread at a time, e.g., by the trader that owns the
+/// portfolio holding it.
+///
+/// Types with private constructors may befriend Arena<T> so that only their
+/// owners can create them, e.g., Bid and BidPortfolio.
+template <class T>
+class Arena {
+ public:
+  /// the number of objects in the first block
+  static constexpr std::size_t kFirstBlock = 8;
+
+  /// the number of objects in a block never grows past this
+  static constexpr std::size_t kMaxBlock = 1024;
+
+  Arena() : size_(0), avail_(0) {}
+
+  ~Arena() { Clear(); }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /// constructs a new object in the arena from args
+  /// @return the new object, which is owned by the arena
+  template <class... Args>
+  T* New(Args&&... args) {
+    if (avail_ == 0) {
+      Grow();
+    }
+    Block& b = blocks_.back();
+    T* t = new (b.data + b.size) T(std::forward<Args>(args)...);
+    b.size++;
+    avail_--;
+    size_++;
+    return t;
+  }
+
+  /// destroys all objects and frees all blocks
+  void Clear() {
+    for (std::size_t i = 0; i < blocks_.size(); ++i) {
+      T* data = reinterpret_cast<T*>(blocks_[i].data);
+      for (std::size_t j = 0; j < blocks_[i].size; ++j) {
+        data[j].~T();
+      }
+      delete[] blocks_[i].data;
+    }
+    blocks_.clear();
+    size_ = 0;
+    avail_ = 0;
+  }
+
+  /// @return the number of objects in the arena
+  inline std::size_t size() const { return size_; }
+
+ private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+  struct Block {
+    Storage* data;
+    std::size_t size;
+  };
+
+  void Grow() {
+    std::size_t n = blocks_.empty() ? kFirstBlock
+                                    : std::min(2 * size_, kMaxBlock);
+    Block b = {new Storage[n], 0};
+    blocks_.push_back(b);
+    avail_ = n;
+  }
+
+  std::vector<Block> blocks_;
+  std::size_t size_;
+  std::size_t avail_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ARENA_H_
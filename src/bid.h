@@ -5,6 +5,7 @@
 #include <boost/weak_ptr.hpp>
 #include <limits>
 
+#include "arena.h"
 #include "request.h"
 #include "package.h"
 
@@ -93,6 +94,9 @@ template <class T> class Bid {
   inline double preference() const { return preference_; }
 
  private:
+  /// portfolios allocate their bids in an arena
+  friend class Arena<Bid<T>>;
+
   /// @brief constructors are private to require use of factory methods
   Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
       bool exclusive, double preference,
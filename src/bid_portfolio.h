@@ -4,9 +4,11 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
+#include "arena.h"
 #include "bid.h"
 #include "capacity_constraint.h"
 #include "error.h"
@@ -28,6 +30,9 @@ std::string GetTraderSpec(Trader* bidder);
 /// and constraints for a given bidder, guaranteeing a single bidder per
 /// portfolio. Responses are grouped by the bidder. Constraints are assumed to
 /// act over the entire set of possible bids.
+///
+/// Bids are allocated together in an Arena owned by the portfolio and are
+/// freed all at once with it. They are iterated in the order they were added.
 template <class T>
 class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
  public:
@@ -36,13 +41,6 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// @brief default constructor
   BidPortfolio() : bidder_(NULL) {}
 
-  /// deletes all bids associated with it
-  ~BidPortfolio() {
-    typename std::set<Bid<T>*>::iterator it;
-    for (it = bids_.begin(); it != bids_.end(); ++it) {
-      delete *it;
-    }
-  }
 
   /// @brief add a bid to the portfolio
   /// @param request the request being responded to by this bid
@@ -55,17 +53,16 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// original
   Bid<T>* AddBid(Request<T>* request, boost::shared_ptr<T> offer,
                  Trader* bidder, bool exclusive, double preference) {
-    Bid<T>* b = Bid<T>::Create(request, offer, bidder, this->shared_from_this(),
-                               exclusive, preference);
-    VerifyResponder_(b);
-    if (offer->quantity() > 0)
-      bids_.insert(b);
-    else {
+    VerifyResponder_(bidder);
+    if (offer->quantity() <= 0) {
       std::stringstream ss;
       ss << GetTraderPrototype(bidder) << " from " << GetTraderSpec(bidder)
          << " is offering a bid quantity <= 0, Q = " << offer->quantity();
       throw ValueError(ss.str());
     }
+    Bid<T>* b = arena_.New(request, offer, bidder, this->shared_from_this(),
+                           exclusive, preference);
+    bids_.push_back(b);
     return b;
   }
 
@@ -95,8 +92,8 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// @return *deprecated* the commodity associated with the portfolio.
   inline std::string commodity() const { return ""; }
 
-  /// @return const access to the bids
-  inline const std::set<Bid<T>*>& bids() const { return bids_; }
+  /// @return const access to the bids in the order they were added
+  inline const std::vector<Bid<T>*>& bids() const { return bids_; }
 
   /// @return the set of constraints over the bids
   inline const std::set<CapacityConstraint<T>>& constraints() const {
@@ -106,25 +103,17 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
  private:
   /// @brief copy constructor is private to prevent copying and preserve
   /// explicit single-ownership of bids
-  BidPortfolio(const BidPortfolio& rhs) {
-    bidder_ = rhs.bidder_;
-    bids_ = rhs.bids_;
-    constraints_ = rhs.constraints_;
-    typename std::set<Bid<T>*>::iterator it;
-    for (it = bids_.begin(); it != bids_.end(); ++it) {
-      it->get()->set_portfolio(this->shared_from_this());
-    }
-  }
+  BidPortfolio(const BidPortfolio& rhs);
 
   /// @brief if the bidder has not been determined yet, it is set. Otherwise
   /// VerifyResponder() verifies the bid is associated with the
   /// portfolio's bidder
   /// @throws KeyError if a bid is added from a different bidder than the
   /// original
-  void VerifyResponder_(Bid<T>* b) {
+  void VerifyResponder_(Trader* bidder) {
     if (bidder_ == NULL) {
-      bidder_ = b->bidder();
-    } else if (bidder_ != b->bidder()) {
+      bidder_ = bidder;
+    } else if (bidder_ != bidder) {
       std::string msg = "Insertion error: bidders do not match.";
       throw KeyError(msg);
     }
@@ -133,9 +122,13 @@ class BidPortfolio : public boost::enable_shared_from_this<BidPortfolio<T>> {
   /// @brief *deprecated*
   void VerifyCommodity_(const Bid<T>* r) {}
 
-  // bid_ is a set because there is a one-to-one correspondence between a
-  // bid and a request, i.e., bids are unique
-  std::set<Bid<T>*> bids_;
+  // owns the bids
+  Arena<Bid<T>> arena_;
+
+  // bids_ is a vector rather than a set ordered by address so that bids are
+  // always visited in a reproducible order; each bid is created by AddBid, so
+  // they are unique
+  std::vector<Bid<T>*> bids_;
 
   // constraints_ is a set because constraints are assumed to be unique
   std::set<CapacityConstraint<T>> constraints_;
@@ -133,5 +133,146 @@ bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold) {
   return true;
 }
 
+// Returns v1 + sign * v2 over the union of their nuclides.
+static NucVec AddScaled(const NucVec& v1, const NucVec& v2, double sign) {
+  NucVec out(v1);
+  std::vector<double>& o = out.vals();
+  const std::vector<double>& b = v2.vals();
+  if (v1.SameNucs(v2)) {
+    double* po = o.data();
+    const double* pb = b.data();
+    int n = o.size();
+    for (int k = 0; k < n; ++k) {
+      po[k] += sign * pb[k];
+    }
+    return out;
+  }
+
+  // merge the two sorted nuclide lists
+  const std::vector<Nuc>& na = v1.nucs();
+  const std::vector<Nuc>& nb = v2.nucs();
+  const std::vector<double>& a = v1.vals();
+  NucVec merged;
+  merged.Reserve(na.size() + nb.size());
+  int i = 0;
+  int j = 0;
+  while (i < na.size() || j < nb.size()) {
+    if (j == nb.size() || (i < na.size() && na[i] < nb[j])) {
+      merged.PushBack(na[i], a[i], v1.dense()[i]);
+      ++i;
+    } else if (i == na.size() || nb[j] < na[i]) {
+      merged.PushBack(nb[j], 0.0 + sign * b[j], v2.dense()[j]);
+      ++j;
+    } else {
+      merged.PushBack(na[i], a[i] + sign * b[j], v1.dense()[i]);
+      ++i;
+      ++j;
+    }
+  }
+  return merged;
+}
+
+NucVec Add(const NucVec& v1, const NucVec& v2) {
+  return AddScaled(v1, v2, 1.0);
+}
+
+NucVec Sub(const NucVec& v1, const NucVec& v2) {
+  return AddScaled(v1, v2, -1.0);
+}
+
+double Sum(const NucVec& v) {
+  return CycArithmetic::KahanSum(v.vals());
+}
+
+void ApplyThreshold(NucVec* v, double threshold) {
+  if (threshold < 0) {
+    std::stringstream ss;
+    ss << "The threshold cannot be negative. The value provided was '"
+       << threshold << "'.";
+    throw ValueError(ss.str());
+  }
+
+  const std::vector<double>& vals = v->vals();
+  int k = 0;
+  while (k < vals.size() && std::abs(vals[k]) > threshold) {
+    ++k;
+  }
+  if (k == vals.size()) {
+    return;  // nothing to remove
+  }
+
+  NucVec kept;
+  kept.Reserve(vals.size());
+  for (k = 0; k < vals.size(); ++k) {
+    if (std::abs(vals[k]) > threshold) {
+      kept.PushBack(v->nucs()[k], vals[k], v->dense()[k]);
+    }
+  }
+  *v = kept;
+}
+
+void Normalize(NucVec* v, double val) {
+  double sum = Sum(*v);
+  if (sum != val && sum != 0) {
+    double mult = val / sum;
+    double* p = v->vals().data();
+    int n = v->size();
+    for (int k = 0; k < n; ++k) {
+      p[k] *= mult;
+    }
+  }
+}
+
+bool ValidNucs(const NucVec& v) {
+  const std::vector<Nuc>& nucs = v.nucs();
+  for (int k = 0; k < nucs.size(); ++k) {
+    if (!pyne::nucname::isnuclide(nucs[k])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AllPositive(const NucVec& v) {
+  const double* p = v.vals().data();
+  int n = v.size();
+  bool pos = true;
+  for (int k = 0; k < n; ++k) {
+    pos &= !(p[k] < 0);
+  }
+  return pos;
+}
+
+bool AlmostEq(const NucVec& v1, const NucVec& v2, double threshold) {
+  // same test as for CompMaps, see above
+  if (threshold < 0) {
+    std::stringstream ss;
+    ss << "The threshold cannot be negative. The value provided was '"
+       << threshold << "'.";
+    throw ValueError(ss.str());
+  }
+
+  if (!v1.SameNucs(v2)) {
+    return false;
+  }
+
+  const double* p1 = v1.vals().data();
+  const double* p2 = v2.vals().data();
+  int n = v1.size();
+  bool eq = true;
+  for (int k = 0; k < n; ++k) {
+    double minuend = p2[k];
+    double subtrahend = p1[k];
+    double diff = std::abs(minuend - subtrahend);
+    if (minuend == 0 || subtrahend == 0) {
+      eq &= !(diff > diff * threshold);
+    } else {
+      eq &= !(diff > std::abs(minuend) * threshold ||
+              diff > std::abs(subtrahend) * threshold);
+    }
+  }
+  return eq;
+}
+
 }  // namespace compmath
 }  // namespace cyclus
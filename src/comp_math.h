@@ -49,6 +49,22 @@ bool AllPositive(const CompMap& v);
 /// normalization is performed.
 bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold);
 
+/// @name NucVec kernels
+/// The functions below behave exactly like their CompMap counterparts, but
+/// work on contiguous NucVec arrays. When both operands have the same
+/// nuclides (e.g., mixing streams made from the same recipe) the element-wise
+/// kernels reduce to single loops over the quantities.
+/// @{
+NucVec Add(const NucVec& v1, const NucVec& v2);
+NucVec Sub(const NucVec& v1, const NucVec& v2);
+double Sum(const NucVec& v);
+void ApplyThreshold(NucVec* v, double threshold);
+void Normalize(NucVec* v, double val = 1.0);
+bool ValidNucs(const NucVec& v);
+bool AllPositive(const NucVec& v);
+bool AlmostEq(const NucVec& v1, const NucVec& v2, double threshold);
+/// @}
+
 }  // namespace compmath
 }  // namespace cyclus
 
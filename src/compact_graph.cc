@@ -0,0 +1,238 @@
+#include "compact_graph.h"
+
+#include <unordered_map>
+
+#include "error.h"
+
+namespace cyclus {
+
+CompactGraph::CompactGraph(ExchangeGraph* g) : g_(g) {
+  grp_cap_start_.push_back(0);
+  grp_node_start_.push_back(0);
+
+  std::vector<RequestGroup::Ptr>& rgs = g->request_groups();
+  std::vector<ExchangeNodeGroup::Ptr>& sgs = g->supply_groups();
+  int nnodes = 0;
+  for (int i = 0; i < rgs.size(); ++i) {
+    nnodes += rgs[i]->nodes().size();
+  }
+  for (int i = 0; i < sgs.size(); ++i) {
+    nnodes += sgs[i]->nodes().size();
+  }
+  node_index_.reserve(nnodes);
+
+  for (int i = 0; i < rgs.size(); ++i) {
+    req_qty_.push_back(rgs[i]->qty());
+    AddGroup(rgs[i].get());
+  }
+  for (int i = 0; i < sgs.size(); ++i) {
+    AddGroup(sgs[i].get());
+  }
+
+  // arc ids are assigned in the order arcs are added to the graph, which is
+  // also the order of each node's arcs in the node-arc map, so both can be
+  // filled in with a single pass over the arcs
+  const std::vector<Arc>& arcs = g->arcs();
+  int narcs = arcs.size();
+  arc_u_.resize(narcs);
+  arc_v_.resize(narcs);
+  arc_excl_.resize(narcs);
+  arc_excl_val_.resize(narcs);
+  arc_pref_.resize(narcs);
+  arc_req_pref_.resize(narcs);
+  ucap_start_.reserve(narcs + 1);
+  vcap_start_.reserve(narcs + 1);
+  ucap_start_.push_back(0);
+  vcap_start_.push_back(0);
+
+  std::vector<int> degree(nodes_.size(), 0);
+  for (int a = 0; a < narcs; ++a) {
+    const Arc& arc = arcs[a];
+    ExchangeNode::Ptr u = arc.unode();
+    ExchangeNode::Ptr v = arc.vnode();
+    std::unordered_map<const ExchangeNode*, int>::const_iterator ui =
+        node_index_.find(u.get());
+    std::unordered_map<const ExchangeNode*, int>::const_iterator vi =
+        node_index_.find(v.get());
+    if (ui == node_index_.end() || vi == node_index_.end()) {
+      throw StateError("An arc of the exchange graph connects a node that is "
+                       "not in any of the graph's groups.");
+    }
+
+    arc_u_[a] = ui->second;
+    arc_v_[a] = vi->second;
+    degree[ui->second]++;
+    degree[vi->second]++;
+    arc_excl_[a] = arc.exclusive();
+    arc_excl_val_[a] = arc.excl_val();
+    arc_pref_[a] = arc.pref();
+
+    std::map<Arc, double>::const_iterator p = u->prefs.find(arc);
+    arc_req_pref_[a] = p == u->prefs.end() ? 0 : p->second;
+
+    std::map<Arc, std::vector<double> >::const_iterator c =
+        u->unit_capacities.find(arc);
+    if (c != u->unit_capacities.end()) {
+      ucaps_.insert(ucaps_.end(), c->second.begin(), c->second.end());
+    }
+    ucap_start_.push_back(ucaps_.size());
+
+    c = v->unit_capacities.find(arc);
+    if (c != v->unit_capacities.end()) {
+      vcaps_.insert(vcaps_.end(), c->second.begin(), c->second.end());
+    }
+    vcap_start_.push_back(vcaps_.size());
+  }
+
+  node_arc_start_.resize(nodes_.size() + 1);
+  node_arc_start_[0] = 0;
+  for (int n = 0; n < nodes_.size(); ++n) {
+    node_arc_start_[n + 1] = node_arc_start_[n] + degree[n];
+  }
+  node_arcs_.resize(node_arc_start_.back());
+  std::vector<int> next(node_arc_start_.begin(), node_arc_start_.end() - 1);
+  for (int a = 0; a < narcs; ++a) {
+    node_arcs_[next[arc_u_[a]]++] = a;
+    node_arcs_[next[arc_v_[a]]++] = a;
+  }
+}
+
+void CompactGraph::AddGroup(ExchangeNodeGroup* grp) {
+  int gi = groups_.size();
+  groups_.push_back(grp);
+
+  const std::vector<double>& caps = grp->capacities();
+  caps_.insert(caps_.end(), caps.begin(), caps.end());
+  grp_cap_start_.push_back(caps_.size());
+
+  const std::vector<ExchangeNode::Ptr>& nodes = grp->nodes();
+  for (int i = 0; i < nodes.size(); ++i) {
+    node_index_[nodes[i].get()] = nodes_.size();
+    nodes_.push_back(nodes[i]);
+    node_group_.push_back(gi);
+    node_qty_.push_back(nodes[i]->qty);
+    node_agent_.push_back(nodes[i]->agent_id);
+  }
+  grp_node_start_.push_back(nodes_.size());
+}
+
+bool CompactGraph::Reorder() {
+  std::vector<ExchangeNodeGroup*> order;
+  std::vector<RequestGroup::Ptr>& rgs = g_->request_groups();
+  std::vector<ExchangeNodeGroup::Ptr>& sgs = g_->supply_groups();
+  for (int i = 0; i < rgs.size(); ++i) {
+    order.push_back(rgs[i].get());
+  }
+  for (int i = 0; i < sgs.size(); ++i) {
+    order.push_back(sgs[i].get());
+  }
+  if (order.size() != groups_.size() || rgs.size() != req_qty_.size() ||
+      g_->arcs().size() != arc_u_.size()) {
+    return false;
+  }
+
+  std::unordered_map<const ExchangeNodeGroup*, int> group_index;
+  group_index.reserve(groups_.size());
+  for (int g = 0; g < groups_.size(); ++g) {
+    group_index[groups_[g]] = g;
+  }
+
+  // old_group[g] and old_node[n] are the indices in this snapshot of the
+  // group and node now at g and n
+  std::vector<int> old_group(order.size());
+  std::vector<int> old_node;
+  old_node.reserve(nodes_.size());
+  for (int g = 0; g < order.size(); ++g) {
+    std::unordered_map<const ExchangeNodeGroup*, int>::const_iterator it =
+        group_index.find(order[g]);
+    if (it == group_index.end() || is_request(it->second) != is_request(g)) {
+      return false;
+    }
+    int og = it->second;
+    const std::vector<ExchangeNode::Ptr>& nodes = order[g]->nodes();
+    if (nodes.size() != nodes_end(og) - nodes_begin(og)) {
+      return false;
+    }
+    for (int i = 0; i < nodes.size(); ++i) {
+      std::unordered_map<const ExchangeNode*, int>::const_iterator n =
+          node_index_.find(nodes[i].get());
+      if (n == node_index_.end() || node_group_[n->second] != og) {
+        return false;
+      }
+      old_node.push_back(n->second);
+    }
+    old_group[g] = og;
+  }
+
+  std::vector<ExchangeNodeGroup*> groups(order.size());
+  std::vector<double> req_qty(req_qty_.size());
+  std::vector<int> grp_cap_start(1, 0);
+  std::vector<double> caps;
+  caps.reserve(caps_.size());
+  std::vector<int> grp_node_start(1, 0);
+  std::vector<int> new_group(order.size());
+  for (int g = 0; g < order.size(); ++g) {
+    int og = old_group[g];
+    groups[g] = groups_[og];
+    if (is_request(g)) {
+      req_qty[g] = req_qty_[og];
+    }
+    caps.insert(caps.end(), caps_.begin() + caps_begin(og),
+                caps_.begin() + caps_end(og));
+    grp_cap_start.push_back(caps.size());
+    grp_node_start.push_back(grp_node_start.back() + nodes_end(og) -
+                             nodes_begin(og));
+    new_group[og] = g;
+  }
+
+  int nnodes = nodes_.size();
+  std::vector<ExchangeNode::Ptr> nodes(nnodes);
+  std::vector<int> node_group(nnodes);
+  std::vector<double> node_qty(nnodes);
+  std::vector<int> node_agent(nnodes);
+  std::vector<int> node_arc_start(1, 0);
+  node_arc_start.reserve(nnodes + 1);
+  std::vector<int> node_arcs;
+  node_arcs.reserve(node_arcs_.size());
+  std::vector<int> new_node(nnodes);
+  for (int n = 0; n < nnodes; ++n) {
+    int on = old_node[n];
+    nodes[n] = nodes_[on];
+    node_group[n] = new_group[node_group_[on]];
+    node_qty[n] = node_qty_[on];
+    node_agent[n] = node_agent_[on];
+    node_arcs.insert(node_arcs.end(), node_arcs_.begin() + arcs_begin(on),
+                     node_arcs_.begin() + arcs_end(on));
+    node_arc_start.push_back(node_arcs.size());
+    new_node[on] = n;
+    node_index_[nodes[n].get()] = n;
+  }
+  for (int a = 0; a < arc_u_.size(); ++a) {
+    arc_u_[a] = new_node[arc_u_[a]];
+    arc_v_[a] = new_node[arc_v_[a]];
+  }
+
+  groups_.swap(groups);
+  req_qty_.swap(req_qty);
+  grp_cap_start_.swap(grp_cap_start);
+  caps_.swap(caps);
+  grp_node_start_.swap(grp_node_start);
+  nodes_.swap(nodes);
+  node_group_.swap(node_group);
+  node_qty_.swap(node_qty);
+  node_agent_.swap(node_agent);
+  node_arc_start_.swap(node_arc_start);
+  node_arcs_.swap(node_arcs);
+  return true;
+}
+
+int CompactGraph::node_index(const ExchangeNode* n) const {
+  std::unordered_map<const ExchangeNode*, int>::const_iterator it =
+      node_index_.find(n);
+  if (it == node_index_.end()) {
+    throw KeyError("The node is not part of the exchange graph.");
+  }
+  return it->second;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,165 @@
+#ifndef CYCLUS_SRC_COMPACT_GRAPH_H_
+#define CYCLUS_SRC_COMPACT_GRAPH_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @class CompactGraph
+///
+/// @brief A CompactGraph is an index-based snapshot of an ExchangeGraph, laid
+/// out as contiguous arrays for solvers and translators that visit every arc
+/// of a large exchange. Groups, nodes, and arcs are identified by integers:
+///   - request groups are numbered [0, n_request_groups()) in the order of
+///     ExchangeGraph::request_groups(), followed by the supply groups,
+///   - nodes are numbered group by group in the order of each group's nodes,
+///     so the nodes of group g are [nodes_begin(g), nodes_end(g)),
+///   - arc i is the arc with id i in the ExchangeGraph, i.e., arcs()[i].
+///
+/// Group capacities, unit capacities, and each node's arcs (in the order of
+/// ExchangeGraph::node_arc_map()) are stored in compressed sparse row form.
+/// The snapshot reflects the graph when it was built, so it must be brought
+/// up to date with Reorder() after groups or nodes are reordered and rebuilt
+/// after groups, nodes, or arcs are added. It is built from the
+/// graph, not in place of it: building it looks up every arc's preference and
+/// unit capacities in its nodes' maps once, so solvers should share one
+/// snapshot per graph (see ExchangeSolver::compact_graph). Use it as follows:
+///
+/// @code
+/// CompactGraph cg(graph);
+/// for (int n = cg.nodes_begin(g); n != cg.nodes_end(g); ++n) {
+///   for (int i = cg.arcs_begin(n); i != cg.arcs_end(n); ++i) {
+///     int a = cg.node_arc(i);
+///     // ... cg.unode(a), cg.pref(a), cg.ucaps(a), etc.
+///   }
+/// }
+/// @endcode
+class CompactGraph {
+ public:
+  typedef boost::shared_ptr<CompactGraph> Ptr;
+
+  /// @throws StateError if an arc connects a node that is not in one of the
+  /// graph's groups
+  explicit CompactGraph(ExchangeGraph* g);
+
+  inline ExchangeGraph* graph() const { return g_; }
+
+  /// @brief brings the snapshot up to date with the current order of the
+  /// graph's groups and of each group's nodes, e.g., after a solver sorted
+  /// them, without visiting the arcs' preference and capacity maps again.
+  /// Values are kept as they were when the snapshot was built.
+  /// @return false, leaving the snapshot unchanged, if groups, nodes, or arcs
+  /// were added or removed since it was built, i.e., it must be rebuilt
+  bool Reorder();
+
+  inline int n_groups() const { return grp_node_start_.size() - 1; }
+  inline int n_request_groups() const { return req_qty_.size(); }
+  inline int n_nodes() const { return nodes_.size(); }
+  inline int n_arcs() const { return arc_u_.size(); }
+
+  /// @name groups
+  /// @{
+  inline bool is_request(int g) const { return g < req_qty_.size(); }
+  inline ExchangeNodeGroup* group(int g) const { return groups_[g]; }
+
+  /// the requested quantity of request group g
+  inline double request_qty(int g) const { return req_qty_[g]; }
+
+  /// the capacities of group g are caps()[caps_begin(g)...caps_end(g)]
+  inline const std::vector<double>& caps() const { return caps_; }
+  inline int caps_begin(int g) const { return grp_cap_start_[g]; }
+  inline int caps_end(int g) const { return grp_cap_start_[g + 1]; }
+
+  inline int nodes_begin(int g) const { return grp_node_start_[g]; }
+  inline int nodes_end(int g) const { return grp_node_start_[g + 1]; }
+  /// @}
+
+  /// @name nodes
+  /// @{
+  inline const ExchangeNode::Ptr& node(int n) const { return nodes_[n]; }
+  inline int node_group(int n) const { return node_group_[n]; }
+  inline double qty(int n) const { return node_qty_[n]; }
+  inline int agent_id(int n) const { return node_agent_[n]; }
+
+  /// the arcs of node n are node_arc(i) for i in [arcs_begin(n), arcs_end(n))
+  inline int arcs_begin(int n) const { return node_arc_start_[n]; }
+  inline int arcs_end(int n) const { return node_arc_start_[n + 1]; }
+  inline int node_arc(int i) const { return node_arcs_[i]; }
+
+  /// @throws KeyError if n is not a node of this graph
+  int node_index(const ExchangeNode* n) const;
+  /// @}
+
+  /// @name arcs
+  /// @{
+  inline const Arc& arc(int a) const { return g_->arcs()[a]; }
+  inline int unode(int a) const { return arc_u_[a]; }
+  inline int vnode(int a) const { return arc_v_[a]; }
+  inline bool exclusive(int a) const { return arc_excl_[a] != 0; }
+  inline double excl_val(int a) const { return arc_excl_val_[a]; }
+
+  /// the preference stored on the arc itself
+  inline double pref(int a) const { return arc_pref_[a]; }
+
+  /// the request node's preference for the arc (zero if it has none)
+  inline double req_pref(int a) const { return arc_req_pref_[a]; }
+
+  /// the unode's unit capacities for arc a, one per capacity of its group (or
+  /// none)
+  inline const double* ucaps(int a) const {
+    return ucaps_.data() + ucap_start_[a];
+  }
+  inline int n_ucaps(int a) const {
+    return ucap_start_[a + 1] - ucap_start_[a];
+  }
+
+  /// the vnode's unit capacities for arc a, one per capacity of its group (or
+  /// none)
+  inline const double* vcaps(int a) const {
+    return vcaps_.data() + vcap_start_[a];
+  }
+  inline int n_vcaps(int a) const {
+    return vcap_start_[a + 1] - vcap_start_[a];
+  }
+  /// @}
+
+ private:
+  void AddGroup(ExchangeNodeGroup* grp);
+
+  ExchangeGraph* g_;
+
+  std::vector<ExchangeNodeGroup*> groups_;
+  std::vector<double> req_qty_;
+  std::vector<int> grp_cap_start_;
+  std::vector<double> caps_;
+  std::vector<int> grp_node_start_;
+
+  std::vector<ExchangeNode::Ptr> nodes_;
+  std::unordered_map<const ExchangeNode*, int> node_index_;
+  std::vector<int> node_group_;
+  std::vector<double> node_qty_;
+  std::vector<int> node_agent_;
+  std::vector<int> node_arc_start_;
+  std::vector<int> node_arcs_;
+
+  std::vector<int> arc_u_;
+  std::vector<int> arc_v_;
+  // char rather than bool so that the flags are plain contiguous bytes
+  std::vector<char> arc_excl_;
+  std::vector<double> arc_excl_val_;
+  std::vector<double> arc_pref_;
+  std::vector<double> arc_req_pref_;
+  std::vector<int> ucap_start_;
+  std::vector<double> ucaps_;
+  std::vector<int> vcap_start_;
+  std::vector<double> vcaps_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_COMPACT_GRAPH_H_
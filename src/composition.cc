@@ -1,20 +1,29 @@
 #include "composition.h"
 
+#include <cmath>
+#include <functional>
+#include <set>
+
 #include "comp_math.h"
 #include "context.h"
+#include "decay_batch.h"
 #include "decayer.h"
 #include "error.h"
 #include "recorder.h"
 
-extern "C" {
-#include "cram.hpp"
-}
-
 namespace cyclus {
 
-int Composition::next_id_ = 1;
+IdSeq Composition::next_id_(IdSeq::kCompositions, 1);
 
 Composition::Ptr Composition::CreateFromAtom(CompMap v) {
+  return CreateFromAtom(NucVec(v));
+}
+
+Composition::Ptr Composition::CreateFromMass(CompMap v) {
+  return CreateFromMass(NucVec(v));
+}
+
+Composition::Ptr Composition::CreateFromAtom(const NucVec& v) {
   if (!compmath::ValidNucs(v))
     throw ValueError("invalid nuclide in CompMap");
 
@@ -26,7 +35,7 @@ Composition::Ptr Composition::CreateFromAtom(CompMap v) {
   return c;
 }
 
-Composition::Ptr Composition::CreateFromMass(CompMap v) {
+Composition::Ptr Composition::CreateFromMass(const NucVec& v) {
   if (!compmath::ValidNucs(v))
     throw ValueError("invalid nuclide in CompMap");
 
@@ -43,123 +52,291 @@ int Composition::id() {
 }
 
 const CompMap& Composition::atom() {
-  if (atom_.size() == 0) {
-    CompMap::iterator it;
-    for (it = mass_.begin(); it != mass_.end(); ++it) {
-      Nuc nuc = it->first;
-      atom_[nuc] = it->second / pyne::atomic_mass(nuc);
+  if (!atom_map_ready_.load(std::memory_order_acquire)) {
+    CompMap m = atom_vec().ToMap();
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!atom_map_ready_.load(std::memory_order_relaxed)) {
+      atom_map_ = m;
+      atom_map_ready_.store(true, std::memory_order_release);
     }
   }
-  return atom_;
+  return atom_map_;
 }
 
 const CompMap& Composition::mass() {
-  if (mass_.size() == 0) {
-    CompMap::iterator it;
-    for (it = atom_.begin(); it != atom_.end(); ++it) {
-      Nuc nuc = it->first;
-      mass_[nuc] = it->second * pyne::atomic_mass(nuc);
+  if (!mass_map_ready_.load(std::memory_order_acquire)) {
+    CompMap m = mass_vec().ToMap();
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!mass_map_ready_.load(std::memory_order_relaxed)) {
+      mass_map_ = m;
+      mass_map_ready_.store(true, std::memory_order_release);
+    }
+  }
+  return mass_map_;
+}
+
+const NucVec& Composition::atom_vec() {
+  if (!atom_ready_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (atom_.empty() && !mass_.empty()) {
+      NucVec v(mass_);
+      const std::vector<Nuc>& nucs = v.nucs();
+      std::vector<double>& vals = v.vals();
+      for (int k = 0; k < nucs.size(); ++k) {
+        vals[k] /= pyne::atomic_mass(nucs[k]);
+      }
+      atom_ = v;
     }
+    atom_ready_.store(true, std::memory_order_release);
+  }
+  return atom_;
+}
+
+const NucVec& Composition::mass_vec() {
+  if (!mass_ready_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (mass_.empty() && !atom_.empty()) {
+      NucVec v(atom_);
+      const std::vector<Nuc>& nucs = v.nucs();
+      std::vector<double>& vals = v.vals();
+      for (int k = 0; k < nucs.size(); ++k) {
+        vals[k] *= pyne::atomic_mass(nucs[k]);
+      }
+      mass_ = v;
+    }
+    mass_ready_.store(true, std::memory_order_release);
   }
   return mass_;
 }
 
-Composition::Ptr Composition::Decay(int delta, uint64_t secs_per_timestep) {
+double Composition::max_decay_const() {
+  double c = max_decay_const_.load(std::memory_order_relaxed);
+  if (c < 0) {
+    // racing threads calculate the same value
+    c = atom_vec().MaxDecayConst();
+    max_decay_const_.store(c, std::memory_order_relaxed);
+  }
+  return c;
+}
+
+Composition::Ptr Composition::Decay(int delta, uint64_t secs_per_timestep,
+                                    DecayOperators* ops) {
   int tot_decay = prev_decay_ + delta;
-  if (decay_line_->count(tot_decay) == 1) {
-    // decay_line_ has cached, pre-computed result of this decay
-    return (*decay_line_)[tot_decay];
+  {
+    std::lock_guard<std::mutex> lk(*decay_mtx_);
+    Chain::iterator it = decay_line_->find(tot_decay);
+    if (it != decay_line_->end()) {
+      // decay_line_ has cached, pre-computed result of this decay
+      return it->second;
+    }
+  }
+
+  // The decay chain may be shared with materials of other concurrently
+  // running tasks, so new decays are calculated in task order (see IdBlocks)
+  // and the decayed composition gets the same id on any number of threads.
+  IdBlocks::WaitTurn();
+  std::lock_guard<std::mutex> lk(*decay_mtx_);
+  Chain::iterator it = decay_line_->find(tot_decay);
+  if (it != decay_line_->end()) {
+    return it->second;
   }
 
   // Calculate a new decayed composition and insert it into the decay chain.
   // It will automagically appear in the decay chain for all other compositions
   // that are a part of this decay chain because decay_line_ is a pointer that
   // all compositions in the chain share.
-  Composition::Ptr decayed = NewDecay(delta, secs_per_timestep);
+  DecayBatch batch(static_cast<double>(secs_per_timestep) * delta, ops);
+  Composition::Ptr decayed = NewDecay(delta, &batch);
   (*decay_line_)[tot_decay] = decayed;
   return decayed;
 }
 
+std::vector<Composition::Ptr> Composition::DecayAll(
+    const std::vector<Ptr>& comps, int delta, uint64_t secs_per_timestep,
+    DecayOperators* ops) {
+  std::vector<Ptr> decayed(comps.size());
+  if (!FindDecays(comps, delta, &decayed)) {
+    return decayed;
+  }
+
+  // as in Decay, new decays are calculated in task order
+  IdBlocks::WaitTurn();
+  std::vector<int> pending;
+  std::set<std::pair<Chain*, int> > seen;
+  for (int i = 0; i < comps.size(); ++i) {
+    Composition* c = comps[i].get();
+    if (decayed[i] == NULL &&
+        seen.insert(std::make_pair(c->decay_line_.get(),
+                                   c->prev_decay_ + delta)).second) {
+      pending.push_back(i);
+    }
+  }
+
+  DecayBatch batch(static_cast<double>(secs_per_timestep) * delta, ops);
+  for (int k = 0; k < pending.size(); ++k) {
+    Composition* c = comps[pending[k]].get();
+    int tot_decay = c->prev_decay_ + delta;
+    std::lock_guard<std::mutex> lk(*c->decay_mtx_);
+    if (c->decay_line_->count(tot_decay) == 0) {
+      (*c->decay_line_)[tot_decay] = c->NewDecay(delta, &batch);
+    }
+  }
+
+  // compositions sharing a pending decay pick it up from their decay line
+  FindDecays(comps, delta, &decayed);
+  return decayed;
+}
+
+bool Composition::FindDecays(const std::vector<Ptr>& comps, int delta,
+                             std::vector<Ptr>* decayed) {
+  bool missing = false;
+  for (int i = 0; i < comps.size(); ++i) {
+    if ((*decayed)[i] != NULL) {
+      continue;
+    }
+    Composition* c = comps[i].get();
+    std::lock_guard<std::mutex> lk(*c->decay_mtx_);
+    Chain::iterator it = c->decay_line_->find(c->prev_decay_ + delta);
+    if (it != c->decay_line_->end()) {
+      (*decayed)[i] = it->second;
+    } else {
+      missing = true;
+    }
+  }
+  return missing;
+}
+
 Composition::Ptr Composition::Decay(int delta) {
   return Decay(delta, kDefaultTimeStepDur);
 }
 
 void Composition::Record(Context* ctx) {
-  if (recorded_) {
+  if (recorded_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // a composition shared by concurrently running tasks is recorded by the
+  // first of them in task order
+  IdBlocks::WaitTurn();
+  if (recorded_.exchange(true)) {
     return;
   }
-  recorded_ = true;
 
-  CompMap::const_iterator it;
-  CompMap cm = mass();  // force lazy evaluation now
-  compmath::Normalize(&cm, 1);
-  for (it = cm.begin(); it != cm.end(); ++it) {
+  NucVec v = mass_vec();  // force lazy evaluation now
+  compmath::Normalize(&v, 1);
+  for (int k = 0; k < v.size(); ++k) {
     ctx->NewDatum("Compositions")
         ->AddVal("QualId", id())
-        ->AddVal("NucId", it->first)
-        ->AddVal("MassFrac", it->second)
+        ->AddVal("NucId", v.nucs()[k])
+        ->AddVal("MassFrac", v.vals()[k])
         ->Record();
   }
 }
 
-Composition::Composition() : prev_decay_(0), recorded_(false) {
-  id_ = next_id_;
-  next_id_++;
+Composition::Composition()
+    : recorded_(false),
+      prev_decay_(0),
+      max_decay_const_(-1),
+      atom_ready_(false),
+      mass_ready_(false),
+      atom_map_ready_(false),
+      mass_map_ready_(false) {
+  id_ = next_id_++;
   decay_line_ = ChainPtr(new Chain());
+  decay_mtx_ = boost::shared_ptr<std::mutex>(new std::mutex());
 }
 
-Composition::Composition(int prev_decay, ChainPtr decay_line)
-    : recorded_(false),
+Composition::Composition(int prev_decay, ChainPtr decay_line,
+                         boost::shared_ptr<std::mutex> decay_mtx)
+    : decay_line_(decay_line),
+      recorded_(false),
       prev_decay_(prev_decay),
-      decay_line_(decay_line) {
-  id_ = next_id_;
-  next_id_++;
+      max_decay_const_(-1),
+      decay_mtx_(decay_mtx),
+      atom_ready_(false),
+      mass_ready_(false),
+      atom_map_ready_(false),
+      mass_map_ready_(false) {
+  id_ = next_id_++;
 }
 
-Composition::Ptr Composition::NewDecay(int delta, uint64_t secs_per_timestep) {
+Composition::Ptr Composition::NewDecay(int delta, DecayBatch* batch) {
   int tot_decay = prev_decay_ + delta;
-  atom();  // force evaluation of atom-composition if not calculated already
+  atom_vec();  // force evaluation of atom-composition if not calculated already
 
   // the new composition is a part of this decay chain and so is created with a
   // pointer to the exact same decay_line_.
-  Composition::Ptr decayed(new Composition(tot_decay, decay_line_));
+  Composition::Ptr decayed(
+      new Composition(tot_decay, decay_line_, decay_mtx_));
 
   // FIXME this is only here for testing, see issue #761
   if (atom_.size() == 0)
     return decayed;
 
-  // Get intial condition vector
-  std::vector<double> n0 (pyne_cram_transmute_info.n, 0.0);
-  CompMap::const_iterator it;
-  int i = -1;
-  for (it = atom_.begin(); it != atom_.end(); ++it) {
-    i = pyne_cram_transmute_nucid_to_i(it->first);
-    if (i < 0) {
-      continue;
+  decayed->atom_ = batch->Decay(atom_);
+  return decayed;
+}
+
+CompositionTable::CompositionTable(double tol) : tol_(tol) {
+  if (tol_ <= 0) {
+    throw ValueError("composition table tolerance must be positive");
+  }
+}
+
+Composition::Ptr CompositionTable::Intern(Composition::Ptr c) {
+  NucVec v = c->mass_vec();
+  compmath::Normalize(&v, 1);
+  long long b = Bucket(v);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  typedef std::unordered_multimap<std::size_t, Entry>::iterator Iter;
+  for (long long nb = b - 1; nb <= b + 1; ++nb) {
+    std::pair<Iter, Iter> range = table_.equal_range(Hash(v, nb));
+    for (Iter it = range.first; it != range.second; ++it) {
+      if (Near(it->second.first, v)) {
+        return it->second.second;
+      }
     }
-    n0[i] = it->second;
   }
+  table_.insert(std::make_pair(Hash(v, b), Entry(v, c)));
+  return c;
+}
+
+int CompositionTable::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return table_.size();
+}
 
-  // get decay matrix
-  double t = static_cast<double>(secs_per_timestep) * delta;
-  std::vector<double> decay_matrix (pyne_cram_transmute_info.nnz);
-  for (i=0; i < pyne_cram_transmute_info.nnz; ++i) {
-    decay_matrix[i] = -pyne_cram_transmute_info.decay_matrix[i] * t;
+long long CompositionTable::Bucket(const NucVec& v) const {
+  // the weights are at most 1 and sum to (n + 1) / 2, so the sums of two
+  // compositions within tol_ differ by less than the bucket width
+  int n = v.size();
+  double sum = 0;
+  for (int i = 0; i < n; ++i) {
+    sum += v.vals()[i] * (i + 1) / n;
   }
+  return std::floor(sum / (tol_ * (n + 1)));
+}
 
-  // perform decay
-  std::vector<double> n1 (pyne_cram_transmute_info.n);
-  pyne_cram_expm_multiply14(decay_matrix.data(), n0.data(), n1.data());
+std::size_t CompositionTable::Hash(const NucVec& v, long long bucket) const {
+  std::hash<long long> hasher;
+  std::size_t h = hasher(bucket);
+  for (int i = 0; i < v.size(); ++i) {
+    h ^= hasher(v.nucs()[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  }
+  return h;
+}
 
-  // convert back to map
-  CompMap cm;
-  for (i=0; i < pyne_cram_transmute_info.n; ++i) {
-    if (n1[i] > 0.0) {
-      cm[(pyne_cram_transmute_info.nucids)[i]] = n1[i];
+bool CompositionTable::Near(const NucVec& v1, const NucVec& v2) const {
+  if (!v1.SameNucs(v2)) {
+    return false;
+  }
+  for (int i = 0; i < v1.size(); ++i) {
+    if (std::abs(v1.vals()[i] - v2.vals()[i]) > tol_) {
+      return false;
     }
   }
-  decayed->atom_ = cm;
-  return decayed;
+  return true;
 }
 
 }  // namespace cyclus
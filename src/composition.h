@@ -1,20 +1,26 @@
 #ifndef CYCLUS_SRC_COMPOSITION_H_
 #define CYCLUS_SRC_COMPOSITION_H_
 
+#include <atomic>
+#include <cstddef>
 #include <map>
+#include <mutex>
 #include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
+#include "id_seq.h"
+#include "nuc_vec.h"
+
 class SimInitTest;
 
 namespace cyclus {
 
 class Context;
-
-typedef int Nuc;
-
-/// a raw definition of nuclides and corresponding (dimensionless quantities).
-typedef std::map<Nuc, double> CompMap;
+class DecayBatch;
+class DecayOperators;
 
 /// An immutable object responsible for holding a nuclide composition. It tracks
 /// decay lineages to prevent duplicate calculations and output recording and is
@@ -35,6 +41,15 @@ typedef std::map<Nuc, double> CompMap;
 /// Composition c = Composition::CreateFromAtom(v);
 /// @endcode
 ///
+/// Internally, compositions store their quantities as NucVecs, which is what
+/// the resource and decay code work with. The CompMaps returned by atom()
+/// and mass() are built from them the first time they are asked for.
+///
+/// A composition and its decay chain may be used from several threads at
+/// once, e.g. by re-entrant traders reading lazily decayed materials while
+/// bids are collected. Lazily calculated members and decay chains are
+/// guarded, and new decays and records are made in task order (see
+/// IdBlocks::WaitTurn).
 class Composition {
   friend class SimInit;
   friend class ::SimInitTest;
@@ -52,6 +67,12 @@ class Composition {
   /// value.
   static Ptr CreateFromMass(CompMap v);
 
+  /// Same as CreateFromAtom(CompMap), but without converting from a CompMap.
+  static Ptr CreateFromAtom(const NucVec& v);
+
+  /// Same as CreateFromMass(CompMap), but without converting from a CompMap.
+  static Ptr CreateFromMass(const NucVec& v);
+
   /// Returns a unique id associated with this composition.  Note that multiple
   /// material objects can share the same composition. Also Note that the id is
   /// not the same for two compositions that were separately created from the
@@ -64,6 +85,17 @@ class Composition {
   /// Returns the unnormalized mass composition.
   const CompMap& mass();
 
+  /// Returns the unnormalized atom composition as a NucVec.
+  const NucVec& atom_vec();
+
+  /// Returns the unnormalized mass composition as a NucVec.
+  const NucVec& mass_vec();
+
+  /// Returns the largest decay constant (in 1/s) of the nuclides in this
+  /// composition. It is calculated once and cached, so that deciding whether
+  /// a composition needs decaying does not look up every nuclide each time.
+  double max_decay_const();
+
   /// Returns a decayed version of this composition (decayed delta timesteps)
   /// assuming a time step is 1/12 of one year in duration. This composition
   /// remains unchanged.
@@ -71,7 +103,18 @@ class Composition {
 
   /// Returns a decayed version of this composition (decayed
   /// delta timesteps) using the seconds to timestep conversion specified.
-  Ptr Decay(int delta, uint64_t secs_per_timestep);
+  /// If ops is given and its timestep matches, the decay is calculated with
+  /// its cached transfer operators rather than a CRAM solve.
+  Ptr Decay(int delta, uint64_t secs_per_timestep, DecayOperators* ops = NULL);
+
+  /// Returns decayed versions of all of comps (decayed delta timesteps using
+  /// the seconds to timestep conversion specified), in the same order. This
+  /// gives the same results as calling Decay on each composition, but every
+  /// decay that has not been calculated before is calculated together in a
+  /// single DecayBatch.
+  static std::vector<Ptr> DecayAll(const std::vector<Ptr>& comps, int delta,
+                                   uint64_t secs_per_timestep,
+                                   DecayOperators* ops = NULL);
 
   /// Records the composition in output database Compositions table (if
   /// not done previously).
@@ -92,19 +135,93 @@ class Composition {
  private:
   /// This constructor allows the creation of decayed versions of
   /// compositions while avoiding extra memory allocations.
-  Composition(int prev_decay, ChainPtr decay_line);
+  Composition(int prev_decay, ChainPtr decay_line,
+              boost::shared_ptr<std::mutex> decay_mtx);
 
   /// Performs a decay calculation and creates a new decayed composition.
-  Ptr NewDecay(int delta, uint64_t secs_per_timestep);
-
-  static int next_id_;
+  /// The caller must hold decay_mtx_.
+  Ptr NewDecay(int delta, DecayBatch* batch);
+
+  /// Fills the empty entries of decayed with the compositions of comps
+  /// decayed by delta that are already in their decay chains. Returns true if
+  /// any are still missing.
+  static bool FindDecays(const std::vector<Ptr>& comps, int delta,
+                         std::vector<Ptr>* decayed);
+
+  // compositions may be created concurrently by thread safe time listeners
+  // and re-entrant traders, see IdSeq
+  static IdSeq next_id_;
   int id_;
-  bool recorded_;
-  CompMap atom_;
-  CompMap mass_;
+  std::atomic<bool> recorded_;
+  NucVec atom_;
+  NucVec mass_;
+
+  // CompMap views of atom_ and mass_, built on demand
+  CompMap atom_map_;
+  CompMap mass_map_;
 
   /// the total time delta this composition has been decayed from its root ancestor.
   int prev_decay_;
+
+  // the value of max_decay_const, or negative if not calculated yet
+  std::atomic<double> max_decay_const_;
+
+  // guards decay_line_, shared by every composition in the chain
+  boost::shared_ptr<std::mutex> decay_mtx_;
+
+  // guards the lazy calculation of atom_, mass_ and their CompMap views,
+  // which are only read without it once the matching flag is set
+  std::mutex mtx_;
+  std::atomic<bool> atom_ready_;
+  std::atomic<bool> mass_ready_;
+  std::atomic<bool> atom_map_ready_;
+  std::atomic<bool> mass_map_ready_;
+};
+
+/// A CompositionTable interns compositions: every composition passed to
+/// Intern whose normalized mass fractions match (within an absolute
+/// tolerance) those of a composition already in the table is replaced by that
+/// composition. Interned compositions are recorded to output once, under a
+/// single QualId, and share a single decay line.
+///
+/// Candidates are hashed by their nuclides and a weighted sum of their
+/// fractions rounded down to a bucket wide enough that compositions within
+/// the tolerance fall in the same or an adjacent bucket; Intern probes all
+/// three, so matches are never missed on a bucket boundary. The table keeps
+/// every composition added to it alive for its own lifetime.
+class CompositionTable {
+ public:
+  /// @param tol the absolute tolerance within which normalized mass fractions
+  /// are considered equal
+  explicit CompositionTable(double tol = 1e-9);
+
+  /// Returns the composition in the table with the same mass fractions as c,
+  /// first adding c to the table if there is none.
+  Composition::Ptr Intern(Composition::Ptr c);
+
+  /// Returns the number of distinct compositions in the table.
+  int size();
+
+ private:
+  typedef std::pair<NucVec, Composition::Ptr> Entry;
+
+  // returns the bucket of the normalized fractions v
+  long long Bucket(const NucVec& v) const;
+
+  std::size_t Hash(const NucVec& v, long long bucket) const;
+
+  // returns true if v1 and v2 have the same nuclides and every fraction is
+  // within tol_ of the other's
+  bool Near(const NucVec& v1, const NucVec& v2) const;
+
+  double tol_;
+
+  // guards table_ because materials may be modified while bids are being
+  // collected on several threads
+  std::mutex mutex_;
+
+  // (normalized mass fractions, composition) entries keyed by Hash
+  std::unordered_multimap<std::size_t, Entry> table_;
 };
 
 }  // namespace cyclus
@@ -3,6 +3,7 @@
 #include <vector>
 #include <boost/uuid/uuid_generators.hpp>
 
+#include "decay_operators.h"
 #include "error.h"
 #include "exchange_solver.h"
 #include "logger.h"
@@ -26,6 +27,15 @@ SimInfo::SimInfo()
       branch_time(-1),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_delta(false),
+      threads(1),
+      phase_timings(false),
+      fast_forward(false),
+      incremental_exchange(false),
+      parallel_exchange(false),
+      intern_compositions(false),
+      decay_operator_mb(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -41,6 +51,15 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_delta(false),
+      threads(1),
+      phase_timings(false),
+      fast_forward(false),
+      incremental_exchange(false),
+      parallel_exchange(false),
+      intern_compositions(false),
+      decay_operator_mb(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -56,6 +75,15 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle, std::string d)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_delta(false),
+      threads(1),
+      phase_timings(false),
+      fast_forward(false),
+      incremental_exchange(false),
+      parallel_exchange(false),
+      intern_compositions(false),
+      decay_operator_mb(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init"),
       seed(kDefaultSeed),
@@ -74,6 +102,15 @@ SimInfo::SimInfo(int dur, boost::uuids::uuid parent_sim,
       branch_time(branch_time),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_interval(1),
+      explicit_inventory_delta(false),
+      threads(1),
+      phase_timings(false),
+      fast_forward(false),
+      incremental_exchange(false),
+      parallel_exchange(false),
+      intern_compositions(false),
+      decay_operator_mb(0),
       handle(handle),
       seed(kDefaultSeed),
       stride(kDefaultStride) {}
@@ -83,7 +120,8 @@ Context::Context(Timer* ti, Recorder* rec)
       rec_(rec),
       solver_(NULL),
       trans_id_(0),
-      si_(0) {
+      si_(0),
+      decay_ops_(NULL) {
         rng_ = new RandomNumberGenerator();
       }
 
@@ -94,6 +132,9 @@ Context::~Context() {
   if (rng_ != NULL) {
     delete rng_;
   }
+  if (decay_ops_ != NULL) {
+    delete decay_ops_;
+  }
   // initiate deletion of agents that don't have parents.
   // dealloc will propagate through hierarchy as agents delete their children
   std::vector<Agent*> to_del;
@@ -143,6 +184,22 @@ void Context::SchedDecom(Agent* m, int t) {
       ->Record();
 }
 
+bool Context::CancelDecom(Agent* m) {
+  if (!ti_->CancelDecom(m)) {
+    return false;
+  }
+  NewDatum("DecomSchedule")
+      ->AddVal("AgentId", m->id())
+      ->AddVal("SchedTime", time())
+      ->AddVal("DecomTime", -1)
+      ->Record();
+  return true;
+}
+
+int Context::DecomTime(Agent* m) {
+  return ti_->DecomTime(m);
+}
+
 boost::uuids::uuid Context::sim_id() {
   return rec_->sim_id();
 }
@@ -191,6 +248,13 @@ Composition::Ptr Context::GetRecipe(std::string name) {
   return recipes_[name];
 }
 
+Composition::Ptr Context::InternComp(Composition::Ptr c) {
+  if (!si_.intern_compositions) {
+    return c;
+  }
+  return comps_.Intern(c);
+}
+
 void Context::AddPackage(std::string name, double fill_min, double fill_max,
                          std::string strategy) {
   if (packages_.count(name) == 0) {
@@ -287,6 +351,33 @@ void Context::InitSim(SimInfo si) {
   NewDatum("InfoExplicitInv")
       ->AddVal("RecordInventory", si.explicit_inventory)
       ->AddVal("RecordInventoryCompact", si.explicit_inventory_compact)
+      ->AddVal("RecordInventoryInterval", si.explicit_inventory_interval)
+      ->AddVal("RecordInventoryDelta", si.explicit_inventory_delta)
+      ->Record();
+
+  NewDatum("InfoPhaseTimings")
+      ->AddVal("RecordPhaseTimings", si.phase_timings)
+      ->Record();
+
+  NewDatum("InfoFastForward")
+      ->AddVal("FastForward", si.fast_forward)
+      ->Record();
+
+  NewDatum("InfoThreads")
+      ->AddVal("Threads", si.threads)
+      ->Record();
+
+  NewDatum("InfoExchange")
+      ->AddVal("IncrementalExchange", si.incremental_exchange)
+      ->AddVal("ParallelExchange", si.parallel_exchange)
+      ->Record();
+
+  NewDatum("InfoInternCompositions")
+      ->AddVal("InternCompositions", si.intern_compositions)
+      ->Record();
+
+  NewDatum("InfoDecayOperators")
+      ->AddVal("MemoryMB", si.decay_operator_mb)
       ->Record();
 
   // TODO: when the backends get uint64_t support, the static_cast here should
@@ -305,6 +396,11 @@ void Context::InitSim(SimInfo si) {
       ->Record();
 
   si_ = si;
+  delete decay_ops_;
+  decay_ops_ = NULL;
+  if (si.decay_operator_mb > 0) {
+    decay_ops_ = new DecayOperators(si.dt, si.decay_operator_mb);
+  }
   ti_->Initialize(this, si);
   rng_->Initialize(si);
 
@@ -314,6 +410,10 @@ int Context::time() {
   return ti_->time();
 }
 
+PhaseTimings* Context::phase_timings() {
+  return ti_->phase_timings();
+}
+
 int Context::random() {
   return rng_->random();
 }
@@ -340,18 +440,57 @@ int Context::random_normal_int(double mean, double std_dev, int low,
   return rng_->random_normal_int(mean, std_dev, low, high);
 }
 
-void Context::RegisterTimeListener(TimeListener* tl) {
-  ti_->RegisterTimeListener(tl);
+void Context::UnregisterTrader(Trader* e) {
+  traders_.erase(e);
+  std::map<Trader*, std::set<std::string> >::iterator it =
+      bid_commods_.find(e);
+  if (it == bid_commods_.end()) {
+    return;
+  }
+  std::set<std::string>::iterator c;
+  for (c = it->second.begin(); c != it->second.end(); ++c) {
+    std::set<Trader*>& bidders = commod_bidders_[*c];
+    bidders.erase(e);
+    if (bidders.empty()) {
+      commod_bidders_.erase(*c);
+    }
+  }
+  bid_commods_.erase(it);
+}
+
+void Context::SubscribeBids(Trader* e, const std::string& commod) {
+  if (traders_.count(e) == 0) {
+    throw ValueError("cannot subscribe an unregistered trader to bid on " +
+                     commod);
+  }
+  bid_commods_[e].insert(commod);
+  commod_bidders_[commod].insert(e);
+}
+
+void Context::RegisterTimeListener(TimeListener* tl, int phases) {
+  ti_->RegisterTimeListener(tl, phases);
 }
 
 void Context::UnregisterTimeListener(TimeListener* tl) {
   ti_->UnregisterTimeListener(tl);
 }
 
+void Context::SchedWake(TimeListener* tl, int t) {
+  ti_->SchedWake(tl, t);
+}
+
 Datum* Context::NewDatum(std::string title) {
   return rec_->NewDatum(title);
 }
 
+void Context::MergeDatums(DatumBuffer* buf) {
+  rec_->Merge(buf);
+}
+
+ThreadPool* Context::thread_pool() {
+  return ti_->thread_pool();
+}
+
 void Context::Snapshot() {
   ti_->Snapshot();
 }
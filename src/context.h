@@ -31,15 +31,28 @@ class SimInitTest;
 namespace cyclus {
 
 class Datum;
+class DecayOperators;
 class ExchangeSolver;
 class Recorder;
 class Trader;
+class PhaseTimings;
 class Timer;
+class ThreadPool;
 class TimeListener;
 class SimInit;
 class DynamicModule;
 class RandomNumberGenerator;
 
+/// Bit flags for the per-timestep phases in which a TimeListener can be
+/// notified. Flags may be combined with bitwise or to subscribe a listener to
+/// several phases.
+enum TimePhase {
+  kTickPhase = 1,
+  kTockPhase = 2,
+  kDecisionPhase = 4,
+  kAllPhases = kTickPhase | kTockPhase | kDecisionPhase,
+};
+
 /// Container for a static simulation-global parameters that both describe
 /// the simulation and affect its behavior.
 class SimInfo {
@@ -121,6 +134,72 @@ class SimInfo {
   /// Composition-object and/or reference).
   bool explicit_inventory_compact;
 
+  /// Number of timesteps between explicit inventory records. Inventories are
+  /// recorded on timesteps that are a multiple of this interval.
+  int explicit_inventory_interval;
+
+  /// True if per-agent inventories should be recorded in the
+  /// ExplicitInventoryDelta table (same layout as ExplicitInventoryCompact)
+  /// only when they change. An inventory that is emptied, or whose agent is
+  /// decommissioned, gets a final row with zero quantity.
+  bool explicit_inventory_delta;
+
+  /// Number of threads used to run the Tick, Tock, and Decision phases of
+  /// time listeners whose archetype declares them thread safe (i.e. a
+  /// "threadsafe" class annotation). With more than one thread, resources
+  /// and compositions they create are numbered from per-listener id blocks
+  /// (see IdBlocks), so output is the same for any number of threads above
+  /// one, but ids may have gaps that a single threaded simulation does not
+  /// have. With one thread (the default) the annotation changes nothing. The
+  /// value is recorded in the InfoThreads table.
+  int threads;
+
+  /// True if the wall clock time spent in each timestep phase (and by each
+  /// prototype in the Tick, Tock, and Decision phases) should be recorded
+  /// every time step in the PhaseTimings table.
+  bool phase_timings;
+
+  /// True if the timer may skip over timesteps in which nothing can happen,
+  /// i.e. no time listeners are awake, no builds or decommissions are
+  /// scheduled, no requests were made in the previous resource exchange and
+  /// no trader without a listening manager expects to make any (see
+  /// Trader::NextRequestTime).
+  /// Skipped intervals are recorded in the FastForward table. Material decay
+  /// is unaffected because it is computed from elapsed time whenever a
+  /// material is next decayed. Fast forwarding is disabled while explicit
+  /// inventories are being recorded.
+  bool fast_forward;
+
+  /// True if a resource exchange whose translated graph is identical to the
+  /// previous one (of the same resource type) should reuse that exchange's
+  /// solution instead of calling the solver again. If the solver decomposes
+  /// graphs, each connected component that is identical to one of the
+  /// previous exchange is reused instead. Solvers are deterministic, so
+  /// output does not depend on this value and it is not recorded in the
+  /// output database.
+  bool incremental_exchange;
+
+  /// True if the requests and bids of traders whose archetype declares them
+  /// re-entrant (i.e. a "reentrant" class annotation) should be collected
+  /// concurrently, using the same worker threads as thread safe time
+  /// listeners. Portfolios are merged in the serial order, so the exchange
+  /// does not depend on this value and it is not recorded in the output
+  /// database. Resources created by those traders are numbered from
+  /// per-trader id blocks (see IdBlocks), so their ids may skip some values
+  /// when this is set, but do not depend on the number of threads.
+  bool parallel_exchange;
+
+  /// True if materials should intern the compositions they create when
+  /// absorbing or extracting material (see CompositionTable), so that equal
+  /// mixtures share one QualId and one decay line.
+  bool intern_compositions;
+
+  /// Memory budget in megabytes for the cached transfer operators used to
+  /// decay compositions over whole numbers of timesteps (see
+  /// DecayOperators). Zero disables the cache so that every decay is
+  /// calculated with a CRAM solve.
+  double decay_operator_mb;
+
   /// Seed for random number generator
   uint64_t seed;
 
@@ -177,16 +256,34 @@ class Context {
     traders_.insert(e);
   }
 
-  /// Unregisters an agent as a participant in resource exchanges.
-  inline void UnregisterTrader(Trader* e) {
-    traders_.erase(e);
-  }
+  /// Unregisters an agent as a participant in resource exchanges, along with
+  /// any bid subscriptions it has.
+  void UnregisterTrader(Trader* e);
 
   /// @return the current set of traders registered for resource exchange.
   inline const std::set<Trader*>& traders() const {
     return traders_;
   }
 
+  /// Subscribes a registered trader to bid on a commodity. A trader with any
+  /// subscriptions is only asked for bids in exchanges where at least one of
+  /// its commodities is requested; other traders are always asked.
+  /// Subscriptions last until the trader is unregistered.
+  ///
+  /// @throws ValueError if the trader is not registered
+  void SubscribeBids(Trader* e, const std::string& commod);
+
+  /// @return the commodities that each subscribed trader bids on
+  inline const std::map<Trader*, std::set<std::string> >& bid_commods() const {
+    return bid_commods_;
+  }
+
+  /// @return the subscribed traders that bid on each commodity
+  inline const std::map<std::string, std::set<Trader*> >& commod_bidders()
+      const {
+    return commod_bidders_;
+  }
+
   /// Create a new agent by cloning the named prototype. The returned agent is
   /// not initialized as a simulation participant.
   ///
@@ -230,6 +327,15 @@ class Context {
   /// next decommission phase (i.e. the end of the current timestep).
   void SchedDecom(Agent* m, int time = -1);
 
+  /// Cancels the given Agent's pending decommission, recording it to the
+  /// DecomSchedule table with a DecomTime of -1. Returns false if no
+  /// decommission was pending.
+  bool CancelDecom(Agent* m);
+
+  /// Returns the timestep at which the given Agent is scheduled to be
+  /// decommissioned, or -1 if none is pending.
+  int DecomTime(Agent* m);
+
   /// Adds a composition recipe to a simulation-wide accessible list.
   /// Agents should NOT add their own recipes.
   void AddRecipe(std::string name, Composition::Ptr c);
@@ -240,14 +346,28 @@ class Context {
   /// during the simulation.
   Composition::Ptr GetRecipe(std::string name);
 
+  /// Returns the simulation-wide interned equivalent of c if composition
+  /// interning is enabled (see SimInfo::intern_compositions) and c otherwise.
+  Composition::Ptr InternComp(Composition::Ptr c);
+
   /// Registers an agent to receive tick/tock notifications every timestep.
-  /// Agents should register from their Deploy method.
-  void RegisterTimeListener(TimeListener* tl);
+  /// Agents should register from their Deploy method. Agents that only need
+  /// some of the phases can pass a combination of TimePhase flags to avoid
+  /// being notified of the others.
+  void RegisterTimeListener(TimeListener* tl, int phases = kAllPhases);
 
   /// Removes an agent from receiving tick/tock notifications.
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Puts a registered time listener to sleep until timestep t. After the
+  /// current timestep, the listener receives no notifications until time t,
+  /// when it is woken up and notified every timestep as usual. A later call
+  /// replaces any earlier wake up time, so calling this with the next
+  /// timestep wakes a sleeping listener early. Sleep state is not saved in
+  /// simulation snapshots.
+  void SchedWake(TimeListener* tl, int t);
+
   /// Initializes the simulation time parameters. Should only be called once -
   /// NOT idempotent.
   void InitSim(SimInfo si);
@@ -255,6 +375,10 @@ class Context {
   /// Returns the current simulation timestep.
   virtual int time();
 
+  /// Returns the accumulator for per-phase wall clock timings, or NULL if
+  /// phase timings are not being recorded for this simulation.
+  PhaseTimings* phase_timings();
+
   /// Adds a package type to a simulation-wide accessible list.
   /// Agents should NOT add their own packages.
   void AddPackage(std::string name, double fill_min = 0,
@@ -303,6 +427,10 @@ class Context {
   /// Returns the duration of a single time step in seconds.
   inline uint64_t dt() {return si_.dt;};
 
+  /// Returns the simulation's cached decay operators, or NULL if they are
+  /// disabled (see SimInfo::decay_operator_mb).
+  inline DecayOperators* decay_ops() {return decay_ops_;};
+
   /// Returns the seed for the random number generator.
   inline uint64_t seed() {return si_.seed;};
 
@@ -317,6 +445,14 @@ class Context {
   /// See Recorder::NewDatum documentation.
   Datum* NewDatum(std::string title);
 
+  /// See Recorder::Merge documentation.
+  void MergeDatums(DatumBuffer* buf);
+
+  /// Returns the worker pool shared by kernel phases that run agent code
+  /// concurrently, or NULL if the simulation is configured with a single
+  /// thread.
+  ThreadPool* thread_pool();
+
   /// Schedules a snapshot of simulation state to output database to occur at
   /// the beginning of the next timestep.
   void Snapshot();
@@ -374,10 +510,13 @@ class Context {
 
   std::map<std::string, Agent*> protos_;
   std::map<std::string, Composition::Ptr> recipes_;
+  CompositionTable comps_;
   std::map<std::string, Package::Ptr> packages_;
   std::map<std::string, TransportUnit::Ptr> transport_units_;
   std::set<Agent*> agent_list_;
   std::set<Trader*> traders_;
+  std::map<Trader*, std::set<std::string> > bid_commods_;
+  std::map<std::string, std::set<Trader*> > commod_bidders_;
   std::map<std::string, int> n_prototypes_;
   std::map<std::string, int> n_specs_;
 
@@ -387,6 +526,7 @@ class Context {
   Recorder* rec_;
   int trans_id_;
   RandomNumberGenerator* rng_;
+  DecayOperators* decay_ops_;
 };
 
 }  // namespace cyclus
@@ -0,0 +1,47 @@
+#include "decay_batch.h"
+
+#include <algorithm>
+
+#include "decay_operators.h"
+
+extern "C" {
+#include "cram.hpp"
+}
+
+namespace cyclus {
+
+DecayBatch::DecayBatch(double secs, DecayOperators* ops)
+    : ops_(ops),
+      steps_(ops == NULL ? 0 : ops->Steps(secs)),
+      n0_(pyne_cram_transmute_info.n),
+      n1_(pyne_cram_transmute_info.n) {
+  if (steps_ > 0) {
+    return;
+  }
+  matrix_.resize(pyne_cram_transmute_info.nnz);
+  for (int i = 0; i < matrix_.size(); ++i) {
+    matrix_[i] = -pyne_cram_transmute_info.decay_matrix[i] * secs;
+  }
+}
+
+NucVec DecayBatch::Decay(const NucVec& n0) {
+  std::fill(n0_.begin(), n0_.end(), 0.0);
+  n0.ScatterDense(n0_.data());
+  if (steps_ > 0) {
+    ops_->Decay(steps_, &n0_);
+    return NucVec::FromDense(n0_.data());
+  }
+  pyne_cram_expm_multiply14(matrix_.data(), n0_.data(), n1_.data());
+  return NucVec::FromDense(n1_.data());
+}
+
+std::vector<NucVec> DecayBatch::Decay(const std::vector<const NucVec*>& n0s) {
+  std::vector<NucVec> n1s;
+  n1s.reserve(n0s.size());
+  for (int i = 0; i < n0s.size(); ++i) {
+    n1s.push_back(Decay(*n0s[i]));
+  }
+  return n1s;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,50 @@
+#ifndef CYCLUS_SRC_DECAY_BATCH_H_
+#define CYCLUS_SRC_DECAY_BATCH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "nuc_vec.h"
+
+namespace cyclus {
+
+class DecayOperators;
+
+/// A DecayBatch decays any number of atom vectors over the same time interval
+/// with the CRAM solver. The decay matrix is scaled by the interval once and
+/// the solver's dense work vectors are shared by every vector decayed, so
+/// decaying n vectors together costs n solves rather than n solves plus n
+/// matrix copies and allocations.
+///
+/// The solver only accepts one right-hand side at a time, so each vector is
+/// still solved separately and gives exactly the same result as it would
+/// alone.
+///
+/// If the interval is a whole number of timesteps of the given operator
+/// cache, vectors are decayed with its cached transfer operators instead of
+/// the solver.
+class DecayBatch {
+ public:
+  /// @param secs the decay interval in seconds
+  /// @param ops cached decay operators to use if the interval is on their
+  /// timestep grid, or NULL to always use the solver
+  explicit DecayBatch(double secs, DecayOperators* ops = NULL);
+
+  /// Returns the atom vector n0 decayed over the interval. Nuclides unknown
+  /// to the solver are dropped.
+  NucVec Decay(const NucVec& n0);
+
+  /// Returns every atom vector of n0s decayed over the interval, in order.
+  std::vector<NucVec> Decay(const std::vector<const NucVec*>& n0s);
+
+ private:
+  DecayOperators* ops_;
+  int steps_;
+  std::vector<double> matrix_;
+  std::vector<double> n0_;
+  std::vector<double> n1_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_DECAY_BATCH_H_
@@ -0,0 +1,122 @@
+#include "decay_operators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "error.h"
+
+extern "C" {
+#include "cram.hpp"
+}
+
+namespace cyclus {
+
+DecayOperators::DecayOperators(uint64_t dt, double budget_mb)
+    : dt_(dt),
+      bytes_(0),
+      full_(false),
+      unit_(pyne_cram_transmute_info.n),
+      solved_(pyne_cram_transmute_info.n),
+      tmp_(pyne_cram_transmute_info.n) {
+  if (dt == 0) {
+    throw ValueError("decay operators need a positive timestep duration");
+  } else if (budget_mb < 0) {
+    throw ValueError("decay operator memory budget cannot be negative");
+  }
+  budget_ = static_cast<std::size_t>(budget_mb * 1024 * 1024);
+}
+
+int DecayOperators::Steps(double secs) const {
+  double dt = static_cast<double>(dt_);
+  double k = std::floor(secs / dt + 0.5);
+  if (k < 1 || k > std::numeric_limits<int>::max() || k * dt != secs) {
+    return 0;
+  }
+  return static_cast<int>(k);
+}
+
+void DecayOperators::Decay(int k, std::vector<double>* x) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int p = 0; k > 0; ++p, k >>= 1) {
+    if ((k & 1) != 0) {
+      Apply(p, x, &tmp_);
+      x->swap(tmp_);
+    }
+  }
+}
+
+DecayOperators::Operator& DecayOperators::Op(int p) {
+  if (ops_.size() <= p) {
+    ops_.resize(p + 1);
+  }
+  Operator& op = ops_[p];
+  if (op.matrix.empty()) {
+    int n = pyne_cram_transmute_info.n;
+    int nnz = pyne_cram_transmute_info.nnz;
+    double secs = std::ldexp(static_cast<double>(dt_), p);
+    op.matrix.resize(nnz);
+    for (int i = 0; i < nnz; ++i) {
+      op.matrix[i] = -pyne_cram_transmute_info.decay_matrix[i] * secs;
+    }
+    op.cols.assign(n, -1);
+    bytes_ += nnz * sizeof(double) + n * sizeof(int);
+  }
+  return op;
+}
+
+bool DecayOperators::BuildColumns(int p, const std::vector<double>& x) {
+  Operator& op = Op(p);
+  for (int j = 0; j < x.size(); ++j) {
+    if (x[j] == 0 || op.cols[j] >= 0) {
+      continue;
+    } else if (full_) {
+      return false;
+    }
+
+    std::fill(unit_.begin(), unit_.end(), 0.0);
+    unit_[j] = 1;
+    pyne_cram_expm_multiply14(op.matrix.data(), unit_.data(), solved_.data());
+    Column c;
+    for (int i = 0; i < solved_.size(); ++i) {
+      if (solved_[i] != 0) {
+        c.rows.push_back(i);
+        c.vals.push_back(solved_[i]);
+      }
+    }
+
+    std::size_t b =
+        sizeof(Column) + c.rows.size() * (sizeof(int) + sizeof(double));
+    if (bytes_ + b > budget_) {
+      full_ = true;
+      return false;
+    }
+    bytes_ += b;
+    op.cols[j] = op.columns.size();
+    op.columns.push_back(c);
+  }
+  return true;
+}
+
+void DecayOperators::Apply(int p, std::vector<double>* x,
+                           std::vector<double>* y) {
+  Operator& op = Op(p);
+  if (!BuildColumns(p, *x)) {
+    pyne_cram_expm_multiply14(op.matrix.data(), x->data(), y->data());
+    return;
+  }
+
+  std::fill(y->begin(), y->end(), 0.0);
+  for (int j = 0; j < x->size(); ++j) {
+    double xj = (*x)[j];
+    if (xj == 0) {
+      continue;
+    }
+    const Column& c = op.columns[op.cols[j]];
+    for (int r = 0; r < c.rows.size(); ++r) {
+      (*y)[c.rows[r]] += xj * c.vals[r];
+    }
+  }
+}
+
+}  // namespace cyclus
@@ -0,0 +1,85 @@
+#ifndef CYCLUS_SRC_DECAY_OPERATORS_H_
+#define CYCLUS_SRC_DECAY_OPERATORS_H_
+
+#include <cstddef>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace cyclus {
+
+/// DecayOperators caches the transfer operators that decay an atom vector
+/// over 1, 2, 4, 8, ... timesteps, so that a decay over a whole number of
+/// timesteps becomes a short chain of sparse matrix-vector products (one per
+/// set bit of the number of timesteps) instead of a CRAM solve.
+///
+/// Operators are built one column at a time, by decaying the unit vector of
+/// a nuclide with CRAM the first time a vector holding that nuclide is
+/// decayed, so only the columns of nuclides that occur in the simulation are
+/// ever built. Once the cached columns and scaled decay matrices reach the
+/// memory budget no more are built, and steps that need a missing column are
+/// solved with CRAM instead.
+///
+/// Vectors are indexed by the CRAM solver's dense nuclide numbering (see
+/// NucVec::FromDense).
+class DecayOperators {
+ public:
+  /// @param dt the duration of a timestep in seconds
+  /// @param budget_mb the memory budget for cached operators in megabytes
+  DecayOperators(uint64_t dt, double budget_mb);
+
+  /// Returns the number of timesteps in secs, or zero if secs is not a
+  /// positive whole number of timesteps.
+  int Steps(double secs) const;
+
+  /// Decays the dense atom vector x over k timesteps in place.
+  void Decay(int k, std::vector<double>* x);
+
+  /// Returns the duration of a timestep in seconds.
+  inline uint64_t dt() const { return dt_; }
+
+  /// Returns the number of bytes used by cached operators.
+  inline std::size_t bytes() const { return bytes_; }
+
+ private:
+  /// a column of an operator in compressed sparse form
+  struct Column {
+    std::vector<int> rows;
+    std::vector<double> vals;
+  };
+
+  /// the operator that decays vectors over 2^p timesteps
+  struct Operator {
+    /// the CRAM decay matrix scaled by the operator's interval
+    std::vector<double> matrix;
+
+    /// index into columns of each nuclide's column, or -1 if not built
+    std::vector<int> cols;
+
+    std::vector<Column> columns;
+  };
+
+  /// Returns operator p, creating it if necessary.
+  Operator& Op(int p);
+
+  /// Builds the columns of operator p for all nonzero entries of x and
+  /// returns false if the memory budget does not allow it.
+  bool BuildColumns(int p, const std::vector<double>& x);
+
+  /// Sets y to x decayed over 2^p timesteps.
+  void Apply(int p, std::vector<double>* x, std::vector<double>* y);
+
+  uint64_t dt_;
+  std::size_t budget_;
+  std::size_t bytes_;
+  bool full_;
+  std::vector<Operator> ops_;
+  std::vector<double> unit_;
+  std::vector<double> solved_;
+  std::vector<double> tmp_;
+  std::mutex mutex_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_DECAY_OPERATORS_H_
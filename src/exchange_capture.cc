@@ -0,0 +1,101 @@
+#include "exchange_capture.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "error.h"
+
+namespace cyclus {
+
+// every record starts with the magic bytes and the format version
+static const char kMagic[] = {'C', 'Y', 'X', 'G'};
+static const int kVersion = 1;
+
+template <class T>
+static void Put(std::ostream& os, T val) {
+  os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <class T>
+static T Get(std::istream& is) {
+  T val;
+  if (!is.read(reinterpret_cast<char*>(&val), sizeof(T))) {
+    throw ValueError("truncated exchange capture record");
+  }
+  return val;
+}
+
+static std::string GetString(std::istream& is, uint64_t n) {
+  std::string val;
+  const uint64_t chunk = 1 << 16;  // don't trust n with a single allocation
+  char buf[chunk];
+  while (n > 0) {
+    std::streamsize len = std::min(n, chunk);
+    if (!is.read(buf, len)) {
+      throw ValueError("truncated exchange capture record");
+    }
+    val.append(buf, len);
+    n -= len;
+  }
+  return val;
+}
+
+static void WriteRecord(std::ostream& os, int time, const std::string& restype,
+                        const std::string& fp) {
+  os.write(kMagic, sizeof(kMagic));
+  Put(os, kVersion);
+  Put(os, time);
+  Put(os, static_cast<int>(restype.size()));
+  os.write(restype.data(), restype.size());
+  Put(os, static_cast<uint64_t>(fp.size()));
+  os.write(fp.data(), fp.size());
+}
+
+void ExchangeCapture::Write(std::ostream& os) const {
+  WriteRecord(os, time, restype, graph->Fingerprint());
+}
+
+bool ExchangeCapture::Read(std::istream& is) {
+  char magic[sizeof(kMagic)];
+  is.read(magic, sizeof(magic));
+  if (is.gcount() == 0 && is.eof()) {
+    return false;
+  } else if (is.gcount() != sizeof(magic) ||
+             std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    throw ValueError("not an exchange capture record");
+  }
+
+  int version = Get<int>(is);
+  if (version != kVersion) {
+    std::stringstream ss;
+    ss << "unsupported exchange capture version " << version;
+    throw ValueError(ss.str());
+  }
+  time = Get<int>(is);
+  int len = Get<int>(is);
+  if (len < 0) {
+    throw ValueError("invalid exchange capture record");
+  }
+  restype = GetString(is, len);
+  graph = ExchangeGraph::FromFingerprint(GetString(is, Get<uint64_t>(is)));
+  return true;
+}
+
+void ExchangeCapture::Append(const std::string& path, int time,
+                             const std::string& restype,
+                             const ExchangeGraph& graph) {
+  std::ofstream f(path.c_str(),
+                  std::ios::out | std::ios::binary | std::ios::app);
+  if (!f) {
+    throw IOError("could not open exchange capture file " + path);
+  }
+  WriteRecord(f, time, restype, graph.Fingerprint());
+  if (!f) {
+    throw IOError("could not write exchange capture file " + path);
+  }
+}
+
+}  // namespace cyclus
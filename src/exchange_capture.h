@@ -0,0 +1,52 @@
+#ifndef CYCLUS_SRC_EXCHANGE_CAPTURE_H_
+#define CYCLUS_SRC_EXCHANGE_CAPTURE_H_
+
+#include <iostream>
+#include <string>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @class ExchangeCapture
+///
+/// @brief An ExchangeCapture is one exchange graph saved from a simulation so
+/// that it can be solved again offline, e.g., to compare solvers on real
+/// exchanges. A capture file is a sequence of binary records, each holding the
+/// time and resource type of the exchange and the graph's
+/// ExchangeGraph::Fingerprint, so records can simply be appended to a file as
+/// a simulation runs.
+///
+/// Records are written in the machine's native byte order.
+struct ExchangeCapture {
+  ExchangeCapture() : time(-1) {}
+  ExchangeCapture(int time, const std::string& restype,
+                  ExchangeGraph::Ptr graph)
+      : time(time), restype(restype), graph(graph) {}
+
+  /// writes this capture as a single record
+  void Write(std::ostream& os) const;
+
+  /// reads the next record into this capture
+  /// @return false if the stream has no more records
+  /// @throws ValueError if the record is not a valid capture
+  bool Read(std::istream& is);
+
+  /// appends a record for the graph to the capture file at path
+  /// @throws IOError if the file cannot be written
+  static void Append(const std::string& path, int time,
+                     const std::string& restype, const ExchangeGraph& graph);
+
+  /// the simulation time of the exchange
+  int time;
+
+  /// the type of resource exchanged, e.g., Material::kType
+  std::string restype;
+
+  /// the exchange graph as it was before it was solved
+  ExchangeGraph::Ptr graph;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_EXCHANGE_CAPTURE_H_
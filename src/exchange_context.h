@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_EXCHANGE_CONTEXT_H_
 
 #include <assert.h>
+#include <algorithm>
 #include <map>
 #include <cmath>
 #include <string>
@@ -71,8 +72,9 @@ struct ExchangeContext {
   /// @brief adds a bid to the context
   void AddBidPortfolio(const typename BidPortfolio<T>::Ptr port) {
     bids.push_back(port);
-    const std::set<Bid<T>*>& vr = port->bids();
-    typename std::set<Bid<T>*>::const_iterator it;
+    bid_port_arcs.push_back(arc_prefs.size());
+    const std::vector<Bid<T>*>& vr = port->bids();
+    typename std::vector<Bid<T>*>::const_iterator it;
 
     for (it = vr.begin(); it != vr.end(); ++it) {
       Bid<T>* pb = *it;
@@ -90,8 +92,70 @@ struct ExchangeContext {
     bids_by_request[pb->request()].push_back(pb);
 
     double bid_pref = pb->preference();
-    trader_prefs[pb->request()->requester()][pb->request()].insert(
-        std::make_pair(pb, std::isnan(bid_pref) ? pb->request()->preference() : bid_pref));
+    double pref =
+        std::isnan(bid_pref) ? pb->request()->preference() : bid_pref;
+    trader_arcs[pb->request()->requester()].push_back(arc_prefs.size());
+    arc_bids.push_back(pb);
+    arc_prefs.push_back(pref);
+  }
+
+  /// @brief returns the preferences of the arcs to a trader's requests, keyed
+  /// by request and bid. This is the map that the trader and its ancestors
+  /// adjust (see SetPrefs).
+  typename PrefMap<T>::type Prefs(Trader* t) const {
+    typename PrefMap<T>::type prefs;
+    typename std::map<Trader*, std::vector<int> >::const_iterator it =
+        trader_arcs.find(t);
+    if (it == trader_arcs.end()) {
+      return prefs;
+    }
+    const std::vector<int>& arcs = it->second;
+    for (int i = 0; i < arcs.size(); ++i) {
+      Bid<T>* b = arc_bids[arcs[i]];
+      prefs[b->request()].insert(std::make_pair(b, arc_prefs[arcs[i]]));
+    }
+    return prefs;
+  }
+
+  /// @brief stores adjusted preferences for the arcs to a trader's requests.
+  /// An arc missing from prefs gets a preference of 0.
+  void SetPrefs(Trader* t, const typename PrefMap<T>::type& prefs) {
+    typename std::map<Trader*, std::vector<int> >::const_iterator it =
+        trader_arcs.find(t);
+    if (it == trader_arcs.end()) {
+      return;
+    }
+    const std::vector<int>& arcs = it->second;
+    for (int i = 0; i < arcs.size(); ++i) {
+      Bid<T>* b = arc_bids[arcs[i]];
+      double pref = 0;
+      typename PrefMap<T>::type::const_iterator r = prefs.find(b->request());
+      if (r != prefs.end()) {
+        typename std::map<Bid<T>*, double>::const_iterator p =
+            r->second.find(b);
+        if (p != r->second.end()) {
+          pref = p->second;
+        }
+      }
+      arc_prefs[arcs[i]] = pref;
+    }
+  }
+
+  /// @brief returns the preference of the arc from a bid to its request, or
+  /// 0 if the bid was not added
+  double pref(Bid<T>* b) const {
+    typename std::map<Trader*, std::vector<int> >::const_iterator it =
+        trader_arcs.find(b->request()->requester());
+    if (it == trader_arcs.end()) {
+      return 0;
+    }
+    const std::vector<int>& arcs = it->second;
+    for (int i = 0; i < arcs.size(); ++i) {
+      if (arc_bids[arcs[i]] == b) {
+        return arc_prefs[arcs[i]];
+      }
+    }
+    return 0;
   }
 
   /// @brief a reference to an exchange's set of requests
@@ -113,8 +177,21 @@ struct ExchangeContext {
   std::map< Request<T>*, std::vector<Bid<T>*> >
       bids_by_request;
 
-  /// @brief maps commodity name to requests for that commodity
-  std::map<Trader*, typename PrefMap<T>::type> trader_prefs;
+  /// @brief the preference of each request-bid arc, indexed by the order in
+  /// which bids were added. This is where preferences are kept, initially
+  /// those of the bids (or their requests) and adjusted ones once traders
+  /// have adjusted them.
+  std::vector<double> arc_prefs;
+
+  /// @brief the bid of each arc
+  std::vector<Bid<T>*> arc_bids;
+
+  /// @brief the arcs to each requester's requests, in the order they were
+  /// added
+  std::map<Trader*, std::vector<int> > trader_arcs;
+
+  /// @brief the arc index of the first bid in each of the bid portfolios
+  std::vector<int> bid_port_arcs;
 };
 
 }  // namespace cyclus
@@ -1,6 +1,7 @@
 #include "exchange_graph.h"
 
 #include <algorithm>
+#include <cstring>
 #include <boost/math/special_functions/next.hpp>
 
 #include "cyc_limits.h"
@@ -138,4 +139,281 @@ void ExchangeGraph::AddMatch(const Arc& a, double qty) {
   matches_.push_back(std::make_pair(a, qty));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int FindRoot(std::vector<int>* parent, int i) {
+  while ((*parent)[i] != i) {
+    (*parent)[i] = (*parent)[(*parent)[i]];
+    i = (*parent)[i];
+  }
+  return i;
+}
+
+std::vector<ExchangeGraph::Ptr> ExchangeGraph::Components() const {
+  // request groups take indices [0, nreq) and supply groups the rest
+  int nreq = request_groups_.size();
+  std::map<ExchangeNodeGroup*, int> index;
+  for (int i = 0; i < nreq; ++i) {
+    index[request_groups_[i].get()] = i;
+  }
+  for (int i = 0; i < supply_groups_.size(); ++i) {
+    index[supply_groups_[i].get()] = nreq + i;
+  }
+
+  std::vector<int> parent(index.size());
+  for (int i = 0; i < parent.size(); ++i) {
+    parent[i] = i;
+  }
+  std::vector<bool> linked(index.size(), false);
+  std::vector<int> arc_group(arcs_.size());
+  for (int i = 0; i < arcs_.size(); ++i) {
+    int u = index.at(arcs_[i].unode()->group);
+    int v = index.at(arcs_[i].vnode()->group);
+    linked[u] = linked[v] = true;
+    parent[FindRoot(&parent, u)] = FindRoot(&parent, v);
+    arc_group[i] = u;
+  }
+
+  // components are numbered as they are first seen, i.e. by their lowest
+  // group index
+
+  std::vector<ExchangeGraph::Ptr> comps;
+  std::map<int, int> comp_of_root;
+  std::vector<int> comp_of_group(index.size(), -1);
+  for (int i = 0; i < parent.size(); ++i) {
+    if (!linked[i]) {
+      continue;
+    }
+    int root = FindRoot(&parent, i);
+    std::map<int, int>::iterator it = comp_of_root.find(root);
+    if (it == comp_of_root.end()) {
+      it = comp_of_root.insert(std::make_pair(root, comps.size())).first;
+      comps.push_back(ExchangeGraph::Ptr(new ExchangeGraph()));
+    }
+    comp_of_group[i] = it->second;
+    if (i < nreq) {
+      comps[it->second]->AddRequestGroup(request_groups_[i]);
+    } else {
+      comps[it->second]->AddSupplyGroup(supply_groups_[i - nreq]);
+    }
+  }
+
+  for (int i = 0; i < arcs_.size(); ++i) {
+    comps[comp_of_group[arc_group[i]]]->AddArc(arcs_[i]);
+  }
+  return comps;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template <class T>
+static void Pack(std::string* buf, T val) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &val, sizeof(T));
+  buf->append(bytes, sizeof(T));
+}
+
+static void Pack(std::string* buf, const std::string& val) {
+  Pack(buf, static_cast<int>(val.size()));
+  buf->append(val);
+}
+
+static void Pack(std::string* buf, const std::vector<double>& vals) {
+  Pack(buf, static_cast<int>(vals.size()));
+  for (int i = 0; i < vals.size(); ++i) {
+    Pack(buf, vals[i]);
+  }
+}
+
+static void PackGroup(std::string* buf, const ExchangeNodeGroup& g,
+                      std::map<ExchangeNode*, int>* index) {
+  Pack(buf, g.capacities());
+  const std::vector<ExchangeNode::Ptr>& nodes = g.nodes();
+  Pack(buf, static_cast<int>(nodes.size()));
+  for (int i = 0; i < nodes.size(); ++i) {
+    const ExchangeNode& n = *nodes[i];
+    int id = index->size();
+    (*index)[nodes[i].get()] = id;
+    Pack(buf, n.qty);
+    Pack(buf, n.exclusive);
+    Pack(buf, n.agent_id);
+    Pack(buf, n.commod);
+  }
+
+  const std::vector<std::vector<ExchangeNode::Ptr> >& excl =
+      g.excl_node_groups();
+  Pack(buf, static_cast<int>(excl.size()));
+  for (int i = 0; i < excl.size(); ++i) {
+    Pack(buf, static_cast<int>(excl[i].size()));
+    for (int j = 0; j < excl[i].size(); ++j) {
+      Pack(buf, (*index)[excl[i][j].get()]);
+    }
+  }
+}
+
+std::string ExchangeGraph::Fingerprint() const {
+  std::string buf;
+  std::map<ExchangeNode*, int> index;
+
+  Pack(&buf, static_cast<int>(request_groups_.size()));
+  for (int i = 0; i < request_groups_.size(); ++i) {
+    Pack(&buf, request_groups_[i]->qty());
+    PackGroup(&buf, *request_groups_[i], &index);
+  }
+  Pack(&buf, static_cast<int>(supply_groups_.size()));
+  for (int i = 0; i < supply_groups_.size(); ++i) {
+    PackGroup(&buf, *supply_groups_[i], &index);
+  }
+
+  // arcs_ is in id order
+  Pack(&buf, static_cast<int>(arcs_.size()));
+  for (int i = 0; i < arcs_.size(); ++i) {
+    const Arc& a = arcs_[i];
+    ExchangeNode::Ptr u = a.unode();
+    ExchangeNode::Ptr v = a.vnode();
+    Pack(&buf, index[u.get()]);
+    Pack(&buf, index[v.get()]);
+    Pack(&buf, a.exclusive());
+    Pack(&buf, a.excl_val());
+    Pack(&buf, a.pref());
+
+    std::map<Arc, double>::const_iterator p = u->prefs.find(a);
+    Pack(&buf, p == u->prefs.end() ? 0.0 : p->second);
+    std::map<Arc, std::vector<double> >::const_iterator c;
+    c = u->unit_capacities.find(a);
+    Pack(&buf, c == u->unit_capacities.end() ? std::vector<double>() : c->second);
+    c = v->unit_capacities.find(a);
+    Pack(&buf, c == v->unit_capacities.end() ? std::vector<double>() : c->second);
+  }
+  return buf;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// reads back the values written by Pack, in the same order
+class Unpacker {
+ public:
+  explicit Unpacker(const std::string& buf) : buf_(buf), pos_(0) {}
+
+  template <class T>
+  T Get() {
+    Need(sizeof(T));
+    T val;
+    std::memcpy(&val, buf_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return val;
+  }
+
+  /// @return a count, which must be nonnegative
+  int Size() {
+    int n = Get<int>();
+    if (n < 0) {
+      throw ValueError("invalid exchange graph fingerprint: negative size");
+    }
+    return n;
+  }
+
+  std::string String() {
+    int n = Size();
+    Need(n);
+    std::string val = buf_.substr(pos_, n);
+    pos_ += n;
+    return val;
+  }
+
+  std::vector<double> Vector() {
+    int n = Size();
+    Need(static_cast<size_t>(n) * sizeof(double));
+    std::vector<double> vals(n);
+    for (int i = 0; i < n; ++i) {
+      vals[i] = Get<double>();
+    }
+    return vals;
+  }
+
+  inline bool done() const { return pos_ == buf_.size(); }
+
+ private:
+  void Need(size_t n) {
+    if (buf_.size() - pos_ < n) {
+      throw ValueError("invalid exchange graph fingerprint: truncated");
+    }
+  }
+
+  const std::string& buf_;
+  size_t pos_;
+};
+
+static ExchangeNode::Ptr NodeAt(const std::vector<ExchangeNode::Ptr>& nodes,
+                                int i) {
+  if (i < 0 || i >= nodes.size()) {
+    throw ValueError("invalid exchange graph fingerprint: bad node index");
+  }
+  return nodes[i];
+}
+
+static void UnpackGroup(Unpacker* buf, ExchangeNodeGroup* g,
+                        std::vector<ExchangeNode::Ptr>* nodes) {
+  g->capacities() = buf->Vector();
+  int nnodes = buf->Size();
+  for (int i = 0; i < nnodes; ++i) {
+    double qty = buf->Get<double>();
+    bool exclusive = buf->Get<bool>();
+    int agent_id = buf->Get<int>();
+    std::string commod = buf->String();
+    ExchangeNode::Ptr n(new ExchangeNode(qty, exclusive, commod, agent_id));
+    g->AddExchangeNode(n);
+    nodes->push_back(n);
+  }
+
+  // request groups add their exclusive nodes themselves, so the packed
+  // groups replace those
+  g->excl_node_groups().clear();
+  int nexcl = buf->Size();
+  for (int i = 0; i < nexcl; ++i) {
+    std::vector<ExchangeNode::Ptr> excl(buf->Size());
+    for (int j = 0; j < excl.size(); ++j) {
+      excl[j] = NodeAt(*nodes, buf->Get<int>());
+    }
+    g->AddExclGroup(excl);
+  }
+}
+
+ExchangeGraph::Ptr ExchangeGraph::FromFingerprint(const std::string& fp) {
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  Unpacker buf(fp);
+  std::vector<ExchangeNode::Ptr> nodes;
+
+  int nreq = buf.Size();
+  for (int i = 0; i < nreq; ++i) {
+    RequestGroup::Ptr rg(new RequestGroup(buf.Get<double>()));
+    UnpackGroup(&buf, rg.get(), &nodes);
+    g->AddRequestGroup(rg);
+  }
+  int nsup = buf.Size();
+  for (int i = 0; i < nsup; ++i) {
+    ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+    UnpackGroup(&buf, sg.get(), &nodes);
+    g->AddSupplyGroup(sg);
+  }
+
+  // exclusivity is derived from the nodes when an arc is made, so the packed
+  // values only need to be skipped
+  int narcs = buf.Size();
+  for (int i = 0; i < narcs; ++i) {
+    ExchangeNode::Ptr u = NodeAt(nodes, buf.Get<int>());
+    ExchangeNode::Ptr v = NodeAt(nodes, buf.Get<int>());
+    buf.Get<bool>();
+    buf.Get<double>();
+    Arc a(u, v);
+    a.pref(buf.Get<double>());
+    u->prefs[a] = buf.Get<double>();
+    u->unit_capacities[a] = buf.Vector();
+    v->unit_capacities[a] = buf.Vector();
+    g->AddArc(a);
+  }
+
+  if (!buf.done()) {
+    throw ValueError("invalid exchange graph fingerprint: trailing data");
+  }
+  return g;
+}
+
 }  // namespace cyclus
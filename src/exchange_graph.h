@@ -228,6 +228,28 @@ class ExchangeGraph {
   /// clears all matches
   inline void ClearMatches() { matches_.clear(); }
 
+  /// @brief returns a compact serialization of everything about the graph
+  /// that a solver can observe: groups, capacities, nodes, arcs, preferences,
+  /// and exclusivity, with nodes identified by their position in the graph and
+  /// arcs by their id. Two graphs with equal fingerprints are the same
+  /// problem, so a deterministic solver gives both the same matches (by arc
+  /// id).
+  std::string Fingerprint() const;
+
+  /// @brief rebuilds a graph from its Fingerprint, so that graphs can be saved
+  /// and solved again later. The new graph has the same groups, nodes, and
+  /// arcs (with the same ids) but no matches.
+  /// @throws ValueError if fp is not a valid fingerprint
+  static ExchangeGraph::Ptr FromFingerprint(const std::string& fp);
+
+  /// @brief splits the graph into its connected components, where request
+  /// and supply groups are connected by the arcs between their nodes. Each
+  /// component shares its groups, nodes, and arcs with this graph and keeps
+  /// their relative order; components are ordered by their first request
+  /// group. Groups without any arcs are left out, since no solver can match
+  /// them.
+  std::vector<ExchangeGraph::Ptr> Components() const;
+
   inline const std::vector<RequestGroup::Ptr>& request_groups() const {
     return request_groups_;
   }
@@ -2,10 +2,18 @@
 #define CYCLUS_SRC_EXCHANGE_MANAGER_H_
 
 #include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "exchange_capture.h"
 #include "exchange_graph.h"
 #include "exchange_solver.h"
 #include "exchange_translator.h"
+#include "phase_timings.h"
 #include "resource_exchange.h"
 #include "trade_executor.h"
 #include "trader_management.h"
@@ -24,38 +32,83 @@ namespace cyclus {
 /// ExchangeManager<ResourceType> manager(ctx);
 /// manager.Execute();
 /// @endcode
+///
+/// Every execution that has something to trade records one row to the
+/// ExchangeStats table with the size of the exchange, the wall clock time
+/// spent in each of its phases, the solver's objective, and the matched
+/// quantity by commodity. Empty exchanges, in which no request received a
+/// bid (e.g. of a resource type that no trader requested), are not
+/// translated or solved and get no row.
+///
+/// If the CYCLUS_CAPTURE_DRE environment variable is set, every translated
+/// exchange graph is also appended to the ExchangeCapture file it names, so
+/// that the exchanges can be replayed offline with the cyclus_dre_bench tool.
 template <class T>
 class ExchangeManager {
  public:
-  ExchangeManager(Context* ctx) : ctx_(ctx), debug_(false) {
+  ExchangeManager(Context* ctx)
+      : ctx_(ctx), debug_(false), idle_(false) {
     debug_ = Env::GetEnv("CYCLUS_DEBUG_DRE").size() > 0;
+    capture_path_ = Env::GetEnv("CYCLUS_CAPTURE_DRE");
   }
 
+  /// @brief returns true if no requests were made in the most recently
+  /// executed exchange
+  inline bool idle() const { return idle_; }
+
   /// @brief execute the full resource sequence
   void Execute() {
+    PhaseTimer pt(ctx_->phase_timings());
+    Stats stats;
+
     // collect resource exchange information
     ResourceExchange<T> exchng(ctx_);
-    exchng.AddAllRequests();
-    exchng.AddAllBids();
+    exchng.AddAllRequests(&request_ids_);
+    idle_ = exchng.ex_ctx().commod_requests.empty();
+    pt.Lap("ResEx.Requests");
+    stats.Lap(&stats.requests_secs);
+    exchng.AddAllBids(&bid_ids_);
+    pt.Lap("ResEx.Bids");
+    stats.Lap(&stats.bids_secs);
     exchng.AdjustAll();
+    pt.Lap("ResEx.Prefs");
+    stats.Lap(&stats.prefs_secs);
     CLOG(LEV_DEBUG1) << "done with info gathering";
 
-    if (debug_)
+    if (debug_) {
       RecordDebugInfo(exchng.ex_ctx());
+      pt.Lap("ResEx.Debug");
+      stats.Lap(NULL);
+    }
 
-    if (exchng.Empty())
+    if (exchng.Empty()) {
       return; // empty exchange, move on
+    }
 
     // translate graph
     ExchangeTranslator<T> xlator(&exchng.ex_ctx());
     CLOG(LEV_DEBUG1) << "translating graph...";
     ExchangeGraph::Ptr graph = xlator.Translate();
     CLOG(LEV_DEBUG1) << "graph translated!";
+    pt.Lap("ResEx.Translate");
+    stats.Lap(&stats.translate_secs);
+
+    if (!capture_path_.empty()) {
+      ExchangeCapture::Append(capture_path_, ctx_->time(), T::kType, *graph);
+      pt.Lap("ResEx.Capture");
+      stats.Lap(NULL);
+    }
 
     // solve graph
     CLOG(LEV_DEBUG1) << "solving graph...";
-    ctx_->solver()->Solve(graph.get());
+    if (!ctx_->sim_info().incremental_exchange) {
+      stats.objective = ctx_->solver()->Solve(graph.get());
+    } else {
+      stats.objective = SolveIncremental(graph.get());
+    }
     CLOG(LEV_DEBUG1) << "graph solved!";
+    pt.Lap("ResEx.Solve");
+    stats.Lap(&stats.solve_secs);
 
     // get trades
     std::vector< Trade<T> > trades;
@@ -65,9 +118,209 @@ class ExchangeManager {
     // execute trades!
     TradeExecutor<T> exec(trades);
     exec.ExecuteTrades(ctx_);
+    pt.Lap("ResEx.Trade");
+    stats.Lap(&stats.trade_secs);
+
+    RecordStats(exchng.ex_ctx(), graph.get(), stats);
   }
 
  private:
+  /// wall clock times and solver results of a single exchange
+  struct Stats {
+    typedef std::chrono::steady_clock Clock;
+
+    Stats()
+        : start(Clock::now()),
+          requests_secs(0),
+          bids_secs(0),
+          prefs_secs(0),
+          translate_secs(0),
+          solve_secs(0),
+          trade_secs(0),
+          objective(0) {}
+
+    /// adds the time since the previous lap to secs (if not NULL)
+    void Lap(double* secs) {
+      Clock::time_point now = Clock::now();
+      if (secs != NULL) {
+        *secs += std::chrono::duration<double>(now - start).count();
+      }
+      start = now;
+    }
+
+    Clock::time_point start;
+    double requests_secs;
+    double bids_secs;
+    double prefs_secs;
+    double translate_secs;
+    double solve_secs;
+    double trade_secs;
+    double objective;
+  };
+
+  /// a solved graph's objective and its matches as (arc id, flow) pairs,
+  /// which can be replayed on any graph with the same fingerprint
+  struct Solution {
+    Solution() : objective(0) {}
+
+    Solution(ExchangeGraph* graph, double obj) : objective(obj) {
+      const std::vector<Match>& m = graph->matches();
+      for (int i = 0; i < m.size(); ++i) {
+        matches.push_back(std::make_pair(graph->arc_ids().at(m[i].first),
+                                         m[i].second));
+      }
+    }
+
+    void Replay(ExchangeGraph* graph) const {
+      for (int i = 0; i < matches.size(); ++i) {
+        graph->AddMatch(graph->arc_by_id().at(matches[i].first),
+                        matches[i].second);
+      }
+    }
+
+    std::vector<std::pair<int, double> > matches;
+    double objective;
+  };
+
+  /// records the exchange's row in the ExchangeStats table
+  void RecordStats(ExchangeContext<T>& exctx, ExchangeGraph* graph,
+                   const Stats& stats) {
+    std::set<Trader*> traders = exctx.requesters;
+    traders.insert(exctx.bidders.begin(), exctx.bidders.end());
+
+    int nrequests = 0;
+    for (int i = 0; i < exctx.requests.size(); ++i) {
+      nrequests += exctx.requests[i]->requests().size();
+    }
+    int nbids = 0;
+    for (int i = 0; i < exctx.bids.size(); ++i) {
+      nbids += exctx.bids[i]->bids().size();
+    }
+
+    int nexcl = 0;
+    const std::vector<Arc>& arcs = graph->arcs();
+    int narcs = arcs.size();
+    for (int i = 0; i < narcs; ++i) {
+      if (arcs[i].exclusive()) {
+        nexcl++;
+      }
+    }
+
+    std::map<std::string, double> matched;
+    std::map<ExchangeNodeGroup*, double> group_matched;
+    const std::vector<Match>& matches = graph->matches();
+    for (int i = 0; i < matches.size(); ++i) {
+      ExchangeNode::Ptr u = matches[i].first.unode();
+      matched[u->commod] += matches[i].second;
+      group_matched[u->group] += matches[i].second;
+    }
+    double unmatched = 0;
+    std::vector<RequestGroup::Ptr>& rgs = graph->request_groups();
+    for (int i = 0; i < rgs.size(); ++i) {
+      unmatched += std::max(0.0, rgs[i]->qty() - group_matched[rgs[i].get()]);
+    }
+
+    ctx_->NewDatum("ExchangeStats")
+        ->AddVal("Time", ctx_->time())
+        ->AddVal("ResourceType", T::kType)
+        ->AddVal("Traders", static_cast<int>(traders.size()))
+        ->AddVal("RequestPortfolios", static_cast<int>(exctx.requests.size()))
+        ->AddVal("BidPortfolios", static_cast<int>(exctx.bids.size()))
+        ->AddVal("Requests", nrequests)
+        ->AddVal("Bids", nbids)
+        ->AddVal("Arcs", narcs)
+        ->AddVal("ExclusiveArcs", nexcl)
+        ->AddVal("RequestSeconds", stats.requests_secs)
+        ->AddVal("BidSeconds", stats.bids_secs)
+        ->AddVal("PrefSeconds", stats.prefs_secs)
+        ->AddVal("TranslateSeconds", stats.translate_secs)
+        ->AddVal("SolveSeconds", stats.solve_secs)
+        ->AddVal("TradeSeconds", stats.trade_secs)
+        ->AddVal("Objective", stats.objective)
+        ->AddVal("Unmatched", unmatched)
+        ->AddVal("Matched", matched)
+        ->Record();
+  }
+
+  /// solves the graph, copying over the solutions of the problems solved in
+  /// the previous exchange by arc id. If the solver decomposes graphs, each
+  /// connected component is reused or solved on its own, keyed by its
+  /// fingerprint and the pseudo cost of the whole graph; otherwise the graph
+  /// is reused only as a whole. Fingerprinting costs a pass over the graph,
+  /// which is counted in the exchange's SolveSeconds.
+  /// @return the solver's objective
+  double SolveIncremental(ExchangeGraph* graph) {
+    ExchangeSolver* solver = ctx_->solver();
+    std::vector<ExchangeGraph::Ptr> comps;
+    double pseudo_cost = 0;
+    if (solver->decompose()) {
+      comps = graph->Components();
+      solver->graph(graph);
+      pseudo_cost = solver->PseudoCost();
+    }
+
+    std::map<std::string, Solution> solutions;
+    if (comps.size() < 2) {
+      std::string fingerprint = graph->Fingerprint();
+      typename std::map<std::string, Solution>::iterator it =
+          prev_solutions_.find(fingerprint);
+      if (it != prev_solutions_.end()) {
+        CLOG(LEV_DEBUG1) << "reusing previous exchange solution";
+        it->second.Replay(graph);
+        solutions.insert(*it);
+      } else {
+        double obj = solver->Solve(graph);
+        solutions[fingerprint] = Solution(graph, obj);
+      }
+      prev_solutions_.swap(solutions);
+      return prev_solutions_.begin()->second.objective;
+    }
+
+    std::vector<std::string> keys(comps.size());
+    std::vector<double> objs(comps.size(), 0);
+    std::vector<ExchangeGraph::Ptr> unsolved;
+    std::vector<int> unsolved_comps;
+    for (int i = 0; i < comps.size(); ++i) {
+      keys[i] = comps[i]->Fingerprint();
+      keys[i].append(reinterpret_cast<const char*>(&pseudo_cost),
+                     sizeof(pseudo_cost));
+      typename std::map<std::string, Solution>::iterator it =
+          prev_solutions_.find(keys[i]);
+      if (it != prev_solutions_.end()) {
+        it->second.Replay(comps[i].get());
+        objs[i] = it->second.objective;
+        solutions.insert(*it);
+      } else {
+        unsolved.push_back(comps[i]);
+        unsolved_comps.push_back(i);
+      }
+    }
+    CLOG(LEV_DEBUG1) << "reusing " << comps.size() - unsolved.size() << " of "
+                     << comps.size() << " previous component solutions";
+
+    if (!unsolved.empty()) {
+      std::vector<double> unsolved_objs = solver->Solve(graph, unsolved);
+      for (int i = 0; i < unsolved.size(); ++i) {
+        int c = unsolved_comps[i];
+        objs[c] = unsolved_objs[i];
+        solutions[keys[c]] = Solution(comps[c].get(), objs[c]);
+      }
+    }
+
+    // matches are merged in component order, as in a decomposed solve
+    graph->ClearMatches();
+    double obj = 0;
+    for (int i = 0; i < comps.size(); ++i) {
+      obj += objs[i];
+      const std::vector<Match>& matches = comps[i]->matches();
+      for (int j = 0; j < matches.size(); ++j) {
+        graph->AddMatch(matches[j].first, matches[j].second);
+      }
+    }
+    prev_solutions_.swap(solutions);
+    return obj;
+  }
+
   void RecordDebugInfo(ExchangeContext<T>& exctx) {
     typename std::vector<typename RequestPortfolio<T>::Ptr>::iterator it;
     for (it = exctx.requests.begin(); it != exctx.requests.end(); ++it) {
@@ -91,14 +344,14 @@ class ExchangeManager {
       }
     }
 
-    typename std::vector<typename BidPortfolio<T>::Ptr>::iterator it3;
-    for (it3 = exctx.bids.begin(); it3 != exctx.bids.end(); ++it3) {
-      std::set<Bid<T>*> bids = (*it3)->bids();
-      typename std::set<Bid<T>*>::iterator it4;
-      for (it4 = bids.begin(); it4 != bids.end(); ++it4) {
+    for (int i = 0; i < exctx.bids.size(); ++i) {
+      // arcs are numbered in the order of the portfolios' bids
+      int arc = exctx.bid_port_arcs[i];
+      const std::vector<Bid<T>*>& bids = exctx.bids[i]->bids();
+      typename std::vector<Bid<T>*>::const_iterator it4;
+      for (it4 = bids.begin(); it4 != bids.end(); ++it4, ++arc) {
         Bid<T>* b = *it4;
-        Request<T>* r = b->request();
-        double pref = exctx.trader_prefs[r->requester()][r][b];
+        double pref = exctx.arc_prefs[arc];
         std::stringstream ss;
         ss << ctx_->time() << "_" << b->request();
         ctx_->NewDatum("DebugBids")
@@ -113,7 +366,20 @@ class ExchangeManager {
   }
 
   bool debug_;
+  bool idle_;
   Context* ctx_;
+
+  /// the ids used by each re-entrant trader in previous exchanges, see
+  /// ResourceExchange
+  IdHints request_ids_;
+  IdHints bid_ids_;
+
+  /// the file that exchange graphs are captured to, if any
+  std::string capture_path_;
+
+  /// the solutions of the previous exchange by fingerprint, used when
+  /// exchanges are solved incrementally
+  std::map<std::string, Solution> prev_solutions_;
 };
 
 }  // namespace cyclus
@@ -1,10 +1,16 @@
 #include "exchange_solver.h"
 
-#include <vector>
+#include <functional>
 #include <map>
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include "compact_graph.h"
 #include "context.h"
 #include "exchange_graph.h"
+#include "logger.h"
+#include "thread_pool.h"
 
 namespace cyclus {
 
@@ -13,8 +19,22 @@ double ExchangeSolver::Cost(const Arc& a, bool exclusive_orders) {
       a.excl_val() / a.pref() : 1.0 / a.pref();
 }
 
+ExchangeSolver::~ExchangeSolver() {
+  std::multimap<std::string, ExchangeSolver*>::iterator it;
+  for (it = clones_.begin(); it != clones_.end(); ++it) {
+    delete it->second;
+  }
+}
+
+const CompactGraph::Ptr& ExchangeSolver::Compact() {
+  if (cg_ == NULL || cg_->graph() != graph_) {
+    cg_.reset(new CompactGraph(graph_));
+  }
+  return cg_;
+}
+
 double ExchangeSolver::PseudoCost() {
-  return PseudoCost(1e-1);
+  return pseudo_cost_ >= 0 ? pseudo_cost_ : PseudoCost(1e-1);
 }
 
 double ExchangeSolver::PseudoCost(double cost_factor) {
@@ -96,4 +116,136 @@ double ExchangeSolver::PseudoCostByPref(double cost_factor) {
   return max_cost * (1 + cost_factor);
 }
 
+static void SolveComponent(std::vector<ExchangeSolver*>* solvers,
+                           const std::vector<ExchangeGraph::Ptr>* comps,
+                           std::vector<double>* objs, int i) {
+  (*objs)[i] = (*solvers)[i]->Solve((*comps)[i].get());
+}
+
+/// the identity of a graph's columns, i.e., the agents and commodity of each
+/// of its arcs in id order, by which kept clones are matched to parts
+static std::string ColumnKey(const ExchangeGraph& g) {
+  std::stringstream ss;
+  const std::vector<Arc>& arcs = g.arcs();
+  for (int i = 0; i < arcs.size(); ++i) {
+    ExchangeNode::Ptr u = arcs[i].unode();
+    ss << u->agent_id << " " << arcs[i].vnode()->agent_id << " " << u->commod
+       << "\n";
+  }
+  return ss.str();
+}
+
+double ExchangeSolver::SolveComponents() {
+  std::vector<ExchangeGraph::Ptr> comps = graph_->Components();
+  if (comps.size() < 2) {
+    return SolveGraph();
+  }
+
+  std::vector<double> objs = SolveParts(comps);
+  double obj = 0;
+  for (int i = 0; i < objs.size(); ++i) {
+    obj += objs[i];
+  }
+  return obj;
+}
+
+std::vector<double> ExchangeSolver::SolveParts(
+    const std::vector<ExchangeGraph::Ptr>& comps) {
+  // unmet demand costs the same in every component as in the whole graph
+  ExchangeGraph* whole = graph_;
+  double fixed = pseudo_cost_;
+  double pseudo_cost = PseudoCost();
+  std::vector<double> objs(comps.size(), 0);
+  ThreadPool* pool = sim_ctx_ == NULL ? NULL : sim_ctx_->thread_pool();
+  bool keep = KeepsClones();
+  std::vector<std::string> keys;
+  if (keep) {
+    keys.resize(comps.size());
+    for (int i = 0; i < comps.size(); ++i) {
+      keys[i] = ColumnKey(*comps[i]);
+    }
+  }
+  std::vector<ExchangeSolver*> solvers;
+  for (int i = 0; (pool != NULL || keep) && i < comps.size(); ++i) {
+    ExchangeSolver* s = NULL;
+    if (keep) {
+      std::multimap<std::string, ExchangeSolver*>::iterator it =
+          clones_.find(keys[i]);
+      if (it != clones_.end()) {
+        s = it->second;
+        clones_.erase(it);
+      } else {
+        CLOG(LEV_DEBUG1) << "No kept solver has the columns of component "
+                         << i << ", solving it with a new clone.";
+      }
+    }
+    if (s == NULL) {
+      s = Clone();
+    }
+    if (s == NULL) {
+      break;
+    }
+    s->sim_ctx_ = sim_ctx_;
+    s->verbose_ = verbose_;
+    s->pseudo_cost_ = pseudo_cost;
+    solvers.push_back(s);
+  }
+  std::multimap<std::string, ExchangeSolver*>::iterator it;
+  for (it = clones_.begin(); it != clones_.end(); ++it) {
+    delete it->second;
+  }
+  clones_.clear();
+
+  try {
+    if (solvers.size() == comps.size() && pool != NULL) {
+      pool->ParallelFor(comps.size(),
+                        std::bind(&SolveComponent, &solvers, &comps, &objs,
+                                  std::placeholders::_1));
+    } else if (solvers.size() == comps.size()) {
+      for (int i = 0; i < comps.size(); ++i) {
+        SolveComponent(&solvers, &comps, &objs, i);
+      }
+    } else {
+      pseudo_cost_ = pseudo_cost;
+      for (int i = 0; i < comps.size(); ++i) {
+        graph_ = comps[i].get();
+        cg_.reset();
+        objs[i] = SolveGraph();
+        MergeComponent(this);
+      }
+    }
+  } catch (...) {
+    graph_ = whole;
+    pseudo_cost_ = fixed;
+    for (int i = 0; i < solvers.size(); ++i) {
+      delete solvers[i];
+    }
+    throw;
+  }
+
+  graph_ = whole;
+  pseudo_cost_ = fixed;
+  for (int i = 0; i < solvers.size(); ++i) {
+    if (solvers.size() == comps.size()) {
+      MergeComponent(solvers[i]);
+    }
+    if (!keep) {
+      delete solvers[i];
+    }
+  }
+  if (keep) {
+    for (int i = 0; i < solvers.size(); ++i) {
+      clones_.insert(std::make_pair(keys[i], solvers[i]));
+    }
+  }
+
+  for (int i = 0; i < comps.size(); ++i) {
+    const std::vector<Match>& matches = comps[i]->matches();
+    for (int j = 0; j < matches.size(); ++j) {
+      graph_->AddMatch(matches[j].first, matches[j].second);
+    }
+  }
+  return objs;
+}
+
 } // namespace cyclus
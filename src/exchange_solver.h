@@ -2,11 +2,17 @@
 #define CYCLUS_SRC_EXCHANGE_SOLVER_H_
 
 #include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
 
 namespace cyclus {
 
 class Context;
 class ExchangeGraph;
+class CompactGraph;
 class Arc;
 
 /// @class ExchangeSolver
@@ -23,8 +29,16 @@ class ExchangeSolver {
   explicit ExchangeSolver(bool exclusive_orders = kDefaultExclusive)
     : exclusive_orders_(exclusive_orders),
       sim_ctx_(NULL),
-      verbose_(false) {}
-  virtual ~ExchangeSolver() {}
+      verbose_(false),
+      decompose_(false),
+      pseudo_cost_(-1) {}
+  virtual ~ExchangeSolver();
+
+  /// @brief returns a new solver with the same configuration as this one,
+  /// used to solve independent parts of a graph concurrently. Solvers that
+  /// cannot be copied return NULL (the default), in which case the parts are
+  /// solved one after another by this solver.
+  virtual ExchangeSolver* Clone() const { return NULL; }
 
   /// simulation context get/set
   /// @{
@@ -34,6 +48,14 @@ class ExchangeSolver {
 
   /// tell the solver to be verbose
   inline void verbose() { verbose_ = true; }
+
+  /// whether graphs are split into connected components that are solved
+  /// separately (and concurrently, if the simulation has a worker pool and
+  /// the solver can be cloned)
+  /// @{
+  inline void decompose(bool d) { decompose_ = d; }
+  inline bool decompose() const { return decompose_; }
+  /// @}
   inline void graph(ExchangeGraph* graph) { graph_ = graph; }
   inline ExchangeGraph* graph() const { return graph_; }
 
@@ -42,13 +64,45 @@ class ExchangeSolver {
   double Solve(ExchangeGraph* graph = NULL) {
     if (graph != NULL)
       graph_ = graph;
-    return this->SolveGraph();
+    cg_.swap(next_cg_);
+    next_cg_.reset();
+    return decompose_ ? SolveComponents() : this->SolveGraph();
   }
 
+  /// @brief solves the given parts of a graph, e.g. some of its connected
+  /// components, separately like the components of a decomposed graph: with
+  /// the pseudo cost of the whole graph, and adding their matches to it in
+  /// order
+  /// @return the objective of each part
+  std::vector<double> Solve(
+      ExchangeGraph* graph,
+      const std::vector<boost::shared_ptr<ExchangeGraph> >& parts) {
+    graph_ = graph;
+    cg_.swap(next_cg_);
+    next_cg_.reset();
+    return SolveParts(parts);
+  }
+
+  /// @brief gives the solver the CompactGraph snapshot of the next graph it
+  /// solves, e.g. the one another solver of the same graph used, so that the
+  /// snapshot is built once per exchange. It must reflect the graph's current
+  /// node order.
+  inline void compact_graph(boost::shared_ptr<CompactGraph> cg) {
+    next_cg_ = cg;
+  }
+
+  /// @return the CompactGraph snapshot used in the last solve, if any
+  inline boost::shared_ptr<CompactGraph> compact_graph() const { return cg_; }
+
+  /// @brief fixes the value returned by PseudoCost(), e.g. so that parts of
+  /// a graph solved separately use the pseudo cost of the whole graph. A
+  /// negative value (the default) has it calculated from the graph.
+  inline void pseudo_cost(double c) { pseudo_cost_ = c; }
+
   /// @brief Calculates the ratio of the maximum objective coefficient to
   /// minimum unit capacity plus an added cost. This is guaranteed to be larger
   /// than any other arc cost measure and can be used as a cost for unmet
-  /// demand.
+  /// demand. PseudoCost() returns the fixed pseudo cost instead, if one is set.
   /// @param cost_factor the additional cost for false arc costs, i.e., max_cost
   /// * (1 + cost_factor)
   /// @{
@@ -65,10 +119,52 @@ class ExchangeSolver {
   /// @brief Worker function for solving a graph. This must be implemented by
   /// any solver.
   virtual double SolveGraph() = 0;
+
+  /// solves each of the given parts of graph_ separately (and concurrently,
+  /// if possible), with the pseudo cost of graph_, and merges their matches
+  /// into graph_ in order
+  /// @return the objective of each part
+  virtual std::vector<double> SolveParts(
+      const std::vector<boost::shared_ptr<ExchangeGraph> >& parts);
+
+  /// @brief called by SolveParts in order with the solver that solved each
+  /// part, i.e., either a clone or this solver itself right after it solved
+  /// the part
+  virtual void MergeComponent(const ExchangeSolver* s) {}
+
+  /// @brief whether the clone that solved each part of a graph is kept to
+  /// solve the part of the next graph with the same columns, i.e., the same
+  /// agents and commodity on each arc, e.g. because solvers keep state
+  /// between solves. Parts are then solved by clones even without a worker
+  /// pool. Default false.
+  virtual bool KeepsClones() const { return false; }
+
+  /// @return the CompactGraph snapshot of graph_, which is only built if the
+  /// solver was not given one of graph_ and has not built one yet
+  const boost::shared_ptr<CompactGraph>& Compact();
+
   ExchangeGraph* graph_;
   bool exclusive_orders_;
   bool verbose_;
+  bool decompose_;
   Context* sim_ctx_;
+
+  /// the fixed pseudo cost, or negative if it is calculated from the graph
+  double pseudo_cost_;
+
+  /// the CompactGraph snapshot of graph_, see Compact
+  boost::shared_ptr<CompactGraph> cg_;
+
+ private:
+  /// the snapshot given for the next solve, see compact_graph
+  boost::shared_ptr<CompactGraph> next_cg_;
+
+  /// the clones kept from the last SolveParts by the columns of the part
+  /// they solved, see KeepsClones
+  std::multimap<std::string, ExchangeSolver*> clones_;
+
+  /// solves the connected components of graph_ with SolveParts
+  double SolveComponents();
 };
 
 }  // namespace cyclus
@@ -3,6 +3,8 @@
 
 #include <sstream>
 
+#include <boost/make_shared.hpp>
+
 #include "bid.h"
 #include "bid_portfolio.h"
 #include "error.h"
@@ -41,7 +43,8 @@ class ExchangeTranslator {
 
   /// @brief translate the ExchangeContext into an ExchangeGraph
   ExchangeGraph::Ptr Translate() {
-    ExchangeGraph::Ptr graph(new ExchangeGraph());
+    ExchangeGraph::Ptr graph = boost::make_shared<ExchangeGraph>();
+    graph->arcs().reserve(ex_ctx_->arc_prefs.size());
 
     // add each request group
     const std::vector<typename RequestPortfolio<T>::Ptr>& requests =
@@ -58,18 +61,19 @@ class ExchangeTranslator {
 
     // add each bid group
     const std::vector<typename BidPortfolio<T>::Ptr>& bidports = ex_ctx_->bids;
-    typename std::vector<typename BidPortfolio<T>::Ptr>::const_iterator bp_it;
-    for (bp_it = bidports.begin(); bp_it != bidports.end(); ++bp_it) {
-      ExchangeNodeGroup::Ptr ns = TranslateBidPortfolio(xlation_ctx_, *bp_it);
+    for (int i = 0; i < bidports.size(); ++i) {
+      ExchangeNodeGroup::Ptr ns = TranslateBidPortfolio(xlation_ctx_,
+                                                        bidports[i]);
       graph->AddSupplyGroup(ns);
 
-      // add each request-bid arc
-      const std::set<Bid<T>*>& bids = (*bp_it)->bids();
-      typename std::set<Bid<T>*>::const_iterator b_it;
-      for (b_it = bids.begin(); b_it != bids.end(); ++b_it) {
+      // add each request-bid arc, whose preferences are stored in the same
+      // order as the portfolio's bids
+      int arc = ex_ctx_->bid_port_arcs[i];
+      const std::vector<Bid<T>*>& bids = bidports[i]->bids();
+      typename std::vector<Bid<T>*>::const_iterator b_it;
+      for (b_it = bids.begin(); b_it != bids.end(); ++b_it, ++arc) {
         Bid<T>* bid = *b_it;
-        Request<T>* req = bid->request();
-        AddArc(req, bid, graph);
+        AddArc(bid->request(), bid, ex_ctx_->arc_prefs[arc], graph);
       }
     }
 
@@ -79,8 +83,13 @@ class ExchangeTranslator {
   /// @brief adds a bid-request arc to a graph, if the preference for the arc is
   /// non-negative
   void AddArc(Request<T>* req, Bid<T>* bid, ExchangeGraph::Ptr graph) {
-    double pref =
-        ex_ctx_->trader_prefs.at(req->requester())[req][bid];
+    AddArc(req, bid, ex_ctx_->pref(bid), graph);
+  }
+
+  /// @brief adds a bid-request arc with the given preference to a graph, if
+  /// the preference is non-negative
+  void AddArc(Request<T>* req, Bid<T>* bid, double pref,
+              ExchangeGraph::Ptr graph) {
     // TODO: make the following check `pref <=0` and remove the `else if` block
     // before release 1.5
     if (pref < 0) {
@@ -151,7 +160,7 @@ template <class T>
 RequestGroup::Ptr TranslateRequestPortfolio(
     ExchangeTranslationContext<T>& translation_ctx,
     const typename RequestPortfolio<T>::Ptr rp) {
-  RequestGroup::Ptr rs(new RequestGroup(rp->qty()));
+  RequestGroup::Ptr rs = boost::make_shared<RequestGroup>(rp->qty());
   CLOG(LEV_DEBUG2) << "Translating request portfolio of size " << rp->qty();
 
   typename std::vector<Request<T>*>::const_iterator r_it;
@@ -159,11 +168,11 @@ RequestGroup::Ptr TranslateRequestPortfolio(
        r_it != rp->requests().end();
        ++r_it) {
     Request<T>* r = *r_it;
-    ExchangeNode::Ptr n(
-        new ExchangeNode(r->target()->quantity(),
-                         r->exclusive(),
-                         r->commodity(),
-                         r->requester()->manager()->id()));
+    ExchangeNode::Ptr n = boost::make_shared<ExchangeNode>(
+        r->target()->quantity(),
+        r->exclusive(),
+        r->commodity(),
+        r->requester()->manager()->id());
     rs->AddExchangeNode(n);
 
     AddRequest(translation_ctx, *r_it, n);
@@ -187,20 +196,20 @@ template <class T>
 ExchangeNodeGroup::Ptr TranslateBidPortfolio(
     ExchangeTranslationContext<T>& translation_ctx,
     const typename BidPortfolio<T>::Ptr bp) {
-  ExchangeNodeGroup::Ptr bs(new ExchangeNodeGroup());
+  ExchangeNodeGroup::Ptr bs = boost::make_shared<ExchangeNodeGroup>();
 
   std::map<typename T::Ptr, std::vector<ExchangeNode::Ptr> > excl_bid_grps;
 
-  typename std::set<Bid<T>*>::const_iterator b_it;
+  typename std::vector<Bid<T>*>::const_iterator b_it;
   for (b_it = bp->bids().begin();
        b_it != bp->bids().end();
        ++b_it) {
     Bid<T>* b = *b_it;
-    ExchangeNode::Ptr n(
-        new ExchangeNode(b->offer()->quantity(),
-                         b->exclusive(),
-                         b->request()->commodity(),
-                         b->bidder()->manager()->id()));
+    ExchangeNode::Ptr n = boost::make_shared<ExchangeNode>(
+        b->offer()->quantity(),
+        b->exclusive(),
+        b->request()->commodity(),
+        b->bidder()->manager()->id());
     bs->AddExchangeNode(n);
     AddBid(translation_ctx, *b_it, n);
     if (b->exclusive()) {
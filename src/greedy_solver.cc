@@ -38,25 +38,104 @@ GreedySolver::~GreedySolver() {
     delete conditioner_;
 }
 
+ExchangeSolver* GreedySolver::Clone() const {
+  GreedyPreconditioner* c = NULL;
+  if (conditioner_ != NULL)
+    c = new GreedyPreconditioner(*conditioner_);
+  return new GreedySolver(exclusive_orders_, c);
+}
+
 void GreedySolver::Condition() {
   if (conditioner_ != NULL)
     conditioner_->Condition(graph_);
 }
 
+/// orders arcs like ReqPrefComp, using CompactGraph arc indices
+struct CompactReqPrefComp {
+  explicit CompactReqPrefComp(const CompactGraph* cg) : cg(cg) {}
+
+  bool operator()(int l, int r) const {
+    double lpref = cg->req_pref(l);
+    double rpref = cg->req_pref(r);
+    if (lpref != rpref) {
+      return lpref > rpref;
+    }
+    int lu = cg->agent_id(cg->unode(l));
+    int lv = cg->agent_id(cg->vnode(l));
+    int ru = cg->agent_id(cg->unode(r));
+    int rv = cg->agent_id(cg->vnode(r));
+    return lu > ru || (lu == ru && lv > rv);
+  }
+
+  const CompactGraph* cg;
+};
+
+/// orders node indices like AvgPrefComp, using each node's average preference
+/// computed once
+struct IndexedAvgPrefComp {
+  IndexedAvgPrefComp(const std::vector<double>* prefs,
+                     const std::vector<int>* ids)
+      : prefs(prefs), ids(ids) {}
+
+  bool operator()(int l, int r) const {
+    double lpref = (*prefs)[l];
+    double rpref = (*prefs)[r];
+    return (lpref != rpref) ? (lpref > rpref) : ((*ids)[l] > (*ids)[r]);
+  }
+
+  const std::vector<double>* prefs;
+  const std::vector<int>* ids;
+};
+
+/// stable sorts nodes in the same order as AvgPrefComp
+static void SortByAvgPref(std::vector<ExchangeNode::Ptr>& nodes) {
+  std::vector<double> prefs(nodes.size());
+  std::vector<int> ids(nodes.size());
+  std::vector<int> order(nodes.size());
+  for (int i = 0; i < nodes.size(); ++i) {
+    prefs[i] = AvgPref(nodes[i]);
+    ids[i] = nodes[i]->agent_id;
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   IndexedAvgPrefComp(&prefs, &ids));
+
+  std::vector<ExchangeNode::Ptr> sorted(nodes.size());
+  for (int i = 0; i < order.size(); ++i) {
+    sorted[i] = nodes[order[i]];
+  }
+  nodes.swap(sorted);
+}
+
 void GreedySolver::Init() {
- std::for_each(graph_->request_groups().begin(),
-                graph_->request_groups().end(),
-                std::bind(
-                    &GreedySolver::GetCaps,
-                    this,
-                    std::placeholders::_1));
-
-  std::for_each(graph_->supply_groups().begin(),
-                graph_->supply_groups().end(),
-                std::bind(
-                    &GreedySolver::GetCaps,
-                    this,
-                    std::placeholders::_1));
+  std::vector<RequestGroup::Ptr>& rgs = graph_->request_groups();
+  for (int i = 0; i < rgs.size(); ++i) {
+    SortByAvgPref(rgs[i]->nodes());
+  }
+
+  // a snapshot given to the solver predates the orders set by Condition and
+  // the sorts above, so it is reordered in place rather than rebuilt
+  if (cg_ == NULL || cg_->graph() != graph_ || !cg_->Reorder()) {
+    cg_.reset(new CompactGraph(graph_));
+  }
+  n_qty_.assign(cg_->n_nodes(), 0);
+  grp_caps_ = cg_->caps();
+
+  // arcs are sorted here once rather than each time a node is visited
+  sorted_arcs_.resize(cg_->n_nodes() > 0 ? cg_->arcs_end(cg_->n_nodes() - 1) :
+                                           0);
+  for (int n = 0; n < cg_->n_nodes(); ++n) {
+    for (int i = cg_->arcs_begin(n); i != cg_->arcs_end(n); ++i) {
+      sorted_arcs_[i] = cg_->node_arc(i);
+    }
+  }
+  int n_req_nodes = cg_->n_request_groups() > 0 ?
+                    cg_->nodes_end(cg_->n_request_groups() - 1) : 0;
+  CompactReqPrefComp comp(cg_.get());
+  for (int n = 0; n < n_req_nodes; ++n) {
+    std::stable_sort(sorted_arcs_.begin() + cg_->arcs_begin(n),
+                     sorted_arcs_.begin() + cg_->arcs_end(n), comp);
+  }
 }
 
 double GreedySolver::SolveGraph() {
@@ -64,16 +143,12 @@ double GreedySolver::SolveGraph() {
   Condition();
   obj_ = 0;
   unmatched_ = 0;
-  n_qty_.clear();
 
   Init();
 
-  std::for_each(graph_->request_groups().begin(),
-                graph_->request_groups().end(),
-                std::bind(
-                    &GreedySolver::GreedilySatisfySet,
-                    this,
-                    std::placeholders::_1));
+  for (int g = 0; g < cg_->n_request_groups(); ++g) {
+    GreedilySatisfySet(g);
+  }
 
   obj_ += unmatched_ * pseudo_cost;
   return obj_;
@@ -84,12 +159,6 @@ double GreedySolver::Capacity(const Arc& a, double u_curr_qty,
   bool min = true;
   double ucap = Capacity(a.unode(), a, !min, u_curr_qty);
   double vcap = Capacity(a.vnode(), a, min, v_curr_qty);
-
-  CLOG(cyclus::LEV_DEBUG1) << "Capacity for unode of arc: " << ucap;
-  CLOG(cyclus::LEV_DEBUG1) << "Capacity for vnode of arc: " << vcap;
-  CLOG(cyclus::LEV_DEBUG1) << "Capacity for arc         : "
-                           << std::min(ucap, vcap);
-
   return std::min(ucap, vcap);
 }
 
@@ -99,18 +168,41 @@ double GreedySolver::Capacity(ExchangeNode::Ptr n, const Arc& a, bool min_cap,
     throw cyclus::StateError("An notion of node capacity requires a nodegroup.");
   }
 
-  if (n->unit_capacities[a].size() == 0) {
-    return n->qty - curr_qty;
+  const std::vector<double>& unit_caps = n->unit_capacities[a];
+  return NodeCapacity(cg_->node_index(n.get()), unit_caps.data(),
+                      unit_caps.size(), min_cap, curr_qty);
+}
+
+double GreedySolver::ArcCapacity(int a, double u_curr_qty,
+                                 double v_curr_qty) {
+  bool min = true;
+  double ucap = NodeCapacity(cg_->unode(a), cg_->ucaps(a), cg_->n_ucaps(a),
+                             !min, u_curr_qty);
+  double vcap = NodeCapacity(cg_->vnode(a), cg_->vcaps(a), cg_->n_vcaps(a),
+                             min, v_curr_qty);
+
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for unode of arc: " << ucap;
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for vnode of arc: " << vcap;
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for arc         : "
+                           << std::min(ucap, vcap);
+
+  return std::min(ucap, vcap);
+}
+
+double GreedySolver::NodeCapacity(int n, const double* ucaps, int n_ucaps,
+                                  bool min_cap, double curr_qty) {
+  if (n_ucaps == 0) {
+    return cg_->qty(n) - curr_qty;
   }
 
-  std::vector<double>& unit_caps = n->unit_capacities[a];
-  const std::vector<double>& group_caps = grp_caps_[n->group];
-  std::vector<double> caps;
+  const double* group_caps =
+      grp_caps_.data() + cg_->caps_begin(cg_->node_group(n));
   double grp_cap, u_cap, cap;
+  double best = 0;
 
-  for (int i = 0; i < unit_caps.size(); i++) {
+  for (int i = 0; i < n_ucaps; i++) {
     grp_cap = group_caps[i];
-    u_cap = unit_caps[i];
+    u_cap = ucaps[i];
     cap = grp_cap / u_cap;
     CLOG(cyclus::LEV_DEBUG1) << "Capacity for node: ";
     CLOG(cyclus::LEV_DEBUG1) << "   group capacity: " << grp_cap;
@@ -119,92 +211,76 @@ double GreedySolver::Capacity(ExchangeNode::Ptr n, const Arc& a, bool min_cap,
 
     // special case for unlimited capacities
     if (grp_cap == std::numeric_limits<double>::max()) {
-      caps.push_back(std::numeric_limits<double>::max());
-    } else {
-      caps.push_back(cap);
+      cap = std::numeric_limits<double>::max();
     }
-  }
-
-  if (min_cap) {  // the smallest value is constraining (for bids)
-    cap = *std::min_element(caps.begin(), caps.end());
-  } else {  // the largest value must be met (for requests)
-    cap = *std::max_element(caps.begin(), caps.end());
-  }
-  return std::min(cap, n->qty - curr_qty);
-}
 
-void GreedySolver::GetCaps(ExchangeNodeGroup::Ptr g) {
-  for (int i = 0; i != g->nodes().size(); i++) {
-    n_qty_[g->nodes()[i]] = 0;
+    if (i == 0) {
+      best = cap;
+    } else if (min_cap) {  // the smallest value is constraining (for bids)
+      best = cap < best ? cap : best;
+    } else {  // the largest value must be met (for requests)
+      best = best < cap ? cap : best;
+    }
   }
-  grp_caps_[g.get()] = g->capacities();
+  return std::min(best, cg_->qty(n) - curr_qty);
 }
 
-void GreedySolver::GreedilySatisfySet(RequestGroup::Ptr prs) {
-  std::vector<ExchangeNode::Ptr>& nodes = prs->nodes();
-  std::stable_sort(nodes.begin(), nodes.end(), AvgPrefComp);
-
-  std::vector<ExchangeNode::Ptr>::iterator req_it = nodes.begin();
-  double target = prs->qty();
+void GreedySolver::GreedilySatisfySet(int g) {
+  // nodes and their arcs were put in matching order by Init()
+  int n = cg_->nodes_begin(g);
+  int n_end = cg_->nodes_end(g);
+  double target = cg_->request_qty(g);
   double match = 0;
 
-  ExchangeNode::Ptr u, v;
-  std::vector<Arc>::const_iterator arc_it;
-  std::vector<Arc> sorted;
+  int u, v, a, i, i_end;
   double remain, tomatch, excl_val;
 
   CLOG(LEV_DEBUG1) << "Greedy Solving for " << target
                    << " amount of a resource.";
 
-  while ((match <= target) && (req_it != nodes.end())) {
-    // this if statement is needed because map.at() will throw if the key does
-    // not exist, which is a corner case for when there is a request with no bid
-    // arcs associated with it
-    if (graph_->node_arc_map().count(*req_it) > 0) {
-      const std::vector<Arc>& arcs = graph_->node_arc_map().at(*req_it);
-      sorted = std::vector<Arc>(arcs);  // make a copy for now
-      std::stable_sort(sorted.begin(), sorted.end(), ReqPrefComp);
-      arc_it = sorted.begin();
-
-      while ((match <= target) && (arc_it != sorted.end())) {
-        remain = target - match;
-        const Arc& a = *arc_it;
-        u = a.unode();
-        v = a.vnode();
-        // capacity adjustment
-        tomatch = std::min(remain, Capacity(a, n_qty_[u], n_qty_[v]));
-
-        // exclusivity adjustment
-        if (arc_it->exclusive()) {
-          excl_val = a.excl_val();
-
-          // this careful float comparison is vital for preventing false positive
-          // constraint violations w.r.t. exclusivity-related capacity.
-          double dist = boost::math::float_distance(tomatch, excl_val);
-          if (dist >= float_ulp_eq ) {
-            tomatch = 0;
-          } else {
-            tomatch = excl_val;
-          }
-        }
-
-        if (tomatch > eps()) {
-          CLOG(LEV_DEBUG1) << "Greedy Solver is matching " << tomatch
-                           << " amount of a resource.";
-          UpdateCapacity(u, a, tomatch);
-          UpdateCapacity(v, a, tomatch);
-          n_qty_[u] += tomatch;
-          n_qty_[v] += tomatch;
-          graph_->AddMatch(a, tomatch);
-
-          match += tomatch;
-          UpdateObj(tomatch, u->prefs[a]);
+  while ((match <= target) && (n != n_end)) {
+    // a request with no bid arcs simply has an empty range of arcs
+    i = cg_->arcs_begin(n);
+    i_end = cg_->arcs_end(n);
+
+    while ((match <= target) && (i != i_end)) {
+      remain = target - match;
+      a = sorted_arcs_[i];
+      u = cg_->unode(a);
+      v = cg_->vnode(a);
+      // capacity adjustment
+      tomatch = std::min(remain, ArcCapacity(a, n_qty_[u], n_qty_[v]));
+
+      // exclusivity adjustment
+      if (cg_->exclusive(a)) {
+        excl_val = cg_->excl_val(a);
+
+        // this careful float comparison is vital for preventing false positive
+        // constraint violations w.r.t. exclusivity-related capacity.
+        double dist = boost::math::float_distance(tomatch, excl_val);
+        if (dist >= float_ulp_eq ) {
+          tomatch = 0;
+        } else {
+          tomatch = excl_val;
         }
-        ++arc_it;
-      }  // while( (match =< target) && (arc_it != arcs.end()) )
-    }  // if(graph_->node_arc_map().count(*req_it) > 0)
-    ++req_it;
-  }  // while( (match =< target) && (req_it != nodes.end()) )
+      }
+
+      if (tomatch > eps()) {
+        CLOG(LEV_DEBUG1) << "Greedy Solver is matching " << tomatch
+                         << " amount of a resource.";
+        UpdateCapacity(u, cg_->ucaps(a), cg_->n_ucaps(a), tomatch);
+        UpdateCapacity(v, cg_->vcaps(a), cg_->n_vcaps(a), tomatch);
+        n_qty_[u] += tomatch;
+        n_qty_[v] += tomatch;
+        graph_->AddMatch(cg_->arc(a), tomatch);
+
+        match += tomatch;
+        UpdateObj(tomatch, cg_->req_pref(a));
+      }
+      ++i;
+    }  // while( (match =< target) && (i != i_end) )
+    ++n;
+  }  // while( (match =< target) && (n != n_end) )
 
   unmatched_ += target - match;
 }
@@ -215,30 +291,30 @@ void GreedySolver::UpdateObj(double qty, double pref) {
   obj_ += qty / pref;
 }
 
-void GreedySolver::UpdateCapacity(ExchangeNode::Ptr n, const Arc& a,
+void GreedySolver::UpdateCapacity(int n, const double* ucaps, int n_ucaps,
                                   double qty) {
   using cyclus::IsNegative;
   using cyclus::ValueError;
 
-  std::vector<double>& unit_caps = n->unit_capacities[a];
-  std::vector<double>& caps = grp_caps_[n->group];
-  assert(unit_caps.size() == caps.size());
-  for (int i = 0; i < caps.size(); i++) {
+  int g = cg_->node_group(n);
+  double* caps = grp_caps_.data() + cg_->caps_begin(g);
+  assert(n_ucaps == cg_->caps_end(g) - cg_->caps_begin(g));
+  for (int i = 0; i < n_ucaps; i++) {
     double prev = caps[i];
     // special case for unlimited capacities
     CLOG(cyclus::LEV_DEBUG1) << "Updating capacity value from: "
                              << prev;
     caps[i] = (prev == std::numeric_limits<double>::max()) ?
               std::numeric_limits<double>::max() :
-              prev - qty * unit_caps[i];
+              prev - qty * ucaps[i];
     CLOG(cyclus::LEV_DEBUG1) << "                          to: "
                              << caps[i];
   }
 
-  if (IsNegative(n->qty - qty)) {
+  if (IsNegative(cg_->qty(n) - qty)) {
     std::stringstream ss;
-    ss << "A bid for " << n->commod << " was set at " << n->qty
-       << " but has been matched to a higher value " << qty
+    ss << "A bid for " << cg_->node(n)->commod << " was set at "
+       << cg_->qty(n) << " but has been matched to a higher value " << qty
        << ". This could be due to a problem with your "
        << "bid portfolio constraints.";
     throw ValueError(ss.str());
@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_GREEDY_SOLVER_H_
 
 #include <boost/shared_ptr.hpp>
+#include "compact_graph.h"
 #include "exchange_graph.h"
 #include "exchange_solver.h"
 #include "greedy_preconditioner.h"
@@ -77,6 +78,10 @@ class GreedySolver: public ExchangeSolver {
 
   virtual ~GreedySolver();
 
+  /// @brief returns a new GreedySolver with the same exclusivity setting and
+  /// a copy of this solver's conditioner
+  virtual ExchangeSolver* Clone() const;
+
   /// Uses the provided (or a default) GreedyPreconditioner to condition the
   /// solver's ExchangeGraph so that RequestGroups are ordered by average
   /// preference and commodity weight.
@@ -85,7 +90,13 @@ class GreedySolver: public ExchangeSolver {
   /// likely not be called independently thereof (except for testing)
   void Condition();
 
-  /// Initialize member values based on the given graph.
+  /// Initialize member values based on the given graph. This orders the nodes
+  /// of each RequestGroup by average preference, takes a CompactGraph
+  /// snapshot of the graph, and orders each request node's arcs by
+  /// preference, so it must be called again if the graph changes. The
+  /// snapshot the solver holds for the graph, e.g., one given to it for the
+  /// solve, is reordered rather than rebuilt unless groups, nodes, or arcs
+  /// were added; it does not pick up changed values, which need a new Solve.
   void Init();
 
   /// @brief the capacity of the arc
@@ -134,22 +145,35 @@ class GreedySolver: public ExchangeSolver {
   virtual double SolveGraph();
 
  private:
+  /// @brief index-based versions of the Capacity member functions, where n
+  /// and a are CompactGraph node and arc indices and ucaps are n's unit
+  /// capacities for the arc
+  /// @{
+  double ArcCapacity(int a, double u_curr_qty, double v_curr_qty);
+  double NodeCapacity(int n, const double* ucaps, int n_ucaps, bool min_cap,
+                      double curr_qty);
+  /// @}
+
   /// @brief updates the capacity of a given ExchangeNode (i.e., its max_qty and the
   /// capacities of its ExchangeNodeGroup)
   ///
-  /// @throws StateError if ExchangeNode does not have a ExchangeNodeGroup
   /// @throws ValueError if the update results in a negative ExchangeNodeGroup
   /// capacity or a negative ExchangeNode max_qty
-  /// @param n the ExchangeNode
+  /// @param n the CompactGraph index of the ExchangeNode
+  /// @param ucaps the node's unit capacities for the matched arc
   /// @param qty the quantity for the node to update
-  void GetCaps(ExchangeNodeGroup::Ptr prs);
-  void GreedilySatisfySet(RequestGroup::Ptr prs);
-  void UpdateCapacity(ExchangeNode::Ptr n, const Arc& a, double qty);
+  void UpdateCapacity(int n, const double* ucaps, int n_ucaps, double qty);
+  void GreedilySatisfySet(int g);
   void UpdateObj(double qty, double pref);
 
   GreedyPreconditioner* conditioner_;
-  std::map<ExchangeNode::Ptr, double> n_qty_;
-  std::map<ExchangeNodeGroup*, std::vector<double> > grp_caps_;
+  /// each request node's arcs in the order they are matched, laid out like
+  /// the CompactGraph's node arcs
+  std::vector<int> sorted_arcs_;
+  /// quantity matched so far, by CompactGraph node index
+  std::vector<double> n_qty_;
+  /// remaining group capacities, laid out like CompactGraph::caps()
+  std::vector<double> grp_caps_;
   double obj_;
   double unmatched_;
 };
@@ -0,0 +1,185 @@
+#include "hybrid_solver.h"
+
+#include <chrono>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "compact_graph.h"
+#include "context.h"
+#include "error.h"
+#include "exchange_graph.h"
+#include "greedy_solver.h"
+#include "logger.h"
+#include "network_solver.h"
+#include "platform.h"
+#if CYCLUS_HAS_COIN
+#include "prog_solver.h"
+#endif
+
+namespace cyclus {
+
+HybridSolver::HybridSolver(bool exclusive_orders, double budget)
+    : budget_(budget),
+      gap_(0),
+      greedy_obj_(0),
+      component_(false),
+      merged_greedy_obj_(0),
+      ExchangeSolver(exclusive_orders) {}
+
+ExchangeSolver* HybridSolver::Clone() const {
+  HybridSolver* s = new HybridSolver(exclusive_orders_, budget_);
+  s->component_ = component_;
+  s->deadline_ = deadline_;
+  return s;
+}
+
+double HybridSolver::Objective(double pseudo_cost) {
+  double obj = 0;
+  std::map<ExchangeNodeGroup*, double> matched;
+  const std::vector<Match>& matches = graph_->matches();
+  for (int i = 0; i != matches.size(); i++) {
+    const Arc& a = matches[i].first;
+    obj += matches[i].second / a.pref();
+    matched[a.unode()->group] += matches[i].second;
+  }
+
+  std::vector<RequestGroup::Ptr>& rgs = graph_->request_groups();
+  for (int i = 0; i != rgs.size(); i++) {
+    double unmet = rgs[i]->qty() - matched[rgs[i].get()];
+    if (unmet > 0) {
+      obj += unmet * pseudo_cost;
+    }
+  }
+  return obj;
+}
+
+std::string HybridSolver::SolveExact(double tmax) {
+  try {
+    if (NetworkSolver::IsNetwork(*Compact(), exclusive_orders_)) {
+      NetworkSolver solver(exclusive_orders_);
+      solver.pseudo_cost(PseudoCost());
+      solver.compact_graph(cg_);
+      solver.Solve(graph_);
+      return "network";
+    }
+#if CYCLUS_HAS_COIN
+    bool verbose = false;
+    bool mps = false;
+    ProgSolver solver("cbc", tmax, exclusive_orders_, verbose, mps);
+    solver.sim_ctx(sim_ctx_);
+    solver.pseudo_cost(PseudoCost());
+    solver.compact_graph(cg_);
+    solver.Solve(graph_);
+    return "coin-or";
+#endif
+  } catch (Error& e) {
+    CLOG(LEV_DEBUG1) << "Hybrid solver could not improve on the greedy "
+                     << "solution: " << e.what();
+  }
+  return "";
+}
+
+double HybridSolver::SolveGraph() {
+  Clock::time_point start = Clock::now();
+  if (!component_) {
+    deadline_ = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(budget_));
+  }
+  double pseudo_cost = PseudoCost();  // from ExchangeSolver API
+
+  GreedySolver greedy(exclusive_orders_);
+  greedy.pseudo_cost(pseudo_cost);
+  greedy.Solve(graph_);
+  // the exact solvers reuse the snapshot of the graph taken by the greedy
+  // solver after it ordered the graph's nodes
+  cg_ = greedy.compact_graph();
+  double greedy_obj = Objective(pseudo_cost);
+  double obj = greedy_obj;
+  path_ = "greedy";
+
+  greedy_obj_ = greedy_obj;
+  double remain =
+      std::chrono::duration<double>(deadline_ - Clock::now()).count();
+  if (remain > 0 && !graph_->arcs().empty()) {
+    std::vector<Match> best = graph_->matches();
+    graph_->ClearMatches();
+    std::string path = SolveExact(remain);
+    double exact_obj = path.empty() ? std::numeric_limits<double>::max() :
+                                      Objective(pseudo_cost);
+    if (exact_obj < obj) {
+      obj = exact_obj;
+      path_ = path;
+    } else {
+      graph_->ClearMatches();
+      for (int i = 0; i != best.size(); i++) {
+        graph_->AddMatch(best[i].first, best[i].second);
+      }
+    }
+  }
+
+  gap_ = greedy_obj > 0 ? (greedy_obj - obj) / greedy_obj : 0;
+  if (!component_) {
+    Record(obj, greedy_obj, start);
+  }
+  return obj;
+}
+
+std::vector<double> HybridSolver::SolveParts(
+    const std::vector<ExchangeGraph::Ptr>& parts) {
+  Clock::time_point start = Clock::now();
+  deadline_ = start + std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(budget_));
+  component_ = true;
+  merged_greedy_obj_ = 0;
+  merged_paths_.clear();
+  std::vector<double> objs;
+  try {
+    objs = ExchangeSolver::SolveParts(parts);
+  } catch (...) {
+    component_ = false;
+    throw;
+  }
+  component_ = false;
+
+  double obj = 0;
+  for (int i = 0; i < objs.size(); ++i) {
+    obj += objs[i];
+  }
+  if (!merged_paths_.empty()) {
+    greedy_obj_ = merged_greedy_obj_;
+    path_.clear();
+    std::set<std::string>::iterator it;
+    for (it = merged_paths_.begin(); it != merged_paths_.end(); ++it) {
+      path_ += (path_.empty() ? "" : "+") + *it;
+    }
+  }
+  gap_ = greedy_obj_ > 0 ? (greedy_obj_ - obj) / greedy_obj_ : 0;
+  Record(obj, greedy_obj_, start);
+  return objs;
+}
+
+void HybridSolver::MergeComponent(const ExchangeSolver* s) {
+  const HybridSolver* h = static_cast<const HybridSolver*>(s);
+  merged_greedy_obj_ += h->greedy_obj_;
+  merged_paths_.insert(h->path_);
+}
+
+void HybridSolver::Record(double obj, double greedy_obj,
+                          Clock::time_point start) {
+  if (sim_ctx_ == NULL) {
+    return;
+  }
+  sim_ctx_->NewDatum("HybridSolutions")
+      ->AddVal("Time", sim_ctx_->time())
+      ->AddVal("Path", path_)
+      ->AddVal("Objective", obj)
+      ->AddVal("GreedyObjective", greedy_obj)
+      ->AddVal("Gap", gap_)
+      ->AddVal("Seconds",
+               std::chrono::duration<double>(Clock::now() - start).count())
+      ->Record();
+}
+
+}  // namespace cyclus
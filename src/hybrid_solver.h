@@ -0,0 +1,98 @@
+#ifndef CYCLUS_SRC_HYBRID_SOLVER_H_
+#define CYCLUS_SRC_HYBRID_SOLVER_H_
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "exchange_solver.h"
+
+namespace cyclus {
+
+class ExchangeGraph;
+
+/// @class HybridSolver
+///
+/// @brief The HybridSolver is an anytime solver with a wall-clock budget per
+/// exchange. It always starts from the GreedySolver's solution and then, if
+/// time remains, tries to improve it with an exact solver: the NetworkSolver
+/// if the exchange is a network, otherwise a ProgSolver limited to the rest
+/// of the budget (when Cyclus is built with COIN). The best solution found is
+/// kept, so a slow or failed improvement never costs more than the greedy
+/// solution.
+///
+/// When the exchange is decomposed, its components share the one budget: each
+/// component may improve on its greedy solution until the exchange's deadline.
+///
+/// Solutions are compared by the greedy objective, i.e., the cost of each
+/// match plus the pseudo cost of each request group's unmet quantity. If a
+/// simulation context is set, every exchange is recorded in the
+/// HybridSolutions table along with the path that won and its gap to the
+/// greedy solution.
+class HybridSolver: public ExchangeSolver {
+ public:
+  static const int kDefaultBudget = 60;  // s
+
+  /// @param exclusive_orders whether all orders must be exclusive or not
+  /// @param budget the wall-clock time allowed per exchange in seconds
+  explicit HybridSolver(bool exclusive_orders = kDefaultExclusive,
+                        double budget = kDefaultBudget);
+  virtual ~HybridSolver() {}
+
+  /// @return a solver with the same budget that solves a component of the
+  /// exchange being solved by this one, i.e., with its deadline
+  virtual ExchangeSolver* Clone() const;
+
+  inline double budget() const { return budget_; }
+
+  /// @return the solver that found the last solution: "greedy", "network",
+  /// or "coin-or". If the components of a decomposed exchange were solved
+  /// by different solvers, their names are joined by "+" in sorted order.
+  inline const std::string& path() const { return path_; }
+
+  /// @return the last solution's relative improvement on the greedy
+  /// objective, i.e., (greedy - best) / greedy
+  inline double gap() const { return gap_; }
+
+ protected:
+  /// @brief the HybridSolver solves an ExchangeGraph...
+  virtual double SolveGraph();
+
+  /// solves the parts until one deadline and records them as one exchange
+  virtual std::vector<double> SolveParts(
+      const std::vector<boost::shared_ptr<ExchangeGraph> >& parts);
+
+  /// adds a solved component's greedy objective and path to the exchange's
+  virtual void MergeComponent(const ExchangeSolver* s);
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  /// @return the greedy objective of the graph's current matches
+  double Objective(double pseudo_cost);
+
+  /// @return the name of the exact solver used, or an empty string if the
+  /// graph could not be solved exactly
+  std::string SolveExact(double tmax);
+
+  /// records a solved exchange in the HybridSolutions table
+  void Record(double obj, double greedy_obj, Clock::time_point start);
+
+  double budget_;
+  std::string path_;
+  double gap_;
+  double greedy_obj_;
+
+  /// whether graph_ is a component of the exchange being solved
+  bool component_;
+  Clock::time_point deadline_;
+
+  /// the greedy objectives and paths of the components solved so far
+  double merged_greedy_obj_;
+  std::set<std::string> merged_paths_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_HYBRID_SOLVER_H_
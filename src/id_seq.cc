@@ -0,0 +1,132 @@
+#include "id_seq.h"
+
+#include "error.h"
+
+namespace cyclus {
+
+const int IdBlocks::kDefaultBlock;
+
+thread_local std::pair<IdBlocks*, int> IdBlocks::current_(NULL, 0);
+
+std::vector<IdSeq*>& IdSeq::All() {
+  static std::vector<IdSeq*> all;
+  return all;
+}
+
+IdSeq::IdSeq(int key, int first) : next_(first), key_(key) {
+  std::vector<IdSeq*>& all = All();
+  if (key < 0) {
+    throw ValueError("IdSeq keys must not be negative.");
+  }
+  if (key >= all.size()) {
+    all.resize(key + 1, NULL);
+  }
+  if (all[key] != NULL) {
+    throw ValueError("Two IdSeqs cannot share a key.");
+  }
+  all[key] = this;
+}
+
+int IdSeq::Next() {
+  if (IdBlocks::current_.first != NULL) {
+    return IdBlocks::current_.first->Next(IdBlocks::current_.second, this);
+  }
+  return next_++;
+}
+
+IdBlocks::IdBlocks(const std::vector<int>& keys, IdHints* hints)
+    : keys_(keys),
+      hints_(hints),
+      tasks_(keys.size()),
+      done_(keys.size(), false),
+      ndone_(0) {
+  const std::vector<IdSeq*>& seqs = IdSeq::All();
+  for (int i = 0; i < tasks_.size(); ++i) {
+    Task& t = tasks_[i];
+    t.next.resize(seqs.size());
+    t.end.resize(seqs.size());
+    t.used.resize(seqs.size(), 0);
+    t.first = i == 0;
+
+    IdCounts hint;
+    if (hints_ != NULL) {
+      IdHints::const_iterator it = hints_->find(keys_[i]);
+      if (it != hints_->end()) {
+        hint = it->second;
+      } else {
+        hint.assign(seqs.size(), kDefaultBlock);
+      }
+    }
+    hint.resize(seqs.size(), 0);
+    for (int k = 0; k < seqs.size(); ++k) {
+      if (seqs[k] == NULL) {
+        continue;
+      }
+      t.next[k] = seqs[k]->next_.fetch_add(hint[k]);
+      t.end[k] = t.next[k] + hint[k];
+    }
+  }
+}
+
+IdBlocks::~IdBlocks() {
+  if (hints_ == NULL) {
+    return;
+  }
+  for (int i = 0; i < tasks_.size(); ++i) {
+    (*hints_)[keys_[i]] = tasks_[i].used;
+  }
+}
+
+void IdBlocks::Run(int i, const std::function<void()>& f) {
+  std::pair<IdBlocks*, int> prev = current_;
+  current_ = std::make_pair(this, i);
+  try {
+    f();
+  } catch (...) {
+    current_ = prev;
+    Done(i);
+    throw;
+  }
+  current_ = prev;
+  Done(i);
+}
+
+int IdBlocks::Next(int i, IdSeq* seq) {
+  Task& t = tasks_[i];
+  int k = seq->key_;
+  t.used[k]++;
+  if (t.next[k] < t.end[k]) {
+    return t.next[k]++;
+  }
+
+  WaitTurn(i);
+  return seq->next_++;
+}
+
+void IdBlocks::WaitTurn() {
+  if (current_.first != NULL) {
+    current_.first->WaitTurn(current_.second);
+  }
+}
+
+void IdBlocks::WaitTurn(int i) {
+  Task& t = tasks_[i];
+  if (!t.first) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_.wait(lk, [this, i] { return ndone_ >= i; });
+    t.first = true;
+  }
+}
+
+void IdBlocks::Done(int i) {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    done_[i] = true;
+    while (ndone_ < done_.size() && done_[ndone_]) {
+      ndone_++;
+    }
+  }
+  cv_.notify_all();
+}
+
+}  // namespace cyclus
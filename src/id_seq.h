@@ -0,0 +1,172 @@
+#ifndef CYCLUS_SRC_ID_SEQ_H_
+#define CYCLUS_SRC_ID_SEQ_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cyclus {
+
+class IdBlocks;
+
+/// @class IdSeq
+///
+/// @brief An IdSeq hands out the unique, increasing ids of one kind of
+/// simulation object (e.g. resource states or compositions). Ids are normally
+/// taken from a single shared counter. While a task of an IdBlocks batch runs
+/// on the calling thread, they are taken from that task's blocks instead (see
+/// IdBlocks), so that they do not depend on how tasks are scheduled.
+///
+/// The counter can be used like an integer one, i.e. seq++ returns the next
+/// id and seq = n sets the next id handed out outside of batches.
+///
+/// Every IdSeq has a unique key that indexes the per-task id counts of
+/// IdBlocks (see IdCounts). Keys are given explicitly rather than taken from
+/// the order in which sequences are constructed, which for global sequences
+/// depends on the order their translation units are initialized in.
+class IdSeq {
+ public:
+  /// the keys of the sequences of the core; sequences defined elsewhere
+  /// (e.g. in tests) use keys from kFirstFreeKey on
+  enum Key {
+    kResourceStates = 0,
+    kResourceObjs,
+    kCompositions,
+    kFirstFreeKey
+  };
+
+  /// @throws ValueError if key is negative or already used by another IdSeq
+  IdSeq(int key, int first);
+
+  /// Returns the next id.
+  int Next();
+
+  inline int operator++(int) { return Next(); }
+
+  /// Sets the next id handed out outside of batches, e.g. on restart.
+  inline IdSeq& operator=(int next) {
+    next_ = next;
+    return *this;
+  }
+
+  /// Returns the next id handed out outside of batches.
+  inline int load() const { return next_; }
+  inline operator int() const { return next_; }
+
+ private:
+  friend class IdBlocks;
+
+  // IdSeqs are global counters and cannot be copied
+  IdSeq(const IdSeq&) = delete;
+  IdSeq& operator=(const IdSeq&) = delete;
+
+  /// Returns every IdSeq indexed by its key, with NULL for unused keys.
+  static std::vector<IdSeq*>& All();
+
+  std::atomic<int> next_;
+
+  int key_;
+};
+
+/// The number of ids a task drew from each IdSeq, indexed by IdSeq key.
+typedef std::vector<int> IdCounts;
+
+/// The ids drawn by each task of a previous batch, keyed by task key.
+typedef std::map<int, IdCounts> IdHints;
+
+/// @class IdBlocks
+///
+/// @brief IdBlocks makes the ids minted by a batch of tasks that may run
+/// concurrently (e.g. thread safe time listeners) depend only on the order of
+/// the tasks and on what they do, not on the number of threads or on how the
+/// tasks are scheduled:
+///
+/// - Before the batch runs, every task is given a block of consecutive ids
+///   from every IdSeq, in task order, sized by the number of ids the task
+///   with the same key used in its previous batch.
+/// - A task that uses up one of its blocks waits until every task before it
+///   has finished and then draws further ids directly from the shared
+///   counters. Tasks after it that run out wait for it in turn.
+///
+/// Ids left over in a block are never used, so the ids of a simulation have
+/// gaps wherever a task minted fewer objects than in its previous batch. A
+/// task whose key has no hint yet gets blocks of kDefaultBlock ids, so that
+/// the first batch does not run one task after another. Batches are used for
+/// thread safe time listeners only when the simulation has more than one
+/// thread, and for re-entrant traders when parallel_exchange is set (see
+/// SimInfo), both of which are recorded in the output. The tasks must be started in index
+/// order (as ThreadPool::ParallelFor does) so that waiting tasks cannot
+/// deadlock.
+class IdBlocks {
+ public:
+  /// the number of ids from each IdSeq reserved for a task whose key has no
+  /// hint
+  static const int kDefaultBlock = 16;
+
+  /// @param keys the key of each task (e.g. an agent id), in task order
+  /// @param hints the ids used by tasks of previous batches. If not NULL, it
+  /// is updated with the ids used by this batch when the batch is destroyed.
+  /// If NULL, no ids are reserved and tasks draw them one after another.
+  IdBlocks(const std::vector<int>& keys, IdHints* hints);
+
+  ~IdBlocks();
+
+  /// Runs f as task i on the calling thread.
+  void Run(int i, const std::function<void()>& f);
+
+  /// If the calling thread runs a task of a batch, waits until every earlier
+  /// task of the batch has finished. Shared state that is not handed out
+  /// through an IdSeq (e.g. Product QualIds) can then be assigned in task
+  /// order. Must not be called while holding a lock that earlier tasks may
+  /// need.
+  static void WaitTurn();
+
+ private:
+  struct Task {
+    /// the next and one past the last id of the block of each sequence
+    std::vector<int> next;
+    std::vector<int> end;
+
+    IdCounts used;
+
+    /// true once all earlier tasks have finished
+    bool first;
+  };
+
+  // batches hand out ids and cannot be copied
+  IdBlocks(const IdBlocks&) = delete;
+  IdBlocks& operator=(const IdBlocks&) = delete;
+
+  /// returns the next id of seq for task i
+  int Next(int i, IdSeq* seq);
+
+  /// waits until every task before task i has finished
+  void WaitTurn(int i);
+
+  /// marks task i as finished
+  void Done(int i);
+
+  std::vector<int> keys_;
+  IdHints* hints_;
+  std::vector<Task> tasks_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::vector<bool> done_;
+
+  /// the number of leading tasks that have all finished
+  int ndone_;
+
+  /// the batch and task running on this thread, if any
+  static thread_local std::pair<IdBlocks*, int> current_;
+
+  friend class IdSeq;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ID_SEQ_H_
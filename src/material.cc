@@ -1,6 +1,9 @@
 #include "material.h"
 
 #include <math.h>
+#include <map>
+#include <set>
+#include <utility>
 
 #include "comp_math.h"
 #include "context.h"
@@ -77,13 +80,16 @@ Material::Ptr Material::ExtractComp(double qty, Composition::Ptr c,
 
   // TODO: decide if ExtractComp should force lazy-decay by calling comp()
   if (comp_ != c) {
-    CompMap v(comp_->mass());
+    NucVec v(comp_->mass_vec());
     compmath::Normalize(&v, qty_);
-    CompMap otherv(c->mass());
+    NucVec otherv(c->mass_vec());
     compmath::Normalize(&otherv, qty);
-    CompMap newv = compmath::Sub(v, otherv);
+    NucVec newv = compmath::Sub(v, otherv);
     compmath::ApplyThreshold(&newv, threshold);
     comp_ = Composition::CreateFromMass(newv);
+    if (ctx_ != NULL) {
+      comp_ = ctx_->InternComp(comp_);
+    }
   }
 
   qty_ -= qty;
@@ -104,11 +110,14 @@ void Material::Absorb(Material::Ptr mat) {
   Composition::Ptr c1 = mat->comp();
 
   if (c0 != c1) {
-    CompMap v(c0->mass());
+    NucVec v(c0->mass_vec());
     compmath::Normalize(&v, qty_);
-    CompMap otherv(c1->mass());
+    NucVec otherv(c1->mass_vec());
     compmath::Normalize(&otherv, mat->qty_);
     comp_ = Composition::CreateFromMass(compmath::Add(v, otherv));
+    if (ctx_ != NULL) {
+      comp_ = ctx_->InternComp(comp_);
+    }
   }
 
   // Set the decay time to the value of the material that had the larger
@@ -184,55 +193,92 @@ void Material::ChangePackage(std::string new_package_name) {
 }
 
 void Material::Decay(int curr_time) {
-  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+  uint64_t secs_per_timestep;
+  int dt = PendingDecay(&curr_time, &secs_per_timestep);
+  if (dt == 0) {
     return;
-  } else if (curr_time < 0 && ctx_ == NULL) {
+  }
+
+  prev_decay_time_ = curr_time; // this must go before Transmute call
+  DecayOperators* ops = ctx_ == NULL ? NULL : ctx_->decay_ops();
+  Composition::Ptr decayed = comp_->Decay(dt, secs_per_timestep, ops);
+  Transmute(decayed);
+}
+
+void Material::DecayAll(const std::vector<Ptr>& mats, int curr_time) {
+  // materials to decay, grouped by decay interval
+  std::map<std::pair<int, uint64_t>, std::vector<Material*> > groups;
+  std::set<Material*> seen;
+  for (int i = 0; i < mats.size(); ++i) {
+    Material* m = mats[i].get();
+    if (!seen.insert(m).second) {
+      continue;
+    }
+    int t = curr_time;
+    uint64_t secs_per_timestep;
+    int dt = m->PendingDecay(&t, &secs_per_timestep);
+    if (dt == 0) {
+      continue;
+    }
+    m->prev_decay_time_ = t; // this must go before Transmute call
+    groups[std::make_pair(dt, secs_per_timestep)].push_back(m);
+  }
+
+  std::map<std::pair<int, uint64_t>, std::vector<Material*> >::iterator it;
+  for (it = groups.begin(); it != groups.end(); ++it) {
+    std::vector<Material*>& ms = it->second;
+    std::vector<Composition::Ptr> comps(ms.size());
+    for (int i = 0; i < ms.size(); ++i) {
+      comps[i] = ms[i]->comp_;
+    }
+    Context* ctx = ms[0]->ctx_;
+    comps = Composition::DecayAll(comps, it->first.first, it->first.second,
+                                  ctx == NULL ? NULL : ctx->decay_ops());
+    for (int i = 0; i < ms.size(); ++i) {
+      ms[i]->Transmute(comps[i]);
+    }
+  }
+}
+
+int Material::PendingDecay(int* curr_time, uint64_t* secs_per_timestep) {
+  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+    return 0;
+  } else if (*curr_time < 0 && ctx_ == NULL) {
     throw ValueError("decay cannot use default time with NULL context");
   }
 
-  if (curr_time < 0) {
-    curr_time = ctx_->time();
+  if (*curr_time < 0) {
+    *curr_time = ctx_->time();
   }
 
-  int dt = curr_time - prev_decay_time_;
+  int dt = *curr_time - prev_decay_time_;
   if (dt == 0) {
-    return;
+    return 0;
   }
 
   double eps = 1e-3;
-  const CompMap c = comp_->atom();
 
-  // If composition has too many nuclides (i.e. > 100), it is cheaper to
-  // just do the decay rather than check all the decay constants.
-  bool decay = c.size() > 100;
+  // Compositions with many nuclides (i.e. > 100) are always decayed.
+  bool decay = comp_->atom_vec().size() > 100;
 
-  uint64_t secs_per_timestep = kDefaultTimeStepDur;
+  *secs_per_timestep = kDefaultTimeStepDur;
   if (ctx_ != NULL) {
-    secs_per_timestep = ctx_->sim_info().dt;
+    *secs_per_timestep = ctx_->dt();
   }
 
   if (!decay) {
     // Only do the decay calc if one of the nuclides would change in number
-    // density more than fraction eps.
-    // i.e. decay if   (1 - eps) > exp(-lambda*dt)
-    CompMap::const_reverse_iterator it;
-    for (it = c.rbegin(); it != c.rend(); ++it) {
-      int nuc = it->first;
-      double lambda_timesteps = pyne::decay_const(nuc) * static_cast<double>(secs_per_timestep);
-      double change = 1.0 - std::exp(-lambda_timesteps * static_cast<double>(dt));
-      if (change >= eps) {
-        decay = true;
-        break;
-      }
-    }
-    if (!decay) {
-      return;
+    // density more than fraction eps, i.e. decay if
+    // (1 - eps) > exp(-lambda*dt) for the largest lambda.
+    double lambda_timesteps = comp_->max_decay_const() *
+                              static_cast<double>(*secs_per_timestep);
+    double change =
+        1.0 - std::exp(-lambda_timesteps * static_cast<double>(dt));
+    if (change < eps) {
+      return 0;
     }
   }
-
-  prev_decay_time_ = curr_time; // this must go before Transmute call
-  Composition::Ptr decayed = comp_->Decay(dt, secs_per_timestep);
-  Transmute(decayed);
+  return dt;
 }
 
 double Material::DecayHeat() {
@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_MATERIAL_H_
 
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "composition.h"
@@ -141,6 +142,11 @@ class Material: public Resource {
   ///        (default: -1 forces the decay to the context's current time)
   virtual void Decay(int curr_time = -1);
 
+  /// Decays every material in mats as Decay(curr_time) would, except that the
+  /// decays of all materials with the same time delta are calculated together
+  /// (see Composition::DecayAll). Overrides of Decay are not called.
+  static void DecayAll(const std::vector<Ptr>& mats, int curr_time = -1);
+
   /// Returns the last time step on which a decay calculation was performed
   /// for the material.  This is not necessarily synonymous with the last time
   /// step the material's Decay function was called.
@@ -170,6 +176,11 @@ class Material: public Resource {
            std::string package_name = Package::unpackaged_name());
 
  private:
+  /// Returns the number of timesteps this material should be decayed by at
+  /// curr_time (zero if it need not be decayed) and the seconds per timestep.
+  /// A negative curr_time is replaced by the context's current time.
+  int PendingDecay(int* curr_time, uint64_t* secs_per_timestep);
+
   Context* ctx_;
   double qty_;
   Composition::Ptr comp_;
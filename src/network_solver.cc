@@ -0,0 +1,239 @@
+#include "network_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "cyc_limits.h"
+#include "exchange_graph.h"
+#include "greedy_solver.h"
+#include "logger.h"
+#include "platform.h"
+#if CYCLUS_HAS_COIN
+#include "prog_solver.h"
+#endif
+
+namespace cyclus {
+
+/// a residual flow network solved by successive shortest paths, where edge e
+/// and its reverse edge e ^ 1 are stored next to each other
+class FlowNetwork {
+ public:
+  explicit FlowNetwork(int n) : adj_(n) {}
+
+  /// @return the id of the new edge
+  int AddEdge(int from, int to, double cap, double cost) {
+    int e = edges_.size();
+    edges_.push_back(Edge(to, cap, cost));
+    edges_.push_back(Edge(from, 0, -cost));
+    adj_[from].push_back(e);
+    adj_[to].push_back(e + 1);
+    return e;
+  }
+
+  /// @return the flow on edge e
+  inline double flow(int e) const { return edges_[e ^ 1].cap; }
+
+  /// sends the given amount of flow from s to t at the minimum cost, or as
+  /// much flow as possible if the amount cannot be sent. Edge costs must be
+  /// nonnegative.
+  void Solve(int s, int t, double amt);
+
+ private:
+  struct Edge {
+    Edge(int to, double cap, double cost) : to(to), cap(cap), cost(cost) {}
+    int to;
+    double cap;
+    double cost;
+  };
+
+  std::vector<Edge> edges_;
+  std::vector< std::vector<int> > adj_;
+};
+
+void FlowNetwork::Solve(int s, int t, double amt) {
+  typedef std::pair<double, int> Item;
+  double inf = std::numeric_limits<double>::max();
+  int n = adj_.size();
+  std::vector<double> pot(n, 0);  // keeps reduced costs nonnegative
+  std::vector<double> dist(n);
+  std::vector<int> prev(n);
+
+  while (amt > eps()) {
+    // shortest path by reduced cost (Dijkstra)
+    dist.assign(n, inf);
+    prev.assign(n, -1);
+    dist[s] = 0;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > q;
+    q.push(Item(0, s));
+    while (!q.empty()) {
+      Item top = q.top();
+      q.pop();
+      int v = top.second;
+      if (top.first > dist[v]) {
+        continue;
+      }
+      for (int i = 0; i < adj_[v].size(); ++i) {
+        int e = adj_[v][i];
+        const Edge& edge = edges_[e];
+        if (edge.cap <= eps()) {
+          continue;
+        }
+        double d = dist[v] + edge.cost + pot[v] - pot[edge.to];
+        if (d < dist[edge.to]) {
+          dist[edge.to] = d;
+          prev[edge.to] = e;
+          q.push(Item(d, edge.to));
+        }
+      }
+    }
+    if (prev[t] == -1) {
+      return;
+    }
+
+    for (int v = 0; v < n; ++v) {
+      if (dist[v] < inf) {
+        pot[v] += dist[v];
+      }
+    }
+
+    // augment along the path by its bottleneck capacity
+    double f = amt;
+    for (int v = t; v != s; v = edges_[prev[v] ^ 1].to) {
+      f = std::min(f, edges_[prev[v]].cap);
+    }
+    for (int v = t; v != s; v = edges_[prev[v] ^ 1].to) {
+      edges_[prev[v]].cap -= f;
+      edges_[prev[v] ^ 1].cap += f;
+    }
+    amt -= f;
+  }
+}
+
+NetworkSolver::NetworkSolver(bool exclusive_orders)
+    : fallback_(NULL),
+      ExchangeSolver(exclusive_orders) {}
+
+NetworkSolver::~NetworkSolver() {
+  delete fallback_;
+}
+
+ExchangeSolver* NetworkSolver::Clone() const {
+  return new NetworkSolver(exclusive_orders_);
+}
+
+double NetworkSolver::FlowUnit(const CompactGraph& cg, int a) {
+  if (cg.n_ucaps(a) > 0) {
+    return cg.ucaps(a)[0];
+  } else if (cg.n_vcaps(a) > 0) {
+    return cg.vcaps(a)[0];
+  }
+  return 1;
+}
+
+bool NetworkSolver::IsNetwork(const CompactGraph& cg, bool exclusive_orders) {
+  for (int g = 0; g < cg.n_groups(); ++g) {
+    if (cg.caps_end(g) - cg.caps_begin(g) > 1) {
+      return false;
+    }
+  }
+
+  for (int a = 0; a < cg.n_arcs(); ++a) {
+    int ug = cg.node_group(cg.unode(a));
+    int vg = cg.node_group(cg.vnode(a));
+    if ((exclusive_orders && cg.exclusive(a)) ||
+        cg.pref(a) <= 0 ||
+        cg.n_ucaps(a) != cg.caps_end(ug) - cg.caps_begin(ug) ||
+        cg.n_vcaps(a) != cg.caps_end(vg) - cg.caps_begin(vg) ||
+        FlowUnit(cg, a) <= 0) {
+      return false;
+    }
+    if (cg.n_ucaps(a) > 0 && cg.n_vcaps(a) > 0) {
+      double u = cg.ucaps(a)[0];
+      double v = cg.vcaps(a)[0];
+      if (std::fabs(u - v) > eps() * std::max(u, v)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+double NetworkSolver::SolveGraph() {
+  const CompactGraph& cg = *Compact();
+  if (!IsNetwork(cg, exclusive_orders_)) {
+    CLOG(LEV_DEBUG1) << "Exchange is not a network, using the fallback solver.";
+    return SolveFallback();
+  }
+
+  double inf = std::numeric_limits<double>::max();
+  double pseudo_cost = PseudoCost();  // from ExchangeSolver API
+
+  // vertices are the node groups, a source, and a sink. Supply groups are
+  // fed from the source up to their capacity and request groups drain to the
+  // sink up to their demand. Unmet demand is supplied by a faux arc from the
+  // source at the pseudo cost.
+  int source = cg.n_groups();
+  int sink = source + 1;
+  FlowNetwork net(cg.n_groups() + 2);
+  double demand = 0;
+  std::vector<int> faux_edge;
+  for (int g = 0; g < cg.n_groups(); ++g) {
+    bool has_cap = cg.caps_end(g) > cg.caps_begin(g);
+    double cap = has_cap ? cg.caps()[cg.caps_begin(g)] : inf;
+    if (!cg.is_request(g)) {
+      net.AddEdge(source, g, cap, 0);
+    } else if (has_cap && cg.group(g)->HasArcs()) {
+      // 1e15 is the same demand bound used by the ProgTranslator
+      double d = std::min(cap, 1e15);
+      net.AddEdge(g, sink, d, 0);
+      faux_edge.push_back(net.AddEdge(source, g, inf, pseudo_cost));
+      demand += d;
+    }
+  }
+
+  // flow on an arc's edge is measured in its unit capacity
+  std::vector<int> arc_edge(cg.n_arcs());
+  for (int a = 0; a < cg.n_arcs(); ++a) {
+    double unit = FlowUnit(cg, a);
+    double qty = cg.qty(cg.unode(a));
+    double ub = qty >= inf / unit ? inf : qty * unit;
+    arc_edge[a] = net.AddEdge(cg.node_group(cg.vnode(a)),
+                              cg.node_group(cg.unode(a)), ub,
+                              Cost(cg.arc(a), exclusive_orders_) / unit);
+  }
+
+  net.Solve(source, sink, demand);
+
+  double obj = 0;
+  for (int a = 0; a < cg.n_arcs(); ++a) {
+    double flow = net.flow(arc_edge[a]) / FlowUnit(cg, a);
+    if (flow > eps()) {
+      graph_->AddMatch(cg.arc(a), flow);
+      obj += flow * Cost(cg.arc(a), exclusive_orders_);
+    }
+  }
+  for (int i = 0; i < faux_edge.size(); ++i) {
+    obj += net.flow(faux_edge[i]) * pseudo_cost;
+  }
+  return obj;
+}
+
+double NetworkSolver::SolveFallback() {
+  if (fallback_ == NULL) {
+#if CYCLUS_HAS_COIN
+    fallback_ = new ProgSolver("cbc", exclusive_orders_);
+#else
+    fallback_ = new GreedySolver(exclusive_orders_);
+#endif
+  }
+  fallback_->sim_ctx(sim_ctx_);
+  fallback_->compact_graph(cg_);
+  fallback_->pseudo_cost(PseudoCost());
+  return fallback_->Solve(graph_);
+}
+
+}  // namespace cyclus
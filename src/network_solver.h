@@ -0,0 +1,60 @@
+#ifndef CYCLUS_SRC_NETWORK_SOLVER_H_
+#define CYCLUS_SRC_NETWORK_SOLVER_H_
+
+#include <vector>
+
+#include "compact_graph.h"
+#include "exchange_solver.h"
+
+namespace cyclus {
+
+class ExchangeGraph;
+
+/// @class NetworkSolver
+///
+/// @brief The NetworkSolver finds the optimal solution to an exchange graph by
+/// solving it as a minimum cost flow problem, which is much faster than solving
+/// the equivalent linear program with a general purpose solver.
+///
+/// The solution minimizes the same objective as the ProgSolver: the cost
+/// (ExchangeSolver::Cost) of each arc's flow plus the pseudo cost
+/// (ExchangeSolver::PseudoCost) of each request group's unmet demand. Flow
+/// from a supply group travels along an arc to a request group, so the
+/// exchange is a network when
+///   - every node group has at most one capacity,
+///   - an arc's unit capacities are the same at both of its nodes (the flow
+///     is measured in those units), and
+///   - no arc is exclusive, or exclusive orders are not allowed.
+///
+/// Graphs that are not networks are handed to a ProgSolver (or a
+/// GreedySolver if Cyclus was built without COIN).
+class NetworkSolver: public ExchangeSolver {
+ public:
+  explicit NetworkSolver(bool exclusive_orders = kDefaultExclusive);
+  virtual ~NetworkSolver();
+
+  /// @brief returns a new NetworkSolver allowing the same orders
+  virtual ExchangeSolver* Clone() const;
+
+  /// @return true if the graph can be solved as a minimum cost flow problem
+  /// by a solver with the given setting for exclusive orders
+  static bool IsNetwork(const CompactGraph& cg, bool exclusive_orders);
+
+ protected:
+  /// @brief the NetworkSolver solves an ExchangeGraph...
+  virtual double SolveGraph();
+
+ private:
+  /// solves the graph with the fallback solver, creating it if needed
+  double SolveFallback();
+
+  /// the flow unit of an arc, i.e., its unit capacity (or 1 if neither node
+  /// has one)
+  static double FlowUnit(const CompactGraph& cg, int a);
+
+  ExchangeSolver* fallback_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_NETWORK_SOLVER_H_
@@ -0,0 +1,131 @@
+#include "nuc_vec.h"
+
+#include <algorithm>
+
+#include "error.h"
+#include "pyne.h"
+
+extern "C" {
+#include "cram.hpp"
+}
+
+namespace cyclus {
+
+// Returns the dense solver indices ordered by ascending nuclide id, so that
+// vectors gathered from dense solver vectors come out sorted.
+static const std::vector<int>& DenseOrder() {
+  static const std::vector<int> order = [] {
+    const int* ids = pyne_cram_transmute_info.nucids;
+    std::vector<int> o(pyne_cram_transmute_info.n);
+    for (int i = 0; i < o.size(); ++i) {
+      o[i] = i;
+    }
+    std::sort(o.begin(), o.end(),
+              [ids](int a, int b) { return ids[a] < ids[b]; });
+    return o;
+  }();
+  return order;
+}
+
+NucVec::NucVec(const CompMap& v) {
+  Reserve(v.size());
+  CompMap::const_iterator it;
+  for (it = v.begin(); it != v.end(); ++it) {
+    nucs_.push_back(it->first);
+    vals_.push_back(it->second);
+    dense_.push_back(DenseIndex(it->first));
+  }
+}
+
+NucVec NucVec::FromDense(const double* x) {
+  const std::vector<int>& order = DenseOrder();
+  const int* ids = pyne_cram_transmute_info.nucids;
+  NucVec v;
+  for (int k = 0; k < order.size(); ++k) {
+    int i = order[k];
+    if (x[i] > 0.0) {
+      v.nucs_.push_back(ids[i]);
+      v.vals_.push_back(x[i]);
+      v.dense_.push_back(i);
+    }
+  }
+  return v;
+}
+
+int NucVec::DenseSize() {
+  return pyne_cram_transmute_info.n;
+}
+
+int NucVec::DenseIndex(Nuc nuc) {
+  return pyne_cram_transmute_nucid_to_i(nuc);
+}
+
+const std::vector<double>& NucVec::DenseDecayConsts() {
+  static const std::vector<double> consts = [] {
+    const int* ids = pyne_cram_transmute_info.nucids;
+    std::vector<double> c(pyne_cram_transmute_info.n);
+    for (int i = 0; i < c.size(); ++i) {
+      c[i] = pyne::decay_const(ids[i]);
+    }
+    return c;
+  }();
+  return consts;
+}
+
+void NucVec::PushBack(Nuc nuc, double val) {
+  PushBack(nuc, val, DenseIndex(nuc));
+}
+
+void NucVec::PushBack(Nuc nuc, double val, int dense) {
+  if (!nucs_.empty() && nuc <= nucs_.back()) {
+    throw ValueError("nuclides must be added to a NucVec in ascending order");
+  }
+  nucs_.push_back(nuc);
+  vals_.push_back(val);
+  dense_.push_back(dense);
+}
+
+void NucVec::Reserve(int n) {
+  nucs_.reserve(n);
+  vals_.reserve(n);
+  dense_.reserve(n);
+}
+
+void NucVec::ScatterDense(double* x) const {
+  for (int k = 0; k < nucs_.size(); ++k) {
+    if (dense_[k] >= 0) {
+      x[dense_[k]] += vals_[k];
+    }
+  }
+}
+
+double NucVec::Get(Nuc nuc) const {
+  std::vector<Nuc>::const_iterator it =
+      std::lower_bound(nucs_.begin(), nucs_.end(), nuc);
+  if (it == nucs_.end() || *it != nuc) {
+    return 0;
+  }
+  return vals_[it - nucs_.begin()];
+}
+
+double NucVec::MaxDecayConst() const {
+  const std::vector<double>& consts = DenseDecayConsts();
+  double max = 0;
+  for (int k = 0; k < nucs_.size(); ++k) {
+    // nuclides unknown to the solver are rare enough to look up directly
+    double lambda = dense_[k] >= 0 ? consts[dense_[k]]
+                                   : pyne::decay_const(nucs_[k]);
+    max = std::max(max, lambda);
+  }
+  return max;
+}
+
+CompMap NucVec::ToMap() const {
+  CompMap v;
+  for (int k = 0; k < nucs_.size(); ++k) {
+    v.insert(v.end(), std::make_pair(nucs_[k], vals_[k]));
+  }
+  return v;
+}
+
+}  // namespace cyclus
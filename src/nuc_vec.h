@@ -0,0 +1,101 @@
+#ifndef CYCLUS_SRC_NUC_VEC_H_
+#define CYCLUS_SRC_NUC_VEC_H_
+
+#include <map>
+#include <vector>
+
+namespace cyclus {
+
+typedef int Nuc;
+
+/// a raw definition of nuclides and corresponding (dimensionless quantities).
+typedef std::map<Nuc, double> CompMap;
+
+/// A NucVec holds the same information as a CompMap, but stores it in
+/// contiguous arrays sorted by nuclide id so that arithmetic over whole
+/// vectors (see the NucVec functions in compmath) runs as simple loops that
+/// the compiler can vectorize, without allocating a tree node per nuclide.
+///
+/// Each nuclide also carries its index in the dense nuclide numbering used by
+/// the CRAM decay solver (or -1 if the solver does not know the nuclide), so
+/// vectors can be scattered to and gathered from the solver's dense vectors
+/// without looking nuclides up again. A NucVec is thus a sparse view into that
+/// dense space that can also hold nuclides outside of it.
+class NucVec {
+ public:
+  NucVec() {}
+
+  /// Creates a vector with the same nuclides and quantities as v.
+  explicit NucVec(const CompMap& v);
+
+  /// Creates a vector from the positive entries of x, which is indexed by the
+  /// CRAM solver's dense nuclide numbering and has DenseSize() entries.
+  static NucVec FromDense(const double* x);
+
+  /// Returns the number of nuclides in the CRAM solver's dense numbering.
+  static int DenseSize();
+
+  /// Returns the index of nuc in the CRAM solver's dense numbering or -1 if
+  /// the solver does not know it.
+  static int DenseIndex(Nuc nuc);
+
+  /// Returns the decay constant (in 1/s) of every nuclide in the CRAM
+  /// solver's dense numbering. The table is looked up from nuclear data once,
+  /// the first time it is needed.
+  static const std::vector<double>& DenseDecayConsts();
+
+  /// Appends a nuclide, which must have a larger id than every nuclide
+  /// already in the vector.
+  void PushBack(Nuc nuc, double val);
+
+  /// Same as PushBack(nuc, val) for a nuclide whose dense solver index is
+  /// already known.
+  void PushBack(Nuc nuc, double val, int dense);
+
+  /// Reserves room for n nuclides.
+  void Reserve(int n);
+
+  /// Adds the quantity of every nuclide known to the CRAM solver to the dense
+  /// vector x (see FromDense). Other nuclides are ignored.
+  void ScatterDense(double* x) const;
+
+  /// Returns the quantity of nuc, or zero if the vector does not have it.
+  double Get(Nuc nuc) const;
+
+  /// Returns the same nuclides and quantities as a CompMap.
+  CompMap ToMap() const;
+
+  /// Returns the largest decay constant (in 1/s) of the nuclides in the
+  /// vector, or zero if it is empty.
+  double MaxDecayConst() const;
+
+  /// Returns the number of nuclides in the vector.
+  inline int size() const { return nucs_.size(); }
+
+  inline bool empty() const { return nucs_.empty(); }
+
+  /// Returns the nuclide ids in ascending order.
+  inline const std::vector<Nuc>& nucs() const { return nucs_; }
+
+  /// Returns the quantities of the nuclides, in the same order as nucs().
+  inline const std::vector<double>& vals() const { return vals_; }
+  inline std::vector<double>& vals() { return vals_; }
+
+  /// Returns the dense solver index of each nuclide, in the same order as
+  /// nucs().
+  inline const std::vector<int>& dense() const { return dense_; }
+
+  /// Returns true if both vectors have exactly the same nuclides.
+  inline bool SameNucs(const NucVec& other) const {
+    return nucs_ == other.nucs_;
+  }
+
+ private:
+  std::vector<Nuc> nucs_;
+  std::vector<double> vals_;
+  std::vector<int> dense_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_NUC_VEC_H_
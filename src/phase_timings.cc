@@ -0,0 +1,57 @@
+#include "phase_timings.h"
+
+#include "context.h"
+
+namespace cyclus {
+
+void PhaseTimings::Add(const std::string& phase, double secs,
+                       const std::string& proto) {
+  Key k(phase, proto);
+  std::map<Key, Total>::iterator it = totals_.find(k);
+  if (it == totals_.end()) {
+    order_.push_back(k);
+    it = totals_.insert(std::make_pair(k, Total())).first;
+  }
+  it->second.calls++;
+  it->second.secs += secs;
+}
+
+void PhaseTimings::Record(Context* ctx) {
+  // whole phases first, then the per-prototype breakdowns
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int i = 0; i < order_.size(); ++i) {
+      const Key& k = order_[i];
+      if (k.second.empty() != (pass == 0)) {
+        continue;
+      }
+      const Total& tot = totals_[k];
+      ctx->NewDatum("PhaseTimings")
+          ->AddVal("Time", ctx->time())
+          ->AddVal("Phase", k.first)
+          ->AddVal("Prototype", k.second)
+          ->AddVal("Calls", tot.calls)
+          ->AddVal("Seconds", tot.secs)
+          ->Record();
+    }
+  }
+  order_.clear();
+  totals_.clear();
+}
+
+PhaseTimer::PhaseTimer(PhaseTimings* timings) : timings_(timings) {
+  if (timings_ != NULL) {
+    start_ = Clock::now();
+  }
+}
+
+void PhaseTimer::Lap(const std::string& phase, const std::string& proto) {
+  if (timings_ == NULL) {
+    return;
+  }
+  Clock::time_point now = Clock::now();
+  timings_->Add(phase, std::chrono::duration<double>(now - start_).count(),
+                proto);
+  start_ = now;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,77 @@
+#ifndef CYCLUS_SRC_PHASE_TIMINGS_H_
+#define CYCLUS_SRC_PHASE_TIMINGS_H_
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cyclus {
+
+class Context;
+
+/// @class PhaseTimings
+///
+/// @brief PhaseTimings accumulates the wall clock time spent in each phase of
+/// a timestep (and optionally in each prototype within a phase) and records
+/// the totals to the PhaseTimings output table. Times are usually measured
+/// with a PhaseTimer:
+///
+/// @code
+/// PhaseTimer pt(ctx->phase_timings());
+/// DoSomething();
+/// pt.Lap("Something");
+/// DoSomethingElse();
+/// pt.Lap("SomethingElse");
+/// @endcode
+class PhaseTimings {
+ public:
+  /// Adds secs to the total time spent in phase. If proto is not empty, the
+  /// time is attributed to that prototype within the phase instead.
+  void Add(const std::string& phase, double secs,
+           const std::string& proto = "");
+
+  /// Records one row per phase and one row per (phase, prototype) pair
+  /// accumulated since the last call for the current simulation time, and
+  /// then resets all totals.
+  void Record(Context* ctx);
+
+ private:
+  typedef std::pair<std::string, std::string> Key;
+
+  struct Total {
+    Total() : calls(0), secs(0) {}
+    int calls;
+    double secs;
+  };
+
+  /// keys in the order they were first added, for stable output
+  std::vector<Key> order_;
+  std::map<Key, Total> totals_;
+};
+
+/// @class PhaseTimer
+///
+/// @brief A PhaseTimer measures consecutive wall clock intervals and adds them
+/// to a PhaseTimings object. If constructed with a NULL PhaseTimings, no clock
+/// is read and all calls are no-ops, so timers can be left in place when
+/// timing is disabled.
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(PhaseTimings* timings);
+
+  /// Adds the time elapsed since construction or the previous lap to phase
+  /// (and proto, if given) and starts the next interval.
+  void Lap(const std::string& phase, const std::string& proto = "");
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  PhaseTimings* timings_;
+  Clock::time_point start_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_PHASE_TIMINGS_H_
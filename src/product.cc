@@ -1,6 +1,7 @@
 #include "product.h"
 
 #include "error.h"
+#include "id_seq.h"
 #include "logger.h"
 #include "cyc_limits.h"
 
@@ -10,16 +11,35 @@ const ResourceType Product::kType = "Product";
 
 std::map<std::string, int> Product::qualids_;
 int Product::next_qualid_ = 1;
+std::mutex Product::qualids_mtx_;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::Create(Agent* creator, double quantity,
                              std::string quality, std::string package_name) {
-  if (qualids_.count(quality) == 0) {
-    qualids_[quality] = next_qualid_++;
-    creator->context()->NewDatum("Products")
-        ->AddVal("QualId", qualids_[quality])
-        ->AddVal("Quality", quality)
-        ->Record();
+  bool known;
+  {
+    std::lock_guard<std::mutex> lk(qualids_mtx_);
+    known = qualids_.count(quality) > 0;
+  }
+
+  if (!known) {
+    // new qualities are numbered in task order when products are created
+    // concurrently, see IdBlocks
+    IdBlocks::WaitTurn();
+    int qualid = -1;
+    {
+      std::lock_guard<std::mutex> lk(qualids_mtx_);
+      if (qualids_.count(quality) == 0) {
+        qualid = next_qualid_++;
+        qualids_[quality] = qualid;
+      }
+    }
+    if (qualid >= 0) {
+      creator->context()->NewDatum("Products")
+          ->AddVal("QualId", qualid)
+          ->AddVal("Quality", quality)
+          ->Record();
+    }
   }
 
   // the next lines must come after qual id setting
@@ -28,6 +48,12 @@ Product::Ptr Product::Create(Agent* creator, double quantity,
   return r;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Product::qual_id() const {
+  std::lock_guard<std::mutex> lk(qualids_mtx_);
+  return qualids_[quality_];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::CreateUntracked(double quantity,
                                       std::string quality) {
@@ -1,6 +1,8 @@
 #ifndef CYCLUS_SRC_PRODUCT_H_
 #define CYCLUS_SRC_PRODUCT_H_
 
+#include <mutex>
+
 #include <boost/shared_ptr.hpp>
 
 #include "context.h"
@@ -35,9 +37,7 @@ class Product : public Resource {
   static Ptr CreateUntracked(double quantity, std::string quality);
 
   /// Returns 0 (for now).
-  virtual int qual_id() const {
-    return qualids_[quality_];
-  }
+  virtual int qual_id() const;
 
   /// Returns Product::kType.
   virtual const ResourceType type() const {
@@ -90,6 +90,10 @@ class Product : public Resource {
   static std::map<std::string, int> qualids_;
   static int next_qualid_;
 
+  // guards qualids_ and next_qualid_, since products may be created by
+  // concurrently running listeners and traders
+  static std::mutex qualids_mtx_;
+
   Context* ctx_;
   std::string quality_;
   double quantity_;
@@ -5,6 +5,7 @@
 #include "context.h"
 #include "prog_translator.h"
 #include "greedy_solver.h"
+#include "logger.h"
 #include "solver_factory.h"
 
 namespace cyclus {
@@ -20,6 +21,11 @@ ProgSolver::ProgSolver(std::string solver_t)
       tmax_(ProgSolver::kDefaultTimeout),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      lp_(false),
+      iface_(NULL),
+      basis_(NULL),
+      nrows_(0),
       ExchangeSolver(false) {}
 
 ProgSolver::ProgSolver(std::string solver_t, bool exclusive_orders)
@@ -27,6 +33,11 @@ ProgSolver::ProgSolver(std::string solver_t, bool exclusive_orders)
       tmax_(ProgSolver::kDefaultTimeout),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      lp_(false),
+      iface_(NULL),
+      basis_(NULL),
+      nrows_(0),
       ExchangeSolver(exclusive_orders) {}
 
 ProgSolver::ProgSolver(std::string solver_t, double tmax)
@@ -34,6 +45,11 @@ ProgSolver::ProgSolver(std::string solver_t, double tmax)
       tmax_(tmax),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      lp_(false),
+      iface_(NULL),
+      basis_(NULL),
+      nrows_(0),
       ExchangeSolver(false) {}
 
 ProgSolver::ProgSolver(std::string solver_t, double tmax, bool exclusive_orders,
@@ -42,55 +58,135 @@ ProgSolver::ProgSolver(std::string solver_t, double tmax, bool exclusive_orders,
       tmax_(tmax),
       verbose_(verbose),
       mps_(mps),
+      persistent_(false),
+      lp_(false),
+      iface_(NULL),
+      basis_(NULL),
+      nrows_(0),
       ExchangeSolver(exclusive_orders) {}
 
-ProgSolver::~ProgSolver() {}
+ProgSolver::~ProgSolver() {
+  Reset();
+}
+
+ExchangeSolver* ProgSolver::Clone() const {
+  ProgSolver* s = new ProgSolver(solver_t_, tmax_, exclusive_orders_, verbose_,
+                                 mps_);
+  s->persistent(persistent_);
+  s->lp(lp_);
+  return s;
+}
+
+void ProgSolver::Reset() {
+  delete basis_;
+  basis_ = NULL;
+  delete iface_;
+  iface_ = NULL;
+  cols_.clear();
+  nrows_ = 0;
+}
 
 void ProgSolver::WriteMPS() {
   std::stringstream ss;
   ss << "exchng_" << sim_ctx_->time();
-  iface_->writeMps(ss.str().c_str());
+  if (mps_)
+    iface_->writeMps(ss.str().c_str());
+  if (lp_)
+    iface_->writeLp(ss.str().c_str());
+}
+
+bool ProgSolver::CanWarmStart(const std::vector<ColKey>& cols,
+                              int nrows) const {
+  return basis_ != NULL && nrows == nrows_ && cols == cols_;
 }
 
 double ProgSolver::SolveGraph() {
-  SolverFactory sf(solver_t_, tmax_);
-  iface_ = sf.get();
+  if (iface_ == NULL) {
+    SolverFactory sf(solver_t_, tmax_);
+    iface_ = sf.get();
+  }
+
   try {
-    // get greedy solution
-    GreedySolver greedy(exclusive_orders_);
-    double greedy_obj = greedy.Solve(graph_);
-    graph_->ClearMatches();
+    // get greedy solution, which is only used as a reference for the time
+    // it takes to find a better one, so persistent solvers skip it unless
+    // reporting
+    double greedy_obj = iface_->getInfinity();
+    if (!persistent_ || verbose_) {
+      GreedySolver greedy(exclusive_orders_);
+      greedy.pseudo_cost(PseudoCost());
+      greedy_obj = greedy.Solve(graph_);
+      graph_->ClearMatches();
+      cg_ = greedy.compact_graph();
+    }
 
     // translate graph to iface_ instance
     double pseudo_cost = PseudoCost(); // from ExchangeSolver API
-    ProgTranslator xlator(graph_, iface_, exclusive_orders_, pseudo_cost);
+    ProgTranslator xlator(graph_, Compact(), iface_, exclusive_orders_,
+                          pseudo_cost);
     xlator.ToProg();
-    if (mps_)
+    if (mps_ || lp_)
       WriteMPS();
 
     // set noise level
-    CoinMessageHandler h;
-    h.setLogLevel(0);
+    handler_.setLogLevel(0);
     if (verbose_) {
       Report(iface_);
-      h.setLogLevel(4);
+      handler_.setLogLevel(4);
     }
-    iface_->passInMessageHandler(&h);
+    iface_->passInMessageHandler(&handler_);
     if (verbose_) {
       std::cout << "Solving problem, message handler has log level of "
                 << iface_->messageHandler()->logLevel() << "\n";
     }
 
+    // columns are the arcs in id order followed by one faux arc per request
+    // group
+    std::vector<ColKey> cols;
+    if (persistent_) {
+      std::vector<Arc>& arcs = graph_->arcs();
+      cols.reserve(iface_->getNumCols());
+      for (int i = 0; i != arcs.size(); i++) {
+        const Arc& a = arcs[i];
+        cols.push_back(ColKey(std::make_pair(a.unode()->agent_id,
+                                             a.vnode()->agent_id),
+                              a.unode()->commod));
+      }
+      for (int i = arcs.size(); i < iface_->getNumCols(); i++) {
+        cols.push_back(ColKey(std::make_pair(-1, -1), ""));
+      }
+    }
+
     // solve and back translate
-    SolveProg(iface_, greedy_obj, verbose_);
+    bool lp = !HasInt(iface_);
+    if (lp && CanWarmStart(cols, iface_->getNumRows()) &&
+        iface_->setWarmStart(basis_)) {
+      iface_->resolve();
+    } else {
+      if (persistent_ && basis_ != NULL) {
+        CLOG(LEV_DEBUG1) << "The exchange's columns or rows changed, so the "
+                         << "persistent solver starts cold.";
+      }
+      SolveProg(iface_, greedy_obj, verbose_);
+    }
+
+    if (persistent_) {
+      delete basis_;
+      basis_ = NULL;
+      if (lp && iface_->isProvenOptimal()) {
+        basis_ = iface_->getWarmStart();
+      }
+      cols_.swap(cols);
+      nrows_ = iface_->getNumRows();
+    }
 
     xlator.FromProg();
   } catch(...) {
-    delete iface_;
+    Reset();
     throw;
   }
   double ret = iface_->getObjValue();
-  delete iface_;
+  if (!persistent_)
+    Reset();
   return ret;
 }
 
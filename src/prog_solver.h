@@ -4,7 +4,11 @@
 #if CYCLUS_HAS_COIN
 
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "CoinMessageHandler.hpp"
+#include "CoinWarmStart.hpp"
 #include "OsiSolverInterface.hpp"
 
 #include "exchange_graph.h"
@@ -16,6 +20,16 @@ class ExchangeGraph;
 
 /// @brief The ProgSolver provides the implementation for a mathematical
 /// programming solution to a resource exchange graph.
+///
+/// By default, a new solver interface is created and destroyed for every
+/// exchange. A persistent ProgSolver instead keeps its interface alive between
+/// exchanges. If an exchange has the same columns (identified by the agents
+/// and commodity of each arc) and rows as the previous one, the previous
+/// optimal basis is used to warm start the linear program, which is usually
+/// much faster than solving from scratch for near-identical exchanges. When
+/// exchanges are decomposed, a persistent ProgSolver keeps one clone per
+/// component position, so each component is warm started from the basis of
+/// the same component of the previous exchange.
 class ProgSolver: public ExchangeSolver {
  public:
   static const int kDefaultTimeout = 5 * 60; // 5 * 60 s/min == 5 minutes
@@ -35,17 +49,55 @@ class ProgSolver: public ExchangeSolver {
   /// @}
   virtual ~ProgSolver();
 
+  /// @brief returns a new ProgSolver with the same solver type, timeout,
+  /// output, and persistence settings
+  virtual ExchangeSolver* Clone() const;
+
+  /// whether or not the solver interface and the last optimal basis are kept
+  /// between exchanges, default false
+  /// @{
+  inline void persistent(bool p) { persistent_ = p; }
+  inline bool persistent() const { return persistent_; }
+  /// @}
+
+  /// whether or not to dump an LP file for every solve, default false
+  /// @{
+  inline void lp(bool l) { lp_ = l; }
+  inline bool lp() const { return lp_; }
+  /// @}
+
  protected:
   /// @brief the ProgSolver solves an ExchangeGraph...
   virtual double SolveGraph();
 
+  /// persistent solvers keep their clones, and thus their bases
+  virtual bool KeepsClones() const { return persistent_; }
+
  private:
+  /// the identity of a column across exchanges: the request and bid agent ids
+  /// and the requested commodity
+  typedef std::pair<std::pair<int, int>, std::string> ColKey;
+
+  /// writes the translated problem to exchng_<time>.mps and/or .lp
   void WriteMPS();
 
+  /// @return true if the last basis can be used to warm start a problem
+  /// with the given columns and number of rows
+  bool CanWarmStart(const std::vector<ColKey>& cols, int nrows) const;
+
+  /// deletes the interface and any saved basis
+  void Reset();
+
   std::string solver_t_;
   double tmax_;
   bool verbose_, mps_;
+  bool persistent_;
+  bool lp_;
   OsiSolverInterface* iface_;
+  CoinMessageHandler handler_;
+  CoinWarmStart* basis_;
+  std::vector<ColKey> cols_;
+  int nrows_;
 };
 
 }  // namespace cyclus
@@ -2,7 +2,6 @@
 
 #include <algorithm>
 
-#include "CoinPackedVector.hpp"
 #include "OsiSolverInterface.hpp"
 
 #include "cyc_limits.h"
@@ -48,13 +47,26 @@ ProgTranslator::ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
   Init();
 }
 
+ProgTranslator::ProgTranslator(ExchangeGraph* g, CompactGraph::Ptr cg,
+                               OsiSolverInterface* iface, bool exclusive,
+                               double pseudo_cost)
+    : g_(g),
+      cg_(cg),
+      iface_(iface),
+      excl_(exclusive),
+      pseudo_cost_(pseudo_cost) {
+  Init();
+}
+
 void ProgTranslator::Init() {
+  if (cg_ == NULL)
+    cg_.reset(new CompactGraph(g_));
   arc_offset_ = g_->arcs().size();
   int n_cols = arc_offset_ + g_->request_groups().size();
   ctx_.obj_coeffs.resize(n_cols);
   ctx_.col_ubs.resize(n_cols);
   ctx_.col_lbs.resize(n_cols);
-  ctx_.m = CoinPackedMatrix(false, 0, 0);
+  ctx_.m = CoinPackedMatrix(true, 0, 0);
 }
 
 void ProgTranslator::CheckPref(double pref) {
@@ -76,19 +88,41 @@ void ProgTranslator::Translate() {
   for (int i = 0; i != g_->request_groups().size(); ++i)
     nfalse += rgs[i].get()->HasArcs() ? 1 : 0;
   int n_cols = g_->arcs().size() + nfalse;
-  ctx_.m.setDimensions(0, n_cols);
 
-  bool request;
-  std::vector<ExchangeNodeGroup::Ptr>& sgs = g_->supply_groups();
-  for (int i = 0; i != sgs.size(); i++) {
-    request = false;
-    XlateGrp_(sgs[i].get(), request);
+  // rows are laid out group by group, supply groups first, and each request
+  // group with arcs gets the next faux arc
+  int n_grps = cg_->n_groups();
+  std::vector<int> row_start(n_grps);
+  std::vector<int> faux_id(n_grps, -1);
+  for (int i = 0; i != n_grps; i++) {
+    int g = (i + cg_->n_request_groups()) % n_grps;
+    if (cg_->is_request(g) && cg_->group(g)->HasArcs()) {
+      faux_id[g] = arc_offset_++;
+    }
+    row_start[g] = ctx_.row_lbs.size();
+    XlateGrp_(g);
   }
 
-  for (int i = 0; i != rgs.size(); i++) {
-    request = true;
-    XlateGrp_(rgs[i].get(), request);
+  // count the entries in each column, then fill the column-major arrays
+  ctx_.col_starts.assign(n_cols + 1, 0);
+  for (int g = 0; g != n_grps; g++) {
+    AddEntries_(g, row_start[g], faux_id[g], false);
+  }
+  for (int i = 0; i != n_cols; i++) {
+    ctx_.col_starts[i + 1] += ctx_.col_starts[i];
+  }
+  ctx_.row_inds.resize(ctx_.col_starts.back());
+  ctx_.elements.resize(ctx_.col_starts.back());
+  next_.assign(ctx_.col_starts.begin(), ctx_.col_starts.end() - 1);
+  for (int i = 0; i != n_grps; i++) {
+    // in row order, so that each column's row indices are sorted
+    int g = (i + cg_->n_request_groups()) % n_grps;
+    AddEntries_(g, row_start[g], faux_id[g], true);
   }
+  ctx_.m = CoinPackedMatrix(true, ctx_.row_lbs.size(), n_cols,
+                            ctx_.elements.size(), ctx_.elements.data(),
+                            ctx_.row_inds.data(), ctx_.col_starts.data(),
+                            NULL);
 
   // add each false arc
   CLOG(LEV_DEBUG1) << "Adding " << arc_offset_ - g_->arcs().size()
@@ -105,16 +139,16 @@ void ProgTranslator::Populate() {
   iface_->setObjSense(1.0);  // minimize
 
   // load er up!
-  iface_->loadProblem(ctx_.m, &ctx_.col_lbs[0], &ctx_.col_ubs[0],
+  iface_->loadProblem(ctx_.col_starts.size() - 1, ctx_.row_lbs.size(),
+                      ctx_.col_starts.data(), ctx_.row_inds.data(),
+                      ctx_.elements.data(), &ctx_.col_lbs[0], &ctx_.col_ubs[0],
                       &ctx_.obj_coeffs[0], &ctx_.row_lbs[0], &ctx_.row_ubs[0]);
 
 
   if (excl_) {
-    std::vector<Arc>& arcs = g_->arcs();
-    for (int i = 0; i != arcs.size(); i++) {
-      Arc& a = arcs[i];
-      if (a.exclusive()) {
-        iface_->setInteger(g_->arc_ids()[a]);
+    for (int i = 0; i != cg_->n_arcs(); i++) {
+      if (cg_->exclusive(i)) {
+        iface_->setInteger(i);
       }
     }
   }
@@ -126,106 +160,119 @@ void ProgTranslator::ToProg() {
   Populate();
 }
 
-void ProgTranslator::XlateGrp_(ExchangeNodeGroup* grp, bool request) {
+int ProgTranslator::ExclArcs_(const std::vector<ExchangeNode::Ptr>& nodes) {
+  int n_arcs = 0;
+  for (int j = 0; j != nodes.size(); j++) {
+    int n = cg_->node_index(nodes[j].get());
+    n_arcs += cg_->arcs_end(n) - cg_->arcs_begin(n);
+  }
+  return n_arcs;
+}
+
+void ProgTranslator::XlateGrp_(int g) {
   double inf = iface_->getInfinity();
-  std::vector<double>& caps = grp->capacities();
+  ExchangeNodeGroup* grp = cg_->group(g);
+  bool request = cg_->is_request(g);
+  const std::vector<double>& caps = grp->capacities();
 
   if (request && !grp->HasArcs())
     return; // no arcs, no reason to add variables/constraints
 
-  std::vector<CoinPackedVector> cap_rows;
-  std::vector<CoinPackedVector> excl_rows;
+  if (request) {
+    for (int n = cg_->nodes_begin(g); n != cg_->nodes_end(g); n++) {
+      for (int i = cg_->arcs_begin(n); i != cg_->arcs_end(n); i++) {
+        int arc_id = cg_->node_arc(i);
+        bool excl = excl_ && cg_->exclusive(arc_id);
+        CheckPref(cg_->pref(arc_id));
+        ctx_.obj_coeffs[arc_id] = ExchangeSolver::Cost(cg_->arc(arc_id), excl_);
+        ctx_.col_lbs[arc_id] = 0;
+        ctx_.col_ubs[arc_id] = excl ? 1 : std::min(cg_->qty(n), inf);
+      }
+    }
+  }
+
+  // add all capacity rows
   for (int i = 0; i != caps.size(); i++) {
-    cap_rows.push_back(CoinPackedVector());
+    // 1e15 is the largest value that doesn't make the solver fall over
+    // (by emperical testing)
+    double rlb = std::min(caps[i], 1e15);
+    ctx_.row_lbs.push_back(request ? rlb : 0);
+    ctx_.row_ubs.push_back(request ? inf : caps[i]);
   }
 
-  std::vector<ExchangeNode::Ptr>& nodes = grp->nodes();
-  for (int i = 0; i != nodes.size(); i++) {
-    std::map<Arc, std::vector<double> >& ucap_map = nodes[i]->unit_capacities;
-    std::map<Arc, std::vector<double> >::iterator cap_it;
+  if (excl_) {
+    // add all exclusive rows that have arcs
+    std::vector< std::vector<ExchangeNode::Ptr> >& exngs =
+        grp->excl_node_groups();
+    for (int i = 0; i != exngs.size(); i++) {
+      if (ExclArcs_(exngs[i]) > 0) {
+        ctx_.row_lbs.push_back(0.0);
+        ctx_.row_ubs.push_back(1.0);
+      }
+    }
+  }
+}
 
-    // add each arc
-    for (cap_it = ucap_map.begin(); cap_it != ucap_map.end(); ++cap_it) {
-      const Arc& a = cap_it->first;
-      std::vector<double>& ucaps = cap_it->second;
-      int arc_id = g_->arc_ids()[a];
+void ProgTranslator::AddEntries_(int g, int row, int faux_id, bool fill) {
+  ExchangeNodeGroup* grp = cg_->group(g);
+  bool request = cg_->is_request(g);
+  int n_caps = grp->capacities().size();
 
-      // add each unit capacity coefficient
-      for (int j = 0; j != ucaps.size(); j++) {
+  if (request && !grp->HasArcs())
+    return;
+
+  // capacity rows, with a unit capacity coefficient for each arc
+  for (int n = cg_->nodes_begin(g); n != cg_->nodes_end(g); n++) {
+    for (int i = cg_->arcs_begin(n); i != cg_->arcs_end(n); i++) {
+      int arc_id = cg_->node_arc(i);
+      bool excl = excl_ && cg_->exclusive(arc_id);
+      const double* ucaps = request ? cg_->ucaps(arc_id) :
+                                      cg_->vcaps(arc_id);
+      int n_ucaps = request ? cg_->n_ucaps(arc_id) : cg_->n_vcaps(arc_id);
+      for (int j = 0; j != n_ucaps; j++) {
         double coeff = ucaps[j];
-        if (excl_ && a.exclusive()) {
-          coeff *= a.excl_val();
+        if (excl) {
+          coeff *= cg_->excl_val(arc_id);
         }
-
-        cap_rows[j].insert(arc_id, coeff);
-      }
-
-      if (request) {
-        CheckPref(a.pref());
-        ctx_.obj_coeffs[arc_id] = ExchangeSolver::Cost(a, excl_);
-        ctx_.col_lbs[arc_id] = 0;
-        ctx_.col_ubs[arc_id] = (excl_ && a.exclusive()) ? 1 :
-                               std::min(nodes[i]->qty, inf);
+        AddEntry_(row + j, arc_id, coeff, fill);
       }
     }
   }
-
-  int faux_id;
   if (request) {
-    faux_id = arc_offset_++;
-  }
-
-  // add all capacity rows
-  for (int i = 0; i != cap_rows.size(); i++) {
-    if (request) {
-      cap_rows[i].insert(faux_id, 1.0);  // faux arc
+    for (int j = 0; j != n_caps; j++) {
+      AddEntry_(row + j, faux_id, 1.0, fill);  // faux arc
     }
-
-    // 1e15 is the largest value that doesn't make the solver fall over
-    // (by emperical testing)
-    double rlb = std::min(caps[i], 1e15);
-    ctx_.row_lbs.push_back(request ? rlb : 0);
-    ctx_.row_ubs.push_back(request ? inf : caps[i]);
-    ctx_.m.appendRow(cap_rows[i]);
   }
+  row += n_caps;
 
   if (excl_) {
-    // add exclusive arcs
+    // exclusive rows, over all arcs of each exclusive group's nodes
     std::vector< std::vector<ExchangeNode::Ptr> >& exngs =
         grp->excl_node_groups();
     for (int i = 0; i != exngs.size(); i++) {
-      CoinPackedVector excl_row;
+      if (ExclArcs_(exngs[i]) == 0) {
+        continue;
+      }
       std::vector<ExchangeNode::Ptr>& nodes = exngs[i];
       for (int j = 0; j != nodes.size(); j++) {
-        std::vector<Arc>& arcs = g_->node_arc_map()[nodes[j]];
-        for (int k = 0; k != arcs.size(); k++) {
-          excl_row.insert(g_->arc_ids()[arcs[k]], 1.0);
+        int n = cg_->node_index(nodes[j].get());
+        for (int k = cg_->arcs_begin(n); k != cg_->arcs_end(n); k++) {
+          AddEntry_(row, cg_->node_arc(k), 1.0, fill);
         }
       }
-      if (excl_row.getNumElements() > 0) {
-        excl_rows.push_back(excl_row);
-      }
-    }
-
-    // add all exclusive rows
-    for (int i = 0; i != excl_rows.size(); i++) {
-      ctx_.row_lbs.push_back(0.0);
-      ctx_.row_ubs.push_back(1.0);
-      ctx_.m.appendRow(excl_rows[i]);
+      row++;
     }
   }
 }
 
 void ProgTranslator::FromProg() {
   const double* sol = iface_->getColSolution();
-  std::vector<Arc>& arcs = g_->arcs();
   double flow;
-  for (int i = 0; i < arcs.size(); i++) {
-    Arc& a = g_->arc_by_id().at(i);
+  for (int i = 0; i < cg_->n_arcs(); i++) {
     flow = sol[i];
-    flow = (excl_ && a.exclusive()) ? flow * a.excl_val() : flow;
+    flow = (excl_ && cg_->exclusive(i)) ? flow * cg_->excl_val(i) : flow;
     if (flow > cyclus::eps()) {
-      g_->AddMatch(a, flow);
+      g_->AddMatch(cg_->arc(i), flow);
     }
   }
 }
@@ -6,21 +6,26 @@
 #include <vector>
 
 #include "CoinPackedMatrix.hpp"
+#include "compact_graph.h"
 
 class OsiSolverInterface;
 
 namespace cyclus {
 
-class ExchangeGraph;
-class ExchangeNodeGroup;
-
 /// @brief struct to hold all problem instance state
+///
+/// The constraint matrix is stored column-major: the entries of column i are
+/// elements[k] in rows row_inds[k] for k in [col_starts[i], col_starts[i+1]).
+/// m holds a copy of the same matrix.
 struct ProgTranslatorContext {
   std::vector<double> obj_coeffs;
   std::vector<double> row_ubs;
   std::vector<double> row_lbs;
   std::vector<double> col_ubs;
   std::vector<double> col_lbs;
+  std::vector<CoinBigIndex> col_starts;
+  std::vector<int> row_inds;
+  std::vector<double> elements;
   CoinPackedMatrix m;
 };
 
@@ -49,12 +54,16 @@ class ProgTranslator {
   /// @param iface the solver interface
   /// @param exclusive whether or not to include binary-valued arcs
   /// @param pseudo_cost the cost to use for faux arcs
+  /// @param cg a CompactGraph snapshot of g to translate from, which is built
+  /// if not given
   ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface);
   ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface, bool exclusive);
   ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                  double pseudo_cost);
   ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                  bool exclusive, double pseudo_cost);
+  ProgTranslator(ExchangeGraph* g, CompactGraph::Ptr cg,
+                 OsiSolverInterface* iface, bool exclusive, double pseudo_cost);
 
   /// @brief translates the graph, filling the translators Context
   void Translate();
@@ -78,16 +87,41 @@ class ProgTranslator {
   /// @throws if preference is unsatisfactory (i.e., not greater than 0)
   void CheckPref(double pref);
 
-  /// perform all translation for a node group
-  /// @param grp a pointer to the node group
-  /// @param req a boolean flag, true if grp is a request group
-  void XlateGrp_(ExchangeNodeGroup* grp, bool req);
+  /// adds the variable bounds, objective coefficients, and row bounds for a
+  /// node group
+  /// @param g the CompactGraph index of the node group
+  void XlateGrp_(int g);
+
+  /// adds the matrix entries for the rows of a node group
+  /// @param g the CompactGraph index of the node group
+  /// @param row the index of the group's first row
+  /// @param faux_id the group's faux arc, if it is a request group
+  /// @param fill if false, the entries are only counted in col_starts
+  void AddEntries_(int g, int row, int faux_id, bool fill);
+
+  inline void AddEntry_(int row, int col, double val, bool fill) {
+    if (!fill) {
+      ctx_.col_starts[col + 1]++;
+    } else {
+      CoinBigIndex k = next_[col]++;
+      ctx_.row_inds[k] = row;
+      ctx_.elements[k] = val;
+    }
+  }
+
+  /// @return the number of arcs of an exclusive group's nodes
+  int ExclArcs_(const std::vector<ExchangeNode::Ptr>& nodes);
 
   ExchangeGraph* g_;
+  /// index-based view of g_, taken when the translator is constructed unless
+  /// one is given
+  CompactGraph::Ptr cg_;
   OsiSolverInterface* iface_;
   bool excl_;
   int arc_offset_;
   ProgTranslatorContext ctx_;
+  /// the next free position of each column while filling the matrix
+  std::vector<CoinBigIndex> next_;
   double pseudo_cost_;
 };
 
@@ -10,6 +10,21 @@
 
 namespace cyclus {
 
+// the buffer (if any) that Datum objects created on this thread go to
+static thread_local DatumBuffer* bound_buf = NULL;
+
+DatumBuffer::~DatumBuffer() {
+  Clear();
+}
+
+void DatumBuffer::Clear() {
+  for (int i = 0; i < created.size(); ++i) {
+    delete created[i];
+  }
+  created.clear();
+  recorded.clear();
+}
+
 Recorder::Recorder() : index_(0), inject_sim_id_(true) {
   uuid_ = boost::uuids::random_generator()();
   set_dump_count(kDefaultDumpCount);
@@ -67,6 +82,15 @@ void Recorder::set_dump_count(unsigned int count) {
 }
 
 Datum* Recorder::NewDatum(std::string title) {
+  if (bound_buf != NULL) {
+    Datum* d = new Datum(this, title);
+    if (inject_sim_id_) {
+      d->AddVal("SimId", uuid_);
+    }
+    bound_buf->created.push_back(d);
+    return d;
+  }
+
   Datum* d = data_[index_];
   d->title_ = title;
   if (inject_sim_id_) {
@@ -84,11 +108,32 @@ Datum* Recorder::NewDatum(std::string title) {
 }
 
 void Recorder::AddDatum(Datum* d) {
+  if (bound_buf != NULL) {
+    bound_buf->recorded.push_back(d);
+    return;
+  }
+
   if (index_ >= data_.size()) {
     NotifyBackends();
   }
 }
 
+void Recorder::BindBuffer(DatumBuffer* buf) {
+  bound_buf = buf;
+}
+
+void Recorder::Merge(DatumBuffer* buf) {
+  for (int i = 0; i < buf->recorded.size(); ++i) {
+    Datum* src = buf->recorded[i];
+    Datum* d = NewDatum(src->title_);
+    d->vals_ = src->vals_;
+    d->shapes_ = src->shapes_;
+    d->fields_ = src->fields_;
+    d->Record();
+  }
+  buf->Clear();
+}
+
 void Recorder::Flush() {
   if (index_ == 0)
     return;
@@ -17,6 +17,29 @@ class RecBackend;
 
 typedef std::vector<Datum*> DatumList;
 
+/// Holds the Datum objects created and recorded on a thread while that thread
+/// is bound to the buffer via Recorder::BindBuffer. The buffered data is
+/// written out by passing the buffer to Recorder::Merge.
+class DatumBuffer {
+ public:
+  DatumBuffer() {}
+  ~DatumBuffer();
+
+  /// Deletes all buffered Datum objects.
+  void Clear();
+
+  /// every Datum object created while bound, recorded or not
+  DatumList created;
+
+  /// the Datum objects that were recorded while bound, in recording order
+  DatumList recorded;
+
+ private:
+  // buffers own their data and must not be copied
+  DatumBuffer(const DatumBuffer&);
+  DatumBuffer& operator=(const DatumBuffer&);
+};
+
 /// default number of Datum objects to collect before flushing to backends.
 static unsigned int const kDefaultDumpCount = 10000;
 
@@ -100,6 +123,18 @@ class Recorder {
   /// (e.g. the same table).
   Datum* NewDatum(std::string title);
 
+  /// Redirects all Datum objects created and recorded on the calling thread
+  /// into buf instead of the shared recorder buffer, which is not thread
+  /// safe.  This allows agents running on worker threads to record output;
+  /// the buffered data is written later, from a single thread, with Merge.
+  /// Passing NULL restores normal recording for the calling thread.
+  static void BindBuffer(DatumBuffer* buf);
+
+  /// Records every Datum object in buf that was recorded while buf was bound,
+  /// in the order it was recorded, and then clears buf. This must not be
+  /// called while any thread is bound to buf.
+  void Merge(DatumBuffer* buf);
+
   /// Registers b to receive Datum notifications for all Datum objects collected
   /// by the Recorder and to receive a flush notification when there
   /// are no more Datum objects.
@@ -8,6 +8,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
+#include "arena.h"
+
 namespace cyclus {
 
 class Material;
@@ -117,6 +119,9 @@ template <class T> class Request {
   inline cost_function_t cost_function() const { return cost_function_; }
 
  private:
+  /// portfolios allocate their requests in an arena
+  friend class Arena<Request<T>>;
+
   /// @brief constructors are private to require use of factory methods
   Request(boost::shared_ptr<T> target, Trader* requester, std::string commodity,
           double preference, bool exclusive, cost_function_t cost_function)
@@ -10,6 +10,7 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include "arena.h"
 #include "capacity_constraint.h"
 #include "error.h"
 #include "logger.h"
@@ -82,6 +83,9 @@ template <class T> struct QtyCoeffConverter : public Converter<T> {
 /// determine the demand as "met". In this case, the total demand is 9.5, the
 /// MOX order is given a coefficient of 9.5 / 10, and the UOX order is given a
 /// coefficient of 9.5 / 9.
+///
+/// Requests are allocated together in an Arena owned by the portfolio and are
+/// freed all at once with it.
 template <class T>
 class RequestPortfolio
     : public boost::enable_shared_from_this<RequestPortfolio<T>> {
@@ -92,14 +96,6 @@ class RequestPortfolio
 
   RequestPortfolio() : requester_(NULL), qty_(0) {}
 
-  /// deletes all requests associated with it
-  ~RequestPortfolio() {
-    typename std::vector<Request<T>*>::iterator it;
-    for (it = requests_.begin(); it != requests_.end(); ++it) {
-      delete *it;
-    }
-  }
-
   /// @brief add a request to the portfolio
   /// @param target the target resource associated with this request
   /// @param requester the requester
@@ -116,10 +112,9 @@ class RequestPortfolio
   Request<T>* AddRequest(boost::shared_ptr<T> target, Trader* requester,
                          std::string commodity, double preference,
                          bool exclusive, cost_function_t cost_function) {
-    Request<T>* r =
-        Request<T>::Create(target, requester, this->shared_from_this(),
-                           commodity, preference, exclusive, cost_function);
-    VerifyRequester_(r);
+    VerifyRequester_(requester);
+    Request<T>* r = arena_.New(target, requester, this->shared_from_this(),
+                               commodity, preference, exclusive, cost_function);
     requests_.push_back(r);
     mass_coeffs_[r] = 1;
     qty_ += target->quantity();
@@ -194,16 +189,7 @@ class RequestPortfolio
  private:
   /// @brief copy constructor is private to prevent copying and preserve
   /// explicit single-ownership of requests
-  RequestPortfolio(const RequestPortfolio& rhs) {
-    requester_ = rhs.requester_;
-    requests_ = rhs.requests_;
-    constraints_ = rhs.constraints_;
-    qty_ = rhs.qty_;
-    typename std::vector<Request<T>*>::iterator it;
-    for (it = requests_.begin(); it != requests_.end(); ++it) {
-      it->get()->set_portfolio(this->shared_from_this());
-    }
-  }
+  RequestPortfolio(const RequestPortfolio& rhs);
 
   /// @brief if the requester has not been determined yet, it is set. otherwise
   /// VerifyRequester() verifies the the request is associated with the
@@ -211,15 +197,18 @@ class RequestPortfolio
   /// requester
   /// @throws KeyError if a request is added from a different requester than the
   /// original
-  void VerifyRequester_(const Request<T>* r) {
+  void VerifyRequester_(Trader* requester) {
     if (requester_ == NULL) {
-      requester_ = r->requester();
-    } else if (requester_ != r->requester()) {
+      requester_ = requester;
+    } else if (requester_ != requester) {
       std::string msg = "Insertion error: requesters do not match.";
       throw KeyError(msg);
     }
   }
 
+  /// owns the requests
+  Arena<Request<T>> arena_;
+
   /// requests_ is a vector because many requests may be identical, i.e., a set
   /// is not appropriate
   std::vector<Request<T>*> requests_;
@@ -2,12 +2,11 @@
 
 namespace cyclus {
 
-int Resource::nextstate_id_ = 1;
-int Resource::nextobj_id_ = 1;
+IdSeq Resource::nextstate_id_(IdSeq::kResourceStates, 1);
+IdSeq Resource::nextobj_id_(IdSeq::kResourceObjs, 1);
 
 void Resource::BumpStateId() {
-  state_id_ = nextstate_id_;
-  nextstate_id_++;
+  state_id_ = nextstate_id_++;
 }
 
 }  // namespace cyclus
@@ -7,6 +7,7 @@
 
 #include "package.h"
 #include "cyc_limits.h"
+#include "id_seq.h"
 
 class SimInitTest;
 
@@ -107,8 +108,10 @@ class Resource {
   std::vector<typename T::Ptr> Package(Package::Ptr pkg);
 
  private:
-  static int nextstate_id_;
-  static int nextobj_id_;
+  // resources may be created concurrently by thread safe time listeners and
+  // re-entrant traders, see IdSeq
+  static IdSeq nextstate_id_;
+  static IdSeq nextobj_id_;
   int state_id_;
   // Setting the state id should only be done when extracting one resource
   void state_id(int st_id) {
@@ -3,14 +3,21 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
+#include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "bid_portfolio.h"
 #include "context.h"
 #include "exchange_context.h"
+#include "id_seq.h"
 #include "product.h"
 #include "material.h"
+#include "recorder.h"
 #include "request_portfolio.h"
+#include "thread_pool.h"
 #include "trader.h"
 #include "trader_management.h"
 
@@ -57,6 +64,23 @@ inline static void AdjustPrefs(Trader* t, PrefMap<Product>::type& prefs) {
 /// exchng.AddAllBids();
 /// exchng.AdjustAll();
 /// @endcode
+///
+/// If the simulation enables parallel exchange and runs with more than one
+/// thread, traders whose archetype carries a true "reentrant" annotation are
+/// queried for requests and bids concurrently. A re-entrant trader's
+/// GetMatlRequests/GetMatlBids (or product equivalents) must not modify state
+/// shared with other agents and must only read the commodity request map
+/// (e.g. with find or at rather than operator[]). Each such trader's
+/// portfolios and recorded data are kept in a separate shard until all
+/// queries finish, and the shards are merged in the same trader order used
+/// by the serial path, so the collected exchange is identical either way.
+/// Resources and compositions created by re-entrant traders are numbered
+/// from per-trader id blocks (see IdBlocks), so their ids do not depend on
+/// the number of threads either.
+///
+/// Traders that subscribed to bid on specific commodities (see
+/// Context::SubscribeBids) are only asked for bids when one of those
+/// commodities has been requested.
 template <class T>
 class ResourceExchange {
  public:
@@ -65,6 +89,8 @@ class ResourceExchange {
   /// @param ctx the simulation context
   ResourceExchange(Context* ctx) {
     sim_ctx_ = ctx;
+    parallel_ = ctx->sim_info().parallel_exchange;
+    pool_ = parallel_ ? ctx->thread_pool() : NULL;
   }
 
   inline ExchangeContext<T>& ex_ctx() {
@@ -72,8 +98,34 @@ class ResourceExchange {
   }
 
   /// @brief queries traders and collects all requests for bids
-  void AddAllRequests() {
+  ///
+  /// @param id_hints the ids used by each re-entrant trader in previous
+  /// request queries, updated by this one (see IdBlocks). May be NULL.
+  void AddAllRequests(IdHints* id_hints = NULL) {
     InitTraders();
+    if (reentrant_.size() > 1) {
+      std::vector<std::set<typename RequestPortfolio<T>::Ptr> > shards(
+          reentrant_.size());
+      std::vector<DatumBuffer> bufs(reentrant_.size());
+      IdBlocks ids(ReentrantIds_(), id_hints);
+      ForEachShard_(std::bind(&cyclus::ResourceExchange<T>::QueryRequestShard_,
+                              this, &shards, &bufs, &ids,
+                              std::placeholders::_1));
+
+      int next = 0;
+      typename std::set<Trader*, trader_compare>::iterator it;
+      for (it = traders_.begin(); it != traders_.end(); ++it) {
+        if (next < reentrant_.size() && *it == reentrant_[next]) {
+          sim_ctx_->MergeDatums(&bufs[next]);
+          AddRequestPortfolios_(shards[next]);
+          next++;
+        } else {
+          AddRequests_(*it);
+        }
+      }
+      return;
+    }
+
     std::for_each(
         traders_.begin(),
         traders_.end(),
@@ -83,17 +135,54 @@ class ResourceExchange {
   }
 
   /// @brief queries traders and collects all responses to requests for bids
-  void AddAllBids() {
+  ///
+  /// @param id_hints the ids used by each re-entrant trader in previous bid
+  /// queries, updated by this one (see IdBlocks). May be NULL.
+  void AddAllBids(IdHints* id_hints = NULL) {
     InitTraders();
+    std::vector<Trader*> bidders = Bidders_();
+    if (reentrant_.size() > 1) {
+      std::vector<bool> asked(reentrant_.size(), false);
+      for (int i = 0; i < bidders.size(); ++i) {
+        std::map<Trader*, int>::iterator r = reentrant_pos_.find(bidders[i]);
+        if (r != reentrant_pos_.end()) {
+          asked[r->second] = true;
+        }
+      }
+
+      std::vector<std::set<typename BidPortfolio<T>::Ptr> > shards(
+          reentrant_.size());
+      std::vector<DatumBuffer> bufs(reentrant_.size());
+      IdBlocks ids(ReentrantIds_(), id_hints);
+      ForEachShard_(std::bind(&cyclus::ResourceExchange<T>::QueryBidShard_,
+                              this, &shards, &bufs, &ids, &asked,
+                              std::placeholders::_1));
+
+      for (int i = 0; i < bidders.size(); ++i) {
+        std::map<Trader*, int>::iterator r = reentrant_pos_.find(bidders[i]);
+        if (r != reentrant_pos_.end()) {
+          sim_ctx_->MergeDatums(&bufs[r->second]);
+          AddBidPortfolios_(shards[r->second]);
+        } else {
+          AddBids_(bidders[i]);
+        }
+      }
+      return;
+    }
+
     std::for_each(
-        traders_.begin(),
-        traders_.end(),
+        bidders.begin(),
+        bidders.end(),
         std::bind(&cyclus::ResourceExchange<T>::AddBids_,
                      this,
                      std::placeholders::_1));
   }
 
-  /// @brief adjust preferences for requests given bid responses
+  /// @brief adjust preferences for requests given bid responses. Each
+  /// requester adjusts the preferences of its requests, followed by each of
+  /// its ancestors (e.g., institutions and regions), nearest first. The
+  /// preferences are handed to them as a PrefMap built from, and stored back
+  /// into, the exchange context's arc preferences.
   void AdjustAll() {
     InitTraders();
     std::set<Trader*> traders = ex_ctx_.requesters;
@@ -118,13 +207,104 @@ class ResourceExchange {
       for (it = orig.begin(); it != orig.end(); ++it) {
         traders_.insert(*it);
       }
+
+      const std::map<Trader*, std::set<std::string> >& subs =
+          sim_ctx_->bid_commods();
+      std::map<std::string, bool> specs;
+      typename std::set<Trader*, trader_compare>::iterator t;
+      for (t = traders_.begin(); t != traders_.end(); ++t) {
+        if (subs.count(*t) == 0) {
+          unsubscribed_.push_back(*t);
+        }
+        if (parallel_ && IsReentrant(*t, &specs)) {
+          reentrant_pos_[*t] = reentrant_.size();
+          reentrant_.push_back(*t);
+        }
+      }
+    }
+  }
+
+  /// @brief returns the traders to ask for bids, in traders_ order: every
+  /// trader without bid subscriptions, and the subscribers of each requested
+  /// commodity (see Context::commod_bidders)
+  std::vector<Trader*> Bidders_() const {
+    const std::map<std::string, std::set<Trader*> >& index =
+        sim_ctx_->commod_bidders();
+    std::set<Trader*, trader_compare> subscribed;
+    typename CommodMap<T>::type::const_iterator c;
+    for (c = ex_ctx_.commod_requests.begin();
+         c != ex_ctx_.commod_requests.end(); ++c) {
+      std::map<std::string, std::set<Trader*> >::const_iterator it =
+          index.find(c->first);
+      if (it == index.end()) {
+        continue;
+      }
+      std::set<Trader*>::const_iterator t;
+      for (t = it->second.begin(); t != it->second.end(); ++t) {
+        if (traders_.count(*t) > 0) {
+          subscribed.insert(*t);
+        }
+      }
+    }
+
+    std::vector<Trader*> bidders;
+    bidders.reserve(unsubscribed_.size() + subscribed.size());
+    std::merge(unsubscribed_.begin(), unsubscribed_.end(), subscribed.begin(),
+               subscribed.end(), std::back_inserter(bidders),
+               trader_compare());
+    return bidders;
+  }
+
+  /// @brief returns the manager id of each re-entrant trader
+  std::vector<int> ReentrantIds_() const {
+    std::vector<int> ids(reentrant_.size());
+    for (int i = 0; i < reentrant_.size(); ++i) {
+      ids[i] = reentrant_[i]->manager()->id();
     }
+    return ids;
+  }
+
+  /// @brief calls f for each re-entrant trader index, on the pool if there
+  /// is one. Without a pool the shards are still queried separately, so that
+  /// the exchange is the same for any number of threads.
+  void ForEachShard_(const std::function<void(int)>& f) {
+    if (pool_ != NULL) {
+      pool_->ParallelFor(reentrant_.size(), f);
+      return;
+    }
+    for (int i = 0; i < reentrant_.size(); ++i) {
+      f(i);
+    }
+  }
+
+  /// @brief returns true if the trader's archetype is annotated as
+  /// re-entrant, caching the answer per archetype spec
+  static bool IsReentrant(Trader* t, std::map<std::string, bool>* specs) {
+    Agent* a = t->manager();
+    if (a == NULL) {
+      return false;
+    }
+
+    std::string spec = a->spec();
+    std::map<std::string, bool>::iterator it = specs->find(spec);
+    if (it != specs->end()) {
+      return it->second;
+    }
+
+    Json::Value safe = a->annotations().get("reentrant", false);
+    bool reentrant = safe.isBool() && safe.asBool();
+    (*specs)[spec] = reentrant;
+    return reentrant;
   }
 
   /// @brief queries a given facility agent for
   void AddRequests_(Trader* t) {
-    std::set<typename RequestPortfolio<T>::Ptr> rp = QueryRequests<T>(t);
-    typename std::set<typename RequestPortfolio<T>::Ptr>::iterator it;
+    AddRequestPortfolios_(QueryRequests<T>(t));
+  }
+
+  void AddRequestPortfolios_(
+      const std::set<typename RequestPortfolio<T>::Ptr>& rp) {
+    typename std::set<typename RequestPortfolio<T>::Ptr>::const_iterator it;
     for (it = rp.begin(); it != rp.end(); ++it) {
       ex_ctx_.AddRequestPortfolio(*it);
     }
@@ -132,24 +312,68 @@ class ResourceExchange {
 
   /// @brief queries a given facility agent for
   void AddBids_(Trader* t) {
-    std::set<typename BidPortfolio<T>::Ptr> bp =
-        QueryBids<T>(t, ex_ctx_.commod_requests);
-    typename std::set<typename BidPortfolio<T>::Ptr>::iterator it;
+    AddBidPortfolios_(QueryBids<T>(t, ex_ctx_.commod_requests));
+  }
+
+  void AddBidPortfolios_(const std::set<typename BidPortfolio<T>::Ptr>& bp) {
+    typename std::set<typename BidPortfolio<T>::Ptr>::const_iterator it;
     for (it = bp.begin(); it != bp.end(); ++it) {
       ex_ctx_.AddBidPortfolio(*it);
     }
   }
 
+  /// @brief queries the ith re-entrant trader for requests on a worker
+  /// thread, keeping its portfolios and recorded data in the ith shard
+  void QueryRequestShard_(
+      std::vector<std::set<typename RequestPortfolio<T>::Ptr> >* shards,
+      std::vector<DatumBuffer>* bufs, IdBlocks* ids, int i) {
+    Recorder::BindBuffer(&(*bufs)[i]);
+    try {
+      ids->Run(i, [this, shards, i] {
+        (*shards)[i] = QueryRequests<T>(reentrant_[i]);
+      });
+    } catch (...) {
+      Recorder::BindBuffer(NULL);
+      throw;
+    }
+    Recorder::BindBuffer(NULL);
+  }
+
+  /// @brief queries the ith re-entrant trader for bids on a worker thread if
+  /// it is asked for bids, keeping its portfolios and recorded data in the ith
+  /// shard
+  void QueryBidShard_(
+      std::vector<std::set<typename BidPortfolio<T>::Ptr> >* shards,
+      std::vector<DatumBuffer>* bufs, IdBlocks* ids,
+      const std::vector<bool>* asked, int i) {
+    if (!(*asked)[i]) {
+      // later shards may be waiting on this one to finish
+      ids->Run(i, [] {});
+      return;
+    }
+    Recorder::BindBuffer(&(*bufs)[i]);
+    try {
+      ids->Run(i, [this, shards, i] {
+        (*shards)[i] = QueryBids<T>(reentrant_[i], ex_ctx_.commod_requests);
+      });
+    } catch (...) {
+      Recorder::BindBuffer(NULL);
+      throw;
+    }
+    Recorder::BindBuffer(NULL);
+  }
+
   /// @brief allows a trader and its parents to adjust any preferences in the
   /// system
   void AdjustPrefs_(Trader* t) {
-    typename PrefMap<T>::type& prefs = ex_ctx_.trader_prefs[t];
+    typename PrefMap<T>::type prefs = ex_ctx_.Prefs(t);
     AdjustPrefs(t, prefs);
     Agent* m = t->manager()->parent();
     while (m != NULL) {
       AdjustPrefs(m, prefs);
       m = m->parent();
     }
+    ex_ctx_.SetPrefs(t, prefs);
   }
 
   struct trader_compare {
@@ -170,6 +394,16 @@ class ResourceExchange {
   // exchange functions are called in a much closer to deterministic order.
   std::set<Trader*, trader_compare> traders_;
 
+  /// traders without bid subscriptions, in traders_ order
+  std::vector<Trader*> unsubscribed_;
+
+  /// re-entrant traders in traders_ order, and the position of each in it,
+  /// only filled in when parallel exchange is enabled
+  std::vector<Trader*> reentrant_;
+  std::map<Trader*, int> reentrant_pos_;
+
+  bool parallel_;
+  ThreadPool* pool_;
   Context* sim_ctx_;
   ExchangeContext<T> ex_ctx_;
 };
@@ -2,6 +2,8 @@
 
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
+#include "hybrid_solver.h"
+#include "network_solver.h"
 #include "platform.h"
 #include "prog_solver.h"
 #include "region.h"
@@ -102,17 +104,17 @@ void SimInit::Snapshot(Context* ctx) {
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Composition"))
-      ->AddVal("NextId", Composition::next_id_)
+      ->AddVal("NextId", Composition::next_id_.load())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceState"))
-      ->AddVal("NextId", Resource::nextstate_id_)
+      ->AddVal("NextId", Resource::nextstate_id_.load())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceObj"))
-      ->AddVal("NextId", Resource::nextobj_id_)
+      ->AddVal("NextId", Resource::nextobj_id_.load())
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
@@ -172,6 +174,48 @@ void SimInit::LoadInfo() {
   qr = b_->Query("InfoExplicitInv", NULL);
   si_.explicit_inventory = qr.GetVal<bool>("RecordInventory");
   si_.explicit_inventory_compact = qr.GetVal<bool>("RecordInventoryCompact");
+  try {
+    si_.explicit_inventory_interval = qr.GetVal<int>("RecordInventoryInterval");
+    si_.explicit_inventory_delta = qr.GetVal<bool>("RecordInventoryDelta");
+  } catch (std::exception err) {
+  }  // columns don't exist in older databases (okay)
+
+  try {
+    qr = b_->Query("InfoPhaseTimings", NULL);
+    si_.phase_timings = qr.GetVal<bool>("RecordPhaseTimings");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoFastForward", NULL);
+    si_.fast_forward = qr.GetVal<bool>("FastForward");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoThreads", NULL);
+    si_.threads = qr.GetVal<int>("Threads");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoExchange", NULL);
+    si_.incremental_exchange = qr.GetVal<bool>("IncrementalExchange");
+    si_.parallel_exchange = qr.GetVal<bool>("ParallelExchange");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoInternCompositions", NULL);
+    si_.intern_compositions = qr.GetVal<bool>("InternCompositions");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("InfoDecayOperators", NULL);
+    si_.decay_operator_mb = qr.GetVal<double>("MemoryMB");
+  } catch (std::exception err) {
+  }  // table doesn't exist (okay)
 
   ctx_->InitSim(si_);
 }
@@ -294,9 +338,11 @@ ExchangeSolver* SimInit::LoadGreedySolver(bool exclusive,
 ExchangeSolver* SimInit::LoadCoinSolver(bool exclusive,
                                         std::set<std::string> tables) {
 #if CYCLUS_HAS_COIN
-  ExchangeSolver* solver;
+  ProgSolver* solver;
   double timeout;
   bool verbose, mps;
+  bool lp = false;
+  bool persistent = false;
 
   std::string solver_info = "CoinSolverInfo";
   if (0 < tables.count(solver_info)) {
@@ -304,17 +350,42 @@ ExchangeSolver* SimInit::LoadCoinSolver(bool exclusive,
     timeout = qr.GetVal<double>("Timeout");
     verbose = qr.GetVal<bool>("Verbose");
     mps = qr.GetVal<bool>("Mps");
+    // old output databases may lack either column
+    try {
+      lp = qr.GetVal<bool>("Lp");
+    } catch (std::exception err) {}
+    try {
+      persistent = qr.GetVal<bool>("Persistent");
+    } catch (std::exception err) {}
   }
 
   // set timeout to default if input value is non-positive
   timeout = timeout <= 0 ? ProgSolver::kDefaultTimeout : timeout;
   solver = new ProgSolver("cbc", timeout, exclusive, verbose, mps);
+  solver->lp(lp);
+  solver->persistent(persistent);
   return solver;
 #else
   throw cyclus::Error("Cyclus was not compiled with COIN support, cannot load solver.");
 #endif
 }
 
+ExchangeSolver* SimInit::LoadHybridSolver(bool exclusive,
+                                          std::set<std::string> tables) {
+  double budget = -1;
+  std::string solver_info = "HybridSolverInfo";
+  if (0 < tables.count(solver_info)) {
+    QueryResult qr = b_->Query(solver_info, NULL);
+    if (qr.rows.size() > 0) {
+      budget = qr.GetVal<double>("Budget");
+    }
+  }
+
+  // set budget to default if input value is non-positive
+  budget = budget <= 0 ? HybridSolver::kDefaultBudget : budget;
+  return new HybridSolver(exclusive, budget);
+}
+
 void SimInit::LoadSolverInfo() {
   using std::set;
   using std::string;
@@ -322,6 +393,7 @@ void SimInit::LoadSolverInfo() {
   ExchangeSolver* solver;
   string solver_name;
   bool exclusive_orders;
+  bool decompose = false;
 
   // load in possible Solver info, needs to be optional to
   // maintain backwards compatibility, defaults above.
@@ -332,6 +404,9 @@ void SimInit::LoadSolverInfo() {
     if (qr.rows.size() > 0) {
       solver_name = qr.GetVal<string>("Solver");
       exclusive_orders = qr.GetVal<bool>("ExclusiveOrders");
+      try {
+        decompose = qr.GetVal<bool>("Decompose");
+      } catch (std::exception err) {}  // old output database
     }
   }
 
@@ -339,11 +414,16 @@ void SimInit::LoadSolverInfo() {
     solver = LoadGreedySolver(exclusive_orders, tables);
   } else if (solver_name == "coin-or") {
     solver = LoadCoinSolver(exclusive_orders, tables);
+  } else if (solver_name == "hybrid") {
+    solver = LoadHybridSolver(exclusive_orders, tables);
+  } else if (solver_name == "network") {
+    solver = new NetworkSolver(exclusive_orders);
   } else {
     throw ValueError("The name of the solver was not recognized, "
                      "got '" + solver_name + "'.");
   }
 
+  solver->decompose(decompose);
   ctx_->solver(solver);
 }
 
@@ -501,17 +581,24 @@ void SimInit::LoadBuildSched() {
 }
 
 void SimInit::LoadDecomSched() {
-  std::vector<Cond> conds;
-  conds.push_back(Cond("DecomTime", ">=", t_));
   QueryResult qr;
   try {
-    qr = b_->Query("DecomSchedule", &conds);
+    qr = b_->Query("DecomSchedule", NULL);
   } catch (std::exception err) {return;}  // table doesn't exist (okay)
 
+  // rows are replayed in the order they were recorded so that reschedules
+  // and cancellations (DecomTime -1) override earlier rows for the agent
   for (int i = 0; i < qr.rows.size(); ++i) {
     int t = qr.GetVal<int>("DecomTime", i);
     int agentid = qr.GetVal<int>("AgentId", i);
-    ctx_->SchedDecom(agents_[agentid], t);
+    std::map<int, Agent*>::iterator it = agents_.find(agentid);
+    if (it == agents_.end()) {
+      continue;  // already decommissioned
+    } else if (t >= t_) {
+      ctx_->SchedDecom(it->second, t);
+    } else {
+      ctx_->CancelDecom(it->second);
+    }
   }
 }
 
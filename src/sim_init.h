@@ -93,6 +93,8 @@ class SimInit {
   void* LoadPreconditioner(std::string name);
   ExchangeSolver* LoadGreedySolver(bool exclusive, std::set<std::string> tables);
   ExchangeSolver* LoadCoinSolver(bool exclusive, std::set<std::string> tables);
+  ExchangeSolver* LoadHybridSolver(bool exclusive,
+                                   std::set<std::string> tables);
   static Resource::Ptr LoadResource(Context* ctx, QueryableBackend* b, int resid);
   static Material::Ptr LoadMaterial(Context* ctx, QueryableBackend* b, int resid);
   static Product::Ptr LoadProduct(Context* ctx, QueryableBackend* b, int resid);
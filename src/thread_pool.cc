@@ -0,0 +1,111 @@
+#include "thread_pool.h"
+
+namespace cyclus {
+
+ThreadPool::ThreadPool(int nthreads)
+    : job_size_(0),
+      next_(0),
+      active_(0),
+      generation_(0),
+      stop_(false) {
+  for (int i = 1; i < nthreads; ++i) {
+    workers_.push_back(std::thread(&ThreadPool::Work, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (int i = 0; i < workers_.size(); ++i) {
+    workers_[i].join();
+  }
+}
+
+void ThreadPool::ParallelFor(int n, std::function<void(int)> f) {
+  if (n <= 0) {
+    return;
+  } else if (workers_.empty() || n == 1) {
+    for (int i = 0; i < n; ++i) {
+      f(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    job_ = f;
+    job_size_ = n;
+    next_ = 0;
+    err_ = std::exception_ptr();
+    generation_++;
+  }
+  start_cv_.notify_all();
+
+  Drain();
+
+  std::exception_ptr err;
+  {
+    // workers only join a job while indices remain, so once active_ drops to
+    // zero no thread can touch the job state again
+    std::unique_lock<std::mutex> lk(mtx_);
+    done_cv_.wait(lk, [this] { return active_ == 0; });
+    job_ = std::function<void(int)>();
+    err = err_;
+    err_ = std::exception_ptr();
+  }
+
+  if (err) {
+    std::rethrow_exception(err);
+  }
+}
+
+void ThreadPool::Work() {
+  unsigned int seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      start_cv_.wait(lk, [this, seen] {
+        return stop_ || generation_ != seen;
+      });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      if (next_ >= job_size_) {
+        continue;  // woke up too late, nothing left to do
+      }
+      active_++;
+    }
+
+    Drain();
+
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      active_--;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+void ThreadPool::Drain() {
+  while (true) {
+    int i = next_++;
+    if (i >= job_size_) {
+      return;
+    }
+
+    try {
+      job_(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lk(mtx_);
+      if (!err_) {
+        err_ = std::current_exception();
+      }
+    }
+  }
+}
+
+}  // namespace cyclus
@@ -0,0 +1,70 @@
+#ifndef CYCLUS_SRC_THREAD_POOL_H_
+#define CYCLUS_SRC_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cyclus {
+
+/// @class ThreadPool
+///
+/// @brief A ThreadPool owns a fixed set of worker threads that are used to
+/// evaluate independent pieces of kernel work concurrently. Work is submitted
+/// as an index range and the calling thread participates in the evaluation, so
+/// a pool of size n uses n - 1 background workers. The pool is used as follows:
+///
+/// @code
+/// ThreadPool pool(4);
+/// pool.ParallelFor(items.size(), [&](int i) { Process(items[i]); });
+/// @endcode
+///
+/// ParallelFor blocks until every index has been processed. If any call
+/// throws, the first exception caught is rethrown on the calling thread after
+/// all other indices have finished.
+class ThreadPool {
+ public:
+  /// @param nthreads the total number of threads (including the caller) to use
+  /// for each ParallelFor call. Values less than 2 result in serial execution.
+  explicit ThreadPool(int nthreads = 1);
+
+  ~ThreadPool();
+
+  /// @return the total number of threads used for each ParallelFor call
+  inline int size() const { return workers_.size() + 1; }
+
+  /// Calls f(i) for every i in [0, n), distributing the calls over the pool's
+  /// threads, and returns once all calls have completed.
+  ///
+  /// @warning ParallelFor is not reentrant: f must not call ParallelFor on
+  /// the same pool.
+  void ParallelFor(int n, std::function<void(int)> f);
+
+ private:
+  /// main loop of each background worker
+  void Work();
+
+  /// processes indices of the current job until none remain
+  void Drain();
+
+  std::vector<std::thread> workers_;
+  std::mutex mtx_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+
+  std::function<void(int)> job_;
+  int job_size_;
+  std::atomic<int> next_;
+  int active_;
+  unsigned int generation_;
+  bool stop_;
+  std::exception_ptr err_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_THREAD_POOL_H_
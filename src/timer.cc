@@ -1,6 +1,9 @@
 // Implements the Timer class
 #include "timer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -8,7 +11,9 @@
 #include "error.h"
 #include "logger.h"
 #include "pyhooks.h"
+#include "recorder.h"
 #include "sim_init.h"
+#include "trader.h"
 
 
 namespace cyclus {
@@ -29,16 +34,29 @@ void Timer::RunSim() {
     }
 
     // run through phases
+    PhaseTimer pt(timings_);
+    DoWake();
     DoBuild();
+    pt.Lap("Build");
     CLOG(LEV_INFO2) << "Beginning Tick for time: " << time_;
     DoTick();
+    pt.Lap("Tick");
     CLOG(LEV_INFO2) << "Beginning DRE for time: " << time_;
     DoResEx(&matl_manager, &genrsrc_manager);
+    pt.Lap("ResEx");
     CLOG(LEV_INFO2) << "Beginning Tock for time: " << time_;
     DoTock();
+    pt.Lap("Tock");
     CLOG(LEV_INFO2) << "Beginning Decision for time: " << time_;
     DoDecision();
+    pt.Lap("Decision");
     DoDecom();
+    DoSleep();
+    pt.Lap("Decom");
+
+    if (timings_ != NULL) {
+      timings_->Record(ctx_);
+    }
 
 #ifdef CYCLUS_WITH_PYTHON
     EventLoop();
@@ -49,6 +67,8 @@ void Timer::RunSim() {
     if (want_kill_) {
       break;
     }
+
+    FastForward(&matl_manager, &genrsrc_manager);
   }
 
   ctx_->NewDatum("Finish")
@@ -61,7 +81,17 @@ void Timer::RunSim() {
 
 void Timer::DoBuild() {
   // build queued agents
-  std::vector<std::pair<std::string, Agent*> > build_list = build_queue_[time_];
+  std::map<int, std::vector<std::pair<std::string, Agent*> > >::iterator it =
+      build_queue_.find(time_);
+  if (it == build_queue_.end()) {
+    return;
+  }
+  // builds can only be scheduled for future timesteps, so the cohort can be
+  // taken out of the queue without copying it
+  std::vector<std::pair<std::string, Agent*> > build_list;
+  build_list.swap(it->second);
+  build_queue_.erase(it);
+
   for (int i = 0; i < build_list.size(); ++i) {
     Agent* m = ctx_->CreateAgent<Agent>(build_list[i].first);
     Agent* parent = build_list[i].second;
@@ -76,14 +106,57 @@ void Timer::DoBuild() {
   }
 }
 
-void Timer::DoTick() {
-  for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
-       agent != tickers_.end();
-       agent++) {
-    agent->second->Tick();
+void Timer::DoSleep() {
+  for (int i = 0; i < to_sleep_.size(); ++i) {
+    int id = to_sleep_[i];
+    std::map<int, int>::iterator it = wake_time_.find(id);
+    if (it != wake_time_.end() && it->second > time_ + 1) {
+      Sleep(id);
+    }
+  }
+  to_sleep_.clear();
+}
+
+void Timer::DoWake() {
+  while (!wake_queue_.empty() && wake_queue_.top().first <= time_) {
+    std::pair<int, int> ev = wake_queue_.top();
+    wake_queue_.pop();
+    std::map<int, int>::iterator it = wake_time_.find(ev.second);
+    if (it == wake_time_.end() || it->second != ev.first) {
+      continue;  // rescheduled or unregistered since this was queued
+    }
+    wake_time_.erase(it);
+    std::map<int, TimeListener*>::iterator tl = tickers_.find(ev.second);
+    if (tl != tickers_.end()) {
+      Wake(tl->second);
+    }
+  }
+}
+
+void Timer::Wake(TimeListener* tl) {
+  int id = tl->id();
+  int phases = phases_[id];
+  if (phases & kTickPhase) {
+    tick_listeners_[id] = tl;
+  }
+  if (phases & kTockPhase) {
+    tock_listeners_[id] = tl;
+  }
+  if (phases & kDecisionPhase) {
+    decision_listeners_[id] = tl;
   }
 }
 
+void Timer::Sleep(int id) {
+  tick_listeners_.erase(id);
+  tock_listeners_.erase(id);
+  decision_listeners_.erase(id);
+}
+
+void Timer::DoTick() {
+  Dispatch(tick_listeners_, &TimeListener::Tick, "Tick");
+}
+
 void Timer::DoResEx(ExchangeManager<Material>* matmgr,
                     ExchangeManager<Product>* genmgr) {
   matmgr->Execute();
@@ -91,55 +164,267 @@ void Timer::DoResEx(ExchangeManager<Material>* matmgr,
 }
 
 void Timer::DoTock() {
-  for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
-       agent != tickers_.end();
-       agent++) {
-    agent->second->Tock();
-  }
-
-  if (si_.explicit_inventory || si_.explicit_inventory_compact) {
-    std::set<Agent*> ags = ctx_->agent_list_;
-    std::set<Agent*>::iterator it;
-    for (it = ags.begin(); it != ags.end(); ++it) {
-      Agent* a = *it;
-      if (a->enter_time() == -1) {
-        continue; // skip agents that aren't alive
+  Dispatch(tock_listeners_, &TimeListener::Tock, "Tock");
+
+  if ((si_.explicit_inventory || si_.explicit_inventory_compact ||
+       si_.explicit_inventory_delta) &&
+      time_ % si_.explicit_inventory_interval == 0) {
+    RecordInventories();
+  }
+}
+
+void Timer::DoDecision() {
+  Dispatch(decision_listeners_, &TimeListener::Decision, "Decision");
+}
+
+void Timer::Dispatch(const std::map<int, TimeListener*>& listeners,
+                     void (TimeListener::*phase)(), const std::string& name) {
+  std::map<int, TimeListener*>::const_iterator agent;
+  if (threadsafe_.empty()) {
+    for (agent = listeners.begin(); agent != listeners.end(); agent++) {
+      Call(agent->second, phase, name);
+    }
+    return;
+  }
+
+  // Serial listeners keep their place in the id ordering; only runs of
+  // consecutive thread safe listeners are executed together.
+  std::vector<TimeListener*> batch;
+  for (agent = listeners.begin(); agent != listeners.end(); agent++) {
+    if (threadsafe_.count(agent->first) > 0) {
+      batch.push_back(agent->second);
+      continue;
+    }
+    DispatchConcurrent(batch, phase, name);
+    batch.clear();
+    Call(agent->second, phase, name);
+  }
+  DispatchConcurrent(batch, phase, name);
+}
+
+static std::string PrototypeOf(TimeListener* tl) {
+  Agent* a = dynamic_cast<Agent*>(tl);
+  return a == NULL ? "" : a->prototype();
+}
+
+void Timer::Call(TimeListener* tl, void (TimeListener::*phase)(),
+                 const std::string& name) {
+  if (timings_ == NULL) {
+    (tl->*phase)();
+    return;
+  }
+
+  PhaseTimer pt(timings_);
+  (tl->*phase)();
+  pt.Lap(name, PrototypeOf(tl));
+}
+
+static void RunBuffered(const std::vector<TimeListener*>* batch,
+                        std::vector<DatumBuffer>* bufs,
+                        std::vector<double>* secs, IdBlocks* ids,
+                        void (TimeListener::*phase)(), int i) {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start;
+  if (secs != NULL) {
+    start = Clock::now();
+  }
+
+  Recorder::BindBuffer(&(*bufs)[i]);
+  try {
+    ids->Run(i, std::bind(phase, (*batch)[i]));
+  } catch (...) {
+    Recorder::BindBuffer(NULL);
+    throw;
+  }
+  Recorder::BindBuffer(NULL);
+
+  if (secs != NULL) {
+    (*secs)[i] = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+}
+
+void Timer::DispatchConcurrent(const std::vector<TimeListener*>& batch,
+                               void (TimeListener::*phase)(),
+                               const std::string& name) {
+  // without a pool thread safe listeners run like any others, so their ids
+  // are the same as if they were not annotated
+  if (batch.size() < 2 || pool_ == NULL) {
+    for (int i = 0; i < batch.size(); ++i) {
+      Call(batch[i], phase, name);
+    }
+    return;
+  }
+
+  // Resources and compositions created by the batch are numbered from
+  // per-listener id blocks, so they are the same for any number of worker
+  // threads.
+  std::vector<int> keys(batch.size());
+  for (int i = 0; i < batch.size(); ++i) {
+    keys[i] = batch[i]->id();
+  }
+  IdBlocks ids(keys, &id_hints_[name]);
+
+  // PhaseTimings is not thread safe, so workers only fill in their own slot
+  std::vector<DatumBuffer> bufs(batch.size());
+  std::vector<double> secs(batch.size());
+  std::function<void(int)> run =
+      std::bind(&RunBuffered, &batch, &bufs, timings_ == NULL ? NULL : &secs,
+                &ids, phase, std::placeholders::_1);
+  pool_->ParallelFor(batch.size(), run);
+
+  // batch is in id order, so this keeps the output deterministic
+  for (int i = 0; i < bufs.size(); ++i) {
+    ctx_->rec_->Merge(&bufs[i]);
+    if (timings_ != NULL) {
+      timings_->Add(name, secs[i], PrototypeOf(batch[i]));
+    }
+  }
+}
+
+bool Timer::IsThreadSafe(TimeListener* tl) {
+  Agent* a = dynamic_cast<Agent*>(tl);
+  if (a == NULL) {
+    return false;
+  }
+
+  std::string spec = a->spec();
+  std::map<std::string, bool>::iterator it = threadsafe_specs_.find(spec);
+  if (it != threadsafe_specs_.end()) {
+    return it->second;
+  }
+
+  Json::Value safe = a->annotations().get("threadsafe", false);
+  bool threadsafe = safe.isBool() && safe.asBool();
+  threadsafe_specs_[spec] = threadsafe;
+  return threadsafe;
+}
+
+void Timer::RecordInventories() {
+  InvCache next;
+  std::set<Agent*> ags = ctx_->agent_list_;
+  std::set<Agent*>::iterator it;
+  for (it = ags.begin(); it != ags.end(); ++it) {
+    Agent* a = *it;
+    if (a->enter_time() == -1) {
+      continue; // skip agents that aren't alive
+    }
+    RecordInventories(a, &next);
+  }
+
+  if (si_.explicit_inventory_delta) {
+    // inventories that were emptied or whose agents were decommissioned
+    InvCache::iterator prev;
+    for (prev = inv_cache_.begin(); prev != inv_cache_.end(); ++prev) {
+      if (next.count(prev->first) > 0) {
+        continue;
       }
-      RecordInventories(a);
+      ctx_->NewDatum("ExplicitInventoryDelta")
+          ->AddVal("AgentId", prev->first.first)
+          ->AddVal("Time", time_)
+          ->AddVal("InventoryName", prev->first.second)
+          ->AddVal("Quantity", 0.0)
+          ->AddVal("Units", prev->second.units)
+          ->AddVal("Composition", CompMap())
+          ->Record();
     }
   }
+
+  inv_cache_.swap(next);
 }
 
-void Timer::DoDecision() {
-  for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
-       agent != tickers_.end();
-       agent++) {
-    agent->second->Decision();
+void Timer::Summarize(const std::vector<Resource::Ptr>& mats, bool lazy,
+                      InvSummary* s) {
+  std::vector<Material::Ptr> ms;
+  for (int i = 0; i < mats.size(); ++i) {
+    Material::Ptr m = ResCast<Material>(mats[i]);
+    if (lazy) {
+      m = ResCast<Material>(m->Clone());
+    }
+    ms.push_back(m);
+  }
+  if (lazy) {
+    // bring all of the copies up to date at once rather than one at a time
+    // in the comp() calls below
+    Material::DecayAll(ms);
+  }
+
+  std::vector<Composition::Ptr> comps;
+  std::vector<double> qtys;
+  std::map<Composition*, int> index;
+  s->qty = 0;
+  for (int i = 0; i < ms.size(); ++i) {
+    Material::Ptr m = ms[i];
+    Composition::Ptr c = m->comp();
+    std::map<Composition*, int>::iterator it = index.find(c.get());
+    if (it == index.end()) {
+      index[c.get()] = comps.size();
+      comps.push_back(c);
+      qtys.push_back(m->quantity());
+    } else {
+      qtys[it->second] += m->quantity();
+    }
+    s->qty += m->quantity();
   }
+  s->units = mats[0]->units();
+
+  if (comps.size() == 1) {
+    s->comp = comps[0]->mass();
+  } else {
+    s->comp.clear();
+    for (int i = 0; i < comps.size(); ++i) {
+      const CompMap& v = comps[i]->mass();
+      double mult = qtys[i] / compmath::Sum(v);
+      CompMap::const_iterator it;
+      for (it = v.begin(); it != v.end(); ++it) {
+        s->comp[it->first] += it->second * mult;
+      }
+    }
+  }
+  compmath::Normalize(&s->comp, 1);
 }
 
-void Timer::RecordInventories(Agent* a) {
+void Timer::RecordInventories(Agent* a, InvCache* next) {
+  bool lazy = si_.decay == "lazy";
   Inventories invs = a->SnapshotInv();
   Inventories::iterator it2;
   for (it2 = invs.begin(); it2 != invs.end(); ++it2) {
     std::string name = it2->first;
-    std::vector<Resource::Ptr> mats = it2->second;
+    std::vector<Resource::Ptr>& mats = it2->second;
     if (mats.empty() || ResCast<Material>(mats[0]) == NULL) {
       continue; // skip non-material inventories
     }
 
-    Material::Ptr m = ResCast<Material>(mats[0]->Clone());
-    for (int i = 1; i < mats.size(); i++) {
-      m->Absorb(ResCast<Material>(mats[i]->Clone()));
+    std::pair<int, std::string> key(a->id(), name);
+    InvSummary& s = (*next)[key];
+    s.contents.resize(mats.size());
+    for (int i = 0; i < mats.size(); ++i) {
+      s.contents[i] = std::make_pair(mats[i]->qual_id(), mats[i]->quantity());
+    }
+
+    // Lazily decayed compositions can change without their materials
+    // changing, so the previous summary is only reused in other modes.
+    InvCache::iterator prev = inv_cache_.find(key);
+    bool changed = true;
+    if (prev != inv_cache_.end() && !lazy &&
+        prev->second.contents == s.contents) {
+      s.qty = prev->second.qty;
+      s.units = prev->second.units;
+      s.comp.swap(prev->second.comp);
+      changed = false;
+    } else {
+      Summarize(mats, lazy, &s);
+      changed = prev == inv_cache_.end() || prev->second.qty != s.qty ||
+                prev->second.comp != s.comp;
     }
-    RecordInventory(a, name, m);
+    RecordInventory(a, name, s, changed);
   }
 }
 
-void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
+void Timer::RecordInventory(Agent* a, std::string name, const InvSummary& s,
+                            bool changed) {
   if (si_.explicit_inventory) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, m->quantity());
+    CompMap c = s.comp;
+    compmath::Normalize(&c, s.qty);
     CompMap::iterator it;
     for (it = c.begin(); it != c.end(); ++it) {
       ctx_->NewDatum("ExplicitInventory")
@@ -148,43 +433,153 @@ void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
           ->AddVal("InventoryName", name)
           ->AddVal("NucId", it->first)
           ->AddVal("Quantity", it->second)
-          ->AddVal("Units", m->units())
+          ->AddVal("Units", s.units)
           ->Record();
     }
   }
 
   if (si_.explicit_inventory_compact) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, 1);
     ctx_->NewDatum("ExplicitInventoryCompact")
         ->AddVal("AgentId", a->id())
         ->AddVal("Time", time_)
         ->AddVal("InventoryName", name)
-        ->AddVal("Quantity", m->quantity())
-        ->AddVal("Units", m->units())
-        ->AddVal("Composition", c)
+        ->AddVal("Quantity", s.qty)
+        ->AddVal("Units", s.units)
+        ->AddVal("Composition", s.comp)
+        ->Record();
+  }
+
+  if (si_.explicit_inventory_delta && changed) {
+    ctx_->NewDatum("ExplicitInventoryDelta")
+        ->AddVal("AgentId", a->id())
+        ->AddVal("Time", time_)
+        ->AddVal("InventoryName", name)
+        ->AddVal("Quantity", s.qty)
+        ->AddVal("Units", s.units)
+        ->AddVal("Composition", s.comp)
         ->Record();
   }
 }
 
+void Timer::FastForward(ExchangeManager<Material>* matmgr,
+                        ExchangeManager<Product>* genmgr) {
+  if (!si_.fast_forward || want_snapshot_ || si_.explicit_inventory ||
+      si_.explicit_inventory_compact || si_.explicit_inventory_delta) {
+    return;
+  } else if (!tick_listeners_.empty() || !tock_listeners_.empty() ||
+             !decision_listeners_.empty()) {
+    return;
+  } else if (!matmgr->idle() || !genmgr->idle()) {
+    return;
+  }
+
+  int next = si_.duration;
+  std::map<int, std::vector<std::pair<std::string, Agent*> > >::iterator bit =
+      build_queue_.lower_bound(time_);
+  if (bit != build_queue_.end()) {
+    next = std::min(next, bit->first);
+  }
+  // slots left with only the NULLs of rescheduled agents are dropped here,
+  // since nothing is decommissioned at their time anymore
+  std::map<int, std::vector<Agent*> >::iterator dit =
+      decom_queue_.lower_bound(time_);
+  while (dit != decom_queue_.end() &&
+         std::count(dit->second.begin(), dit->second.end(),
+                    static_cast<Agent*>(NULL)) == dit->second.size()) {
+    decom_queue_.erase(dit++);
+  }
+  if (dit != decom_queue_.end()) {
+    next = std::min(next, dit->first);
+  }
+  if (!wake_queue_.empty()) {
+    next = std::min(next, wake_queue_.top().first);
+  }
+
+  // Traders managed by a registered listener are asleep here, and are not
+  // expected to request before their manager wakes. Only traders without a
+  // listening manager are asked when they may request next.
+  const std::set<Trader*>& traders = ctx_->traders();
+  std::set<Trader*>::const_iterator tit;
+  for (tit = traders.begin(); tit != traders.end() && next > time_; ++tit) {
+    Agent* m = (*tit)->manager();
+    if (m == NULL || tickers_.count(m->id()) == 0) {
+      next = std::min(next, (*tit)->NextRequestTime());
+    }
+  }
+
+  if (next <= time_) {
+    return;
+  }
+
+  CLOG(LEV_INFO1) << "Fast forwarding from time " << time_ << " to " << next;
+  ctx_->NewDatum("FastForward")
+      ->AddVal("StartTime", time_)
+      ->AddVal("Duration", next - time_)
+      ->Record();
+  time_ = next;
+}
+
 void Timer::DoDecom() {
   // decommission queued agents
-  std::vector<Agent*> decom_list = decom_queue_[time_];
-  for (int i = 0; i < decom_list.size(); ++i) {
-    Agent* m = decom_list[i];
+  std::map<int, std::vector<Agent*> >::iterator it = decom_queue_.find(time_);
+  if (it == decom_queue_.end()) {
+    return;
+  }
+
+  // Only agents queued before this phase started are decommissioned.  The
+  // list is read in place because decommissioning may reschedule other
+  // queued agents, leaving NULL in their old slots.
+  int n = it->second.size();
+  for (int i = 0; i < n; ++i) {
+    Agent* m = it->second[i];
+    if (m == NULL) {
+      continue;
+    }
+    it->second[i] = NULL;
+    decom_handles_.erase(m);
     if (m->parent() != NULL) {
       m->parent()->DecomNotify(m);
     }
     m->Decommission();
   }
+
+  std::vector<Agent*>& late = it->second;
+  for (int i = n; i < late.size(); ++i) {
+    if (late[i] != NULL) {
+      decom_handles_.erase(late[i]);
+    }
+  }
+  decom_queue_.erase(it);
 }
 
-void Timer::RegisterTimeListener(TimeListener* agent) {
+void Timer::RegisterTimeListener(TimeListener* agent, int phases) {
   tickers_[agent->id()] = agent;
+  phases_[agent->id()] = phases;
+  Sleep(agent->id());
+  Wake(agent);
+  if (IsThreadSafe(agent)) {
+    threadsafe_.insert(agent->id());
+  }
 }
 
 void Timer::UnregisterTimeListener(TimeListener* tl) {
   tickers_.erase(tl->id());
+  phases_.erase(tl->id());
+  wake_time_.erase(tl->id());
+  Sleep(tl->id());
+  threadsafe_.erase(tl->id());
+  std::map<std::string, IdHints>::iterator it;
+  for (it = id_hints_.begin(); it != id_hints_.end(); ++it) {
+    it->second.erase(tl->id());
+  }
+}
+
+void Timer::SchedWake(TimeListener* tl, int t) {
+  // listeners are only put to sleep between timesteps so that the phase
+  // dispatch lists never change while they are being iterated over
+  wake_time_[tl->id()] = t;
+  wake_queue_.push(std::make_pair(t, tl->id()));
+  to_sleep_.push_back(tl->id());
 }
 
 void Timer::SchedBuild(Agent* parent, std::string proto_name, int t) {
@@ -204,25 +599,31 @@ void Timer::SchedDecom(Agent* m, int t) {
   // - the duplicate entries will result in a double delete attempt and
   // segfaults and otherwise bad things.  Remove previous decommissionings
   // before scheduling this new one.
-  std::map<int, std::vector<Agent*> >::iterator it;
-  bool done = false;
-  for (it = decom_queue_.begin(); it != decom_queue_.end(); ++it) {
-    int t = it->first;
-    std::vector<Agent*> ags = it->second;
-    for (int i = 0; i < ags.size(); i++) {
-      if (ags[i] == m) {
-        CLOG(LEV_WARN) << "scheduled over previous decommissioning of " << m->id();
-        decom_queue_[t].erase(decom_queue_[t].begin()+i);
-        done = true;
-        break;
-      }
-    }
-    if (done) {
-      break;
-    }
+  if (CancelDecom(m)) {
+    CLOG(LEV_WARN) << "scheduled over previous decommissioning of " << m->id();
   }
 
-  decom_queue_[t].push_back(m);
+  std::vector<Agent*>& ags = decom_queue_[t];
+  ags.push_back(m);
+  decom_handles_[m] = std::make_pair(t, static_cast<int>(ags.size()) - 1);
+}
+
+bool Timer::CancelDecom(Agent* m) {
+  std::map<Agent*, std::pair<int, int> >::iterator h = decom_handles_.find(m);
+  if (h == decom_handles_.end()) {
+    return false;
+  }
+  decom_queue_[h->second.first][h->second.second] = NULL;
+  decom_handles_.erase(h);
+  return true;
+}
+
+int Timer::DecomTime(Agent* m) {
+  std::map<Agent*, std::pair<int, int> >::iterator h = decom_handles_.find(m);
+  if (h == decom_handles_.end()) {
+    return -1;
+  }
+  return h->second.first;
 }
 
 int Timer::time() {
@@ -231,8 +632,30 @@ int Timer::time() {
 
 void Timer::Reset() {
   tickers_.clear();
+  phases_.clear();
+  tick_listeners_.clear();
+  tock_listeners_.clear();
+  decision_listeners_.clear();
+  wake_time_.clear();
+  wake_queue_ = std::priority_queue<std::pair<int, int>,
+                                    std::vector<std::pair<int, int> >,
+                                    std::greater<std::pair<int, int> > >();
+  to_sleep_.clear();
+  threadsafe_.clear();
+  threadsafe_specs_.clear();
+  id_hints_.clear();
+  if (pool_ != NULL) {
+    delete pool_;
+    pool_ = NULL;
+  }
+  if (timings_ != NULL) {
+    delete timings_;
+    timings_ = NULL;
+  }
   build_queue_.clear();
   decom_queue_.clear();
+  decom_handles_.clear();
+  inv_cache_.clear();
   si_ = SimInfo(0);
 }
 
@@ -249,12 +672,43 @@ void Timer::Initialize(Context* ctx, SimInfo si) {
   if (si.branch_time > -1) {
     time_ = si.branch_time;
   }
+
+  if (pool_ != NULL) {
+    delete pool_;
+    pool_ = NULL;
+  }
+  if (si.threads > 1) {
+    pool_ = new ThreadPool(si.threads);
+  }
+
+  if (timings_ != NULL) {
+    delete timings_;
+    timings_ = NULL;
+  }
+  if (si.phase_timings) {
+    timings_ = new PhaseTimings();
+  }
 }
 
 int Timer::dur() {
   return si_.duration;
 }
 
-Timer::Timer() : time_(0), si_(0), want_snapshot_(false), want_kill_(false) {}
+Timer::Timer()
+    : time_(0),
+      si_(0),
+      want_snapshot_(false),
+      want_kill_(false),
+      pool_(NULL),
+      timings_(NULL) {}
+
+Timer::~Timer() {
+  if (pool_ != NULL) {
+    delete pool_;
+  }
+  if (timings_ != NULL) {
+    delete timings_;
+  }
+}
 
 }  // namespace cyclus
@@ -1,6 +1,9 @@
 #ifndef CYCLUS_SRC_TIMER_H_
 #define CYCLUS_SRC_TIMER_H_
 
+#include <functional>
+#include <queue>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -8,8 +11,11 @@
 #include "exchange_manager.h"
 #include "product.h"
 #include "material.h"
+#include "id_seq.h"
 #include "infile_tree.h"
+#include "phase_timings.h"
 #include "time_listener.h"
+#include "thread_pool.h"
 #include "comp_math.h"
 
 class SimInitTest;
@@ -24,6 +30,8 @@ class Timer {
  public:
   Timer();
 
+  ~Timer();
+
   /// Sets intial time-related parameters for the simulation.
   ///
   /// @param ctx simulation context
@@ -36,22 +44,37 @@ class Timer {
   void RunSim();
 
   /// Registers an agent to receive tick/tock notifications every timestep.
-  /// Agents should register from their Deploy method.
-  void RegisterTimeListener(TimeListener* agent);
+  /// Agents should register from their Deploy method. Agents whose archetype
+  /// annotations declare them "threadsafe" may have their Tick, Tock, and
+  /// Decision methods called concurrently with other such agents.
+  ///
+  /// @param phases the TimePhase flags of the phases to notify the agent of
+  void RegisterTimeListener(TimeListener* agent, int phases = kAllPhases);
 
   /// Removes an agent from receiving tick/tock notifications.
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Stops notifying tl after the current timestep until it is woken up at
+  /// timestep t. Replaces any previously scheduled wake up for tl.
+  void SchedWake(TimeListener* tl, int t);
 
   /// Schedules the named prototype to be built for the specified parent at
   /// timestep t.
   void SchedBuild(Agent* parent, std::string proto_name, int t);
 
   /// Schedules the given Agent to be decommissioned at the specified
-  /// timestep t.
+  /// timestep t. A decommission already pending for the agent is moved to t.
   void SchedDecom(Agent* m, int time);
 
+  /// Cancels the given Agent's pending decommission. Returns false if none
+  /// was pending.
+  bool CancelDecom(Agent* m);
+
+  /// Returns the timestep at which the given Agent is scheduled to be
+  /// decommissioned, or -1 if none is pending.
+  int DecomTime(Agent* m);
+
   /// Schedules a snapshot of simulation state to output database to occur at
   /// the beginning of the next timestep.
   void Snapshot() { want_snapshot_ = true; }
@@ -69,10 +92,29 @@ class Timer {
   /// @return the duration, in months
   int dur();
 
+  /// Returns the per-phase timing accumulator, or NULL if phase timings are
+  /// not being recorded.
+  inline PhaseTimings* phase_timings() { return timings_; }
+
+  /// Returns the worker pool, or NULL if the simulation runs on one thread.
+  inline ThreadPool* thread_pool() { return pool_; }
+
  private:
   /// builds all agents queued for the current timestep.
   void DoBuild();
 
+  /// puts listeners that asked to sleep during the current timestep to sleep.
+  void DoSleep();
+
+  /// wakes up all sleeping listeners due at the current timestep.
+  void DoWake();
+
+  /// adds a listener to the dispatch list of each phase it is subscribed to.
+  void Wake(TimeListener* tl);
+
+  /// removes a listener from all phase dispatch lists.
+  void Sleep(int id);
+
   /// sends the tick signal to all of the agents receiving time
   /// notifications.
   void DoTick();
@@ -89,12 +131,65 @@ class Timer {
   /// notifications.
   void DoDecision();
 
-  void RecordInventories(Agent* a);
-  void RecordInventory(Agent* a, std::string name, Material::Ptr m);
+  /// calls the given phase method on all time listeners in id order. Runs of
+  /// consecutive thread safe listeners are dispatched to the worker pool (if
+  /// any) and their recorded output is merged back in id order. With a pool,
+  /// the ids of resources and compositions they create come from IdBlocks,
+  /// so output does not depend on the number of threads. If phase timings are
+  /// enabled, the time spent by each listener is attributed to its prototype
+  /// under the given phase name.
+  void Dispatch(const std::map<int, TimeListener*>& listeners,
+                void (TimeListener::*phase)(), const std::string& name);
+
+  /// runs the given phase method for all listeners in batch concurrently
+  void DispatchConcurrent(const std::vector<TimeListener*>& batch,
+                          void (TimeListener::*phase)(),
+                          const std::string& name);
+
+  /// calls the given phase method on a single listener
+  void Call(TimeListener* tl, void (TimeListener::*phase)(),
+            const std::string& name);
+
+  /// returns true if the listener's archetype is annotated as thread safe
+  bool IsThreadSafe(TimeListener* tl);
+
+  /// the aggregated contents of a material inventory as of the last time it
+  /// was recorded
+  struct InvSummary {
+    /// (composition id, quantity) of each material in the inventory, used to
+    /// detect whether the inventory changed
+    std::vector<std::pair<int, double> > contents;
+    double qty;
+    std::string units;
+    /// nuclide masses normalized to one
+    CompMap comp;
+  };
+
+  /// inventory summaries keyed by (agent id, inventory name)
+  typedef std::map<std::pair<int, std::string>, InvSummary> InvCache;
+
+  /// Sums the contents of the materials in mats into s. Materials often share
+  /// compositions, so quantities are summed per composition before any
+  /// nuclide masses are. Materials are not cloned or modified, except in lazy
+  /// decay mode where reading the composition of the original would decay it.
+  void Summarize(const std::vector<Resource::Ptr>& mats, bool lazy,
+                 InvSummary* s);
+
+  /// records the explicit inventories of all live agents
+  void RecordInventories();
+  void RecordInventories(Agent* a, InvCache* next);
+  void RecordInventory(Agent* a, std::string name, const InvSummary& s,
+                       bool changed);
 
   /// decommissions all agents queued for the current timestep.
   void DoDecom();
 
+  /// if fast forwarding is enabled and nothing can happen before the next
+  /// scheduled build, decommission, or wake up, advances the time to that
+  /// event (or the end of the simulation) and records the skipped interval.
+  void FastForward(ExchangeManager<Material>* matmgr,
+                   ExchangeManager<Product>* genmgr);
+
   Context* ctx_;
 
   /// The current time, measured in months from when the simulation
@@ -109,11 +204,54 @@ class Timer {
   /// Concrete agents that desire to receive tick and tock notifications
   std::map<int, TimeListener*> tickers_;
 
+  /// TimePhase subscription flags of each registered listener
+  std::map<int, int> phases_;
+
+  /// awake listeners subscribed to each phase; these are the only listeners
+  /// notified when the phase runs
+  std::map<int, TimeListener*> tick_listeners_;
+  std::map<int, TimeListener*> tock_listeners_;
+  std::map<int, TimeListener*> decision_listeners_;
+
+  /// pending wake up time of each sleeping (or soon to be sleeping) listener
+  std::map<int, int> wake_time_;
+
+  /// (time, id) wake up events, earliest first. Entries that no longer match
+  /// wake_time_ are stale and skipped when popped.
+  std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >,
+                      std::greater<std::pair<int, int> > > wake_queue_;
+
+  /// listeners that asked to sleep during the current timestep
+  std::vector<int> to_sleep_;
+
+  /// ids of the registered listeners that can run concurrently
+  std::set<int> threadsafe_;
+
+  /// cached "threadsafe" annotation for each archetype spec
+  std::map<std::string, bool> threadsafe_specs_;
+
+  /// ids used by each thread safe listener in its last concurrent run of
+  /// each phase, used to size its id blocks (see IdBlocks)
+  std::map<std::string, IdHints> id_hints_;
+
+  /// worker threads for thread safe listeners, NULL when running serially
+  ThreadPool* pool_;
+
+  /// per-phase wall clock timings, NULL unless enabled in SimInfo
+  PhaseTimings* timings_;
+
   // std::map<time,std::vector<std::pair<prototype, parent> > >
   std::map<int, std::vector<std::pair<std::string, Agent*> > > build_queue_;
 
   // std::map<time,std::vector<config> >
+  // Rescheduled and cancelled agents leave a NULL in their old slot.
   std::map<int, std::vector<Agent*> > decom_queue_;
+
+  /// the inventory summaries from the last time inventories were recorded
+  InvCache inv_cache_;
+
+  /// (time, index) of each agent's pending decommission in decom_queue_
+  std::map<Agent*, std::pair<int, int> > decom_handles_;
 };
 
 }  // namespace cyclus
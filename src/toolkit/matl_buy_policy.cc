@@ -400,6 +400,16 @@ void MatlBuyPolicy::CheckActiveDormantCumulativeTimes() {
   return;
 }
 
+int MatlBuyPolicy::NextRequestTime() {
+  int time = manager()->context()->time();
+  if (!dormant(time) && MakeReq() && TotalAvailable() >= eps()) {
+    return time;
+  } else if (next_dormant_end_ >= time) {
+    return next_dormant_end_;
+  }
+  return std::numeric_limits<int>::max();
+}
+
 void MatlBuyPolicy::RecordActiveDormantTime(int time, std::string type, int length) {
   manager()->context()->NewDatum("BuyPolActiveDormant")
                       ->AddVal("Agent", manager()->id())
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_TOOLKIT_MATL_BUY_POLICY_H_
 #define CYCLUS_SRC_TOOLKIT_MATL_BUY_POLICY_H_
 
+#include <limits>
 #include <string>
 #include <boost/shared_ptr.hpp>
 
@@ -225,6 +226,11 @@ class MatlBuyPolicy : public Trader {
   virtual std::set<RequestPortfolio<Material>::Ptr> GetMatlRequests();
   virtual void AcceptMatlTrades(
       const std::vector<std::pair<Trade<Material>, Material::Ptr> >& resps);
+
+  /// The current time if a request may be made now, otherwise the end of
+  /// the current dormant period (if any), when the next active period is
+  /// sampled.
+  virtual int NextRequestTime();
   /// }@
 
   void SetNextActiveTime();
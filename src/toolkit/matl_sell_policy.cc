@@ -145,6 +145,10 @@ MatlSellPolicy& MatlSellPolicy::Init(Agent* manager, ResBuf<Material>* buf,
 
 MatlSellPolicy& MatlSellPolicy::Set(std::string commod) {
   commods_.insert(commod);
+  // policies that have not been started yet subscribe in Start
+  if (manager() != NULL && manager()->context()->traders().count(this) > 0) {
+    manager()->context()->SubscribeBids(this, commod);
+  }
   return *this;
 }
 
@@ -154,7 +158,12 @@ void MatlSellPolicy::Start() {
     ss << "No manager set on Sell Policy " << name_;
     throw ValueError(ss.str());
   }
-  manager()->context()->RegisterTrader(this);
+  Context* ctx = manager()->context();
+  ctx->RegisterTrader(this);
+  std::set<std::string>::iterator it;
+  for (it = commods_.begin(); it != commods_.end(); ++it) {
+    ctx->SubscribeBids(this, *it);
+  }
 }
 
 void MatlSellPolicy::Stop() {
@@ -284,7 +293,7 @@ void MatlSellPolicy::GetMatlTrades(
         trade_mat = mat;
       }
 
-      if (ignore_comp_ && compmath::AlmostEq(it->request->target()->comp()->mass(), trade_mat->comp()->mass(), eps_rsrc())) {
+      if (ignore_comp_ && compmath::AlmostEq(it->request->target()->comp()->mass_vec(), trade_mat->comp()->mass_vec(), eps_rsrc())) {
         trade_mat->Transmute(it->request->target()->comp());
       }
       responses.push_back(std::make_pair(*it, trade_mat));
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_TOOLKIT_MATL_SELL_POLICY_H_
 #define CYCLUS_SRC_TOOLKIT_MATL_SELL_POLICY_H_
 
+#include <limits>
 #include <string>
 
 #include "composition.h"
@@ -98,7 +99,8 @@ class MatlSellPolicy : public Trader {
   /// Registers this policy as a trader in the current simulation.  This
   /// function must be called for the policy to begin participating in resource
   /// exchange. Init MUST be called prior to calling this function.  Start is
-  /// idempotent.
+  /// idempotent. The policy is subscribed to bid only on its commodities, so
+  /// it is not asked for bids in exchanges where none of them are requested.
   void Start();
 
   /// Unregisters this policy as a trader in the current simulation. This
@@ -121,6 +123,9 @@ class MatlSellPolicy : public Trader {
   virtual void GetMatlTrades(
       const std::vector<Trade<Material> >& trades,
       std::vector<std::pair<Trade<Material>, Material::Ptr> >& responses);
+
+  /// Sell policies only bid on the requests of other agents.
+  virtual int NextRequestTime() { return std::numeric_limits<int>::max(); }
   /// }@
 
  private:
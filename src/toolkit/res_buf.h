@@ -352,12 +352,23 @@ class ResBuf {
   /// @param curr_time time to calculate decay inventory
   ///        (default: -1 uses the current time of the context)
   void Decay(int curr_time = -1) {
-    for (auto rs : rs_) {
-      rs->Decay(curr_time);
-    }
+    DecayAll(std::vector<typename T::Ptr>(rs_.begin(), rs_.end()), curr_time);
   }
 
  private:
+  template <class R>
+  static void DecayAll(const std::vector<boost::shared_ptr<R> >& rs,
+                       int curr_time) {
+    for (int i = 0; i < rs.size(); ++i) {
+      rs[i]->Decay(curr_time);
+    }
+  }
+
+  // materials are decayed together so their decay calculations are batched
+  static void DecayAll(const std::vector<Material::Ptr>& rs, int curr_time) {
+    Material::DecayAll(rs, curr_time);
+  }
+
   void UpdateQty() {
     int n = rs_.size();
     if (n == 0) {
@@ -84,6 +84,20 @@ class Trader {
       const std::vector<std::pair<Trade<Product>,
       Product::Ptr> >& responses) {}
 
+  /// @brief returns the earliest time, at or after the current one, at which
+  /// this trader may make requests if no agent acts before then. The timer
+  /// never fast forwards past it (see SimInfo::fast_forward), so a trader
+  /// whose requests change with time alone (e.g. at the end of a dormant
+  /// period) must return that time. A trader that only requests in response
+  /// to other agents may return std::numeric_limits<int>::max().
+  ///
+  /// This is only asked of traders whose manager is not a registered time
+  /// listener. A trader managed by a sleeping listener is assumed not to
+  /// request until the listener wakes. The default, -1, means that the trader
+  /// may request at any time and keeps the simulation from being fast
+  /// forwarded while it is registered.
+  virtual int NextRequestTime() { return -1; }
+
  protected:
   Agent* manager_;
 
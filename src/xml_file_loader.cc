@@ -234,8 +234,11 @@ void XMLFileLoader::LoadSolver() {
   string config = "config";
   string greedy = "greedy";
   string coinor = "coin-or";
+  string network = "network";
+  string hybrid = "hybrid";
   string solver_name = greedy;
   bool exclusive = ExchangeSolver::kDefaultExclusive;
+  bool decompose = false;
   if (xqe.NMatches("/*/control/solver") == 1) {
     qe = xqe.SubTree("/*/control/solver");
     if (qe->NMatches(config) == 1) {
@@ -243,6 +246,7 @@ void XMLFileLoader::LoadSolver() {
     }
     exclusive = cyclus::OptionalQuery<bool>(qe, "allow_exclusive_orders",
                                             exclusive);
+    decompose = cyclus::OptionalQuery<bool>(qe, "decompose", decompose);
 
   }
 
@@ -257,6 +261,7 @@ void XMLFileLoader::LoadSolver() {
   ctx_->NewDatum("SolverInfo")
       ->AddVal("Solver", solver_name)
       ->AddVal("ExclusiveOrders", exclusive)
+      ->AddVal("Decompose", decompose)
       ->Record();
 
   // now load the actual solver
@@ -273,12 +278,24 @@ void XMLFileLoader::LoadSolver() {
     bool verbose = cyclus::OptionalQuery<bool>(&xqe, query, false);
     query = string("/*/control/solver/config/coin-or/mps");
     bool mps = cyclus::OptionalQuery<bool>(&xqe, query, false);
+    query = string("/*/control/solver/config/coin-or/lp");
+    bool lp = cyclus::OptionalQuery<bool>(&xqe, query, false);
+    query = string("/*/control/solver/config/coin-or/persistent");
+    bool persistent = cyclus::OptionalQuery<bool>(&xqe, query, false);
     ctx_->NewDatum("CoinSolverInfo")
       ->AddVal("Timeout", timeout)
       ->AddVal("Verbose", verbose)
       ->AddVal("Mps", mps)
+      ->AddVal("Lp", lp)
+      ->AddVal("Persistent", persistent)
       ->Record();
-  } else {
+  } else if (solver_name == hybrid) {
+    query = string("/*/control/solver/config/hybrid/budget");
+    double budget = cyclus::OptionalQuery<double>(&xqe, query, -1);
+    ctx_->NewDatum("HybridSolverInfo")
+      ->AddVal("Budget", budget)
+      ->Record();
+  } else if (solver_name != network) {
     throw ValueError("unknown solver name: " + solver_name);
   }
 }
@@ -473,6 +490,17 @@ void XMLFileLoader::LoadControlParams() {
 
   si.explicit_inventory = OptionalQuery<bool>(qe, "explicit_inventory", false);
   si.explicit_inventory_compact = OptionalQuery<bool>(qe, "explicit_inventory_compact", false);
+  si.explicit_inventory_interval = OptionalQuery<int>(qe, "explicit_inventory_interval", 1);
+  si.explicit_inventory_delta = OptionalQuery<bool>(qe, "explicit_inventory_delta", false);
+  si.threads = OptionalQuery<int>(qe, "threads", 1);
+  si.phase_timings = OptionalQuery<bool>(qe, "phase_timings", false);
+  si.fast_forward = OptionalQuery<bool>(qe, "fast_forward", false);
+  si.incremental_exchange = OptionalQuery<bool>(qe, "incremental_exchange", false);
+  si.parallel_exchange = OptionalQuery<bool>(qe, "parallel_exchange", false);
+  si.intern_compositions =
+      OptionalQuery<bool>(qe, "intern_compositions", false);
+  si.decay_operator_mb =
+      OptionalQuery<double>(qe, "decay_operator_mb", 0);
 
   // get time step duration
   si.dt = OptionalQuery<int>(qe, "dt", kDefaultTimeStepDur);
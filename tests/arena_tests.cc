@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "arena.h"
+
+using cyclus::Arena;
+
+namespace {
+
+// records the order in which it is destroyed
+class Tracked {
+ public:
+  Tracked(std::vector<int>* log, int id) : log_(log), id_(id) {}
+  ~Tracked() { log_->push_back(id_); }
+
+  int id() const { return id_; }
+
+ private:
+  std::vector<int>* log_;
+  int id_;
+};
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ArenaTests, New) {
+  Arena<std::string> a;
+  EXPECT_EQ(0, a.size());
+  std::vector<std::string*> strs;
+  for (int i = 0; i < 100; ++i) {
+    strs.push_back(a.New(i, 'x'));
+  }
+  EXPECT_EQ(100, a.size());
+  // objects never move as the arena grows
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(std::string(i, 'x'), *strs[i]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ArenaTests, Clear) {
+  std::vector<int> log;
+  {
+    Arena<Tracked> a;
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(i, a.New(&log, i)->id());
+    }
+    a.Clear();
+    EXPECT_EQ(0, a.size());
+    ASSERT_EQ(10, log.size());
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(i, log[i]);
+    }
+
+    a.New(&log, 10);
+  }
+  ASSERT_EQ(11, log.size());
+  EXPECT_EQ(10, log[10]);
+}
@@ -1,5 +1,6 @@
 #include <set>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -64,6 +65,20 @@ TEST_F(BidPortfolioTests, RespAdd) {
   EXPECT_THROW(rp->AddBid(req2, get_mat(), fac2), KeyError);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(BidPortfolioTests, Order) {
+  BidPortfolio<Material>::Ptr rp(new BidPortfolio<Material>());
+  std::vector<Bid<Material>*> added;
+  for (int i = 0; i < 20; ++i) {
+    added.push_back(rp->AddBid(i % 2 == 0 ? req1 : req2, get_mat(), fac1));
+  }
+  EXPECT_EQ(added, rp->bids());
+  EXPECT_EQ(rp, rp->bids()[19]->portfolio());
+
+  EXPECT_THROW(rp->AddBid(req1, get_mat(), fac2), KeyError);
+  EXPECT_EQ(20, rp->bids().size());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(BidPortfolioTests, Sets) {
   BidPortfolio<Material>::Ptr rp1(new BidPortfolio<Material>());
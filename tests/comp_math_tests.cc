@@ -8,6 +8,7 @@
 namespace cm = cyclus::compmath;
 using cyclus::Composition;
 using cyclus::CompMap;
+using cyclus::NucVec;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(CompMathTests, SubSame) {
@@ -252,3 +253,50 @@ TEST(CompMathTests, Add) {
     EXPECT_DOUBLE_EQ(it->second, expect[it->first]);
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// the NucVec kernels must give exactly the same results as the CompMap ones
+TEST(CompMathTests, NucVecSameAsCompMap) {
+  CompMap v1;
+  v1[10010000] = 1.5;
+  v1[922350000] = 0.3;
+  v1[922380000] = 9.1;
+  CompMap v2;
+  v2[80160000] = 2.25;
+  v2[922350000] = 0.7;
+  v2[942390000] = 1e-12;
+  CompMap same(v1);
+  same[10010000] = 0.1;
+
+  CompMap maps[] = {v1, v2, same};
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      NucVec a(maps[i]);
+      NucVec b(maps[j]);
+      EXPECT_EQ(cm::Add(maps[i], maps[j]), cm::Add(a, b).ToMap());
+      EXPECT_EQ(cm::Sub(maps[i], maps[j]), cm::Sub(a, b).ToMap());
+      EXPECT_EQ(cm::AlmostEq(maps[i], maps[j], 0.1), cm::AlmostEq(a, b, 0.1));
+    }
+    NucVec a(maps[i]);
+    EXPECT_EQ(cm::Sum(maps[i]), cm::Sum(a));
+
+    CompMap norm(maps[i]);
+    cm::Normalize(&norm, 3);
+    cm::Normalize(&a, 3);
+    EXPECT_EQ(norm, a.ToMap());
+
+    cm::ApplyThreshold(&norm, 1e-6);
+    cm::ApplyThreshold(&a, 1e-6);
+    EXPECT_EQ(norm, a.ToMap());
+    EXPECT_EQ(norm.size(), a.dense().size());
+  }
+
+  NucVec neg(cm::Sub(NucVec(v1), NucVec(v2)));
+  EXPECT_FALSE(cm::AllPositive(neg));
+  EXPECT_TRUE(cm::AllPositive(NucVec(v1)));
+  EXPECT_TRUE(cm::ValidNucs(NucVec(v1)));
+  CompMap bad;
+  bad[-1] = 1;
+  EXPECT_FALSE(cm::ValidNucs(NucVec(bad)));
+  EXPECT_THROW(cm::AlmostEq(NucVec(v1), NucVec(v1), -1), cyclus::ValueError);
+}
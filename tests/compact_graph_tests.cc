@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "compact_graph.h"
+#include "error.h"
+#include "exchange_graph.h"
+
+using cyclus::Arc;
+using cyclus::CompactGraph;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::RequestGroup;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompactGraphTests, Layout) {
+  ExchangeNode::Ptr u1(new ExchangeNode());
+  ExchangeNode::Ptr u2(new ExchangeNode(2.5, true));
+  ExchangeNode::Ptr v(new ExchangeNode(3));
+  u1->agent_id = 4;
+  v->agent_id = 7;
+
+  Arc a1(u1, v);
+  Arc a2(u2, v);
+  a1.pref(1.5);
+  u1->prefs[a1] = 2;
+  u1->unit_capacities[a1].push_back(0.5);
+  u1->unit_capacities[a1].push_back(0.25);
+  v->unit_capacities[a1].push_back(1);
+  v->unit_capacities[a2].push_back(2);
+
+  RequestGroup::Ptr ru(new RequestGroup(5));
+  ru->AddExchangeNode(u1);
+  ru->AddExchangeNode(u2);
+  ru->AddCapacity(5);
+  ru->AddCapacity(6);
+  ExchangeNodeGroup::Ptr sv(new ExchangeNodeGroup());
+  sv->AddExchangeNode(v);
+  sv->AddCapacity(10);
+
+  ExchangeGraph g;
+  g.AddSupplyGroup(sv);
+  g.AddRequestGroup(ru);
+  g.AddArc(a1);
+  g.AddArc(a2);
+
+  CompactGraph cg(&g);
+  EXPECT_EQ(&g, cg.graph());
+  ASSERT_EQ(2, cg.n_groups());
+  ASSERT_EQ(1, cg.n_request_groups());
+  ASSERT_EQ(3, cg.n_nodes());
+  ASSERT_EQ(2, cg.n_arcs());
+
+  // request groups come first
+  EXPECT_TRUE(cg.is_request(0));
+  EXPECT_FALSE(cg.is_request(1));
+  EXPECT_EQ(ru.get(), cg.group(0));
+  EXPECT_EQ(sv.get(), cg.group(1));
+  EXPECT_DOUBLE_EQ(5, cg.request_qty(0));
+  EXPECT_EQ(2, cg.caps_end(0) - cg.caps_begin(0));
+  EXPECT_DOUBLE_EQ(6, cg.caps()[cg.caps_begin(0) + 1]);
+  EXPECT_DOUBLE_EQ(10, cg.caps()[cg.caps_begin(1)]);
+
+  // nodes
+  EXPECT_EQ(0, cg.nodes_begin(0));
+  EXPECT_EQ(2, cg.nodes_end(0));
+  EXPECT_EQ(0, cg.node_index(u1.get()));
+  EXPECT_EQ(1, cg.node_index(u2.get()));
+  EXPECT_EQ(2, cg.node_index(v.get()));
+  EXPECT_EQ(v, cg.node(2));
+  EXPECT_EQ(1, cg.node_group(2));
+  EXPECT_DOUBLE_EQ(3, cg.qty(2));
+  EXPECT_EQ(4, cg.agent_id(0));
+  EXPECT_EQ(7, cg.agent_id(2));
+
+  // each node's arcs, in arc id order
+  ASSERT_EQ(1, cg.arcs_end(0) - cg.arcs_begin(0));
+  EXPECT_EQ(0, cg.node_arc(cg.arcs_begin(0)));
+  ASSERT_EQ(2, cg.arcs_end(2) - cg.arcs_begin(2));
+  EXPECT_EQ(0, cg.node_arc(cg.arcs_begin(2)));
+  EXPECT_EQ(1, cg.node_arc(cg.arcs_begin(2) + 1));
+
+  // arcs
+  EXPECT_EQ(a1, cg.arc(0));
+  EXPECT_EQ(0, cg.unode(0));
+  EXPECT_EQ(2, cg.vnode(0));
+  EXPECT_EQ(1, cg.unode(1));
+  EXPECT_FALSE(cg.exclusive(0));
+  EXPECT_TRUE(cg.exclusive(1));
+  EXPECT_DOUBLE_EQ(2.5, cg.excl_val(1));
+  EXPECT_DOUBLE_EQ(1.5, cg.pref(0));
+  EXPECT_DOUBLE_EQ(2, cg.req_pref(0));
+  EXPECT_DOUBLE_EQ(0, cg.req_pref(1));
+
+  ASSERT_EQ(2, cg.n_ucaps(0));
+  EXPECT_DOUBLE_EQ(0.5, cg.ucaps(0)[0]);
+  EXPECT_DOUBLE_EQ(0.25, cg.ucaps(0)[1]);
+  ASSERT_EQ(1, cg.n_vcaps(0));
+  EXPECT_DOUBLE_EQ(1, cg.vcaps(0)[0]);
+  EXPECT_EQ(0, cg.n_ucaps(1));
+  ASSERT_EQ(1, cg.n_vcaps(1));
+  EXPECT_DOUBLE_EQ(2, cg.vcaps(1)[0]);
+
+  ExchangeNode::Ptr other(new ExchangeNode());
+  EXPECT_THROW(cg.node_index(other.get()), cyclus::KeyError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompactGraphTests, UngroupedNode) {
+  ExchangeNode::Ptr u(new ExchangeNode());
+  ExchangeNode::Ptr v(new ExchangeNode());
+  RequestGroup::Ptr ru(new RequestGroup());
+  ru->AddExchangeNode(u);
+
+  ExchangeGraph g;
+  g.AddRequestGroup(ru);
+  g.AddArc(Arc(u, v));
+
+  EXPECT_THROW(CompactGraph cg(&g), cyclus::StateError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompactGraphTests, Reorder) {
+  // two request groups of two nodes each, both nodes of a group bidding on
+  // the same supply node
+  ExchangeGraph g;
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(10);
+  g.AddSupplyGroup(s);
+  for (int i = 0; i < 2; ++i) {
+    RequestGroup::Ptr r(new RequestGroup(1 + i));
+    r->AddCapacity(1 + i);
+    g.AddRequestGroup(r);
+    ExchangeNode::Ptr v(new ExchangeNode());
+    s->AddExchangeNode(v);
+    for (int j = 0; j < 2; ++j) {
+      ExchangeNode::Ptr u(new ExchangeNode(1 + j));
+      u->agent_id = 2 * i + j;
+      r->AddExchangeNode(u);
+      Arc a(u, v);
+      a.pref(1 + 2 * i + j);
+      u->prefs[a] = a.pref();
+      u->unit_capacities[a].push_back(1 + j);
+      g.AddArc(a);
+    }
+  }
+
+  CompactGraph cg(&g);
+  std::swap(g.request_groups()[0], g.request_groups()[1]);
+  std::vector<ExchangeNode::Ptr>& nodes = g.request_groups()[0]->nodes();
+  std::swap(nodes[0], nodes[1]);
+  ASSERT_TRUE(cg.Reorder());
+
+  CompactGraph fresh(&g);
+  ASSERT_EQ(fresh.n_nodes(), cg.n_nodes());
+  for (int gi = 0; gi < fresh.n_groups(); ++gi) {
+    EXPECT_EQ(fresh.group(gi), cg.group(gi));
+    EXPECT_EQ(fresh.nodes_begin(gi), cg.nodes_begin(gi));
+    EXPECT_EQ(fresh.caps_begin(gi), cg.caps_begin(gi));
+    EXPECT_DOUBLE_EQ(fresh.caps()[fresh.caps_begin(gi)],
+                     cg.caps()[cg.caps_begin(gi)]);
+  }
+  EXPECT_DOUBLE_EQ(fresh.request_qty(0), cg.request_qty(0));
+  for (int n = 0; n < fresh.n_nodes(); ++n) {
+    EXPECT_EQ(fresh.node(n), cg.node(n));
+    EXPECT_EQ(n, cg.node_index(cg.node(n).get()));
+    EXPECT_EQ(fresh.node_group(n), cg.node_group(n));
+    EXPECT_DOUBLE_EQ(fresh.qty(n), cg.qty(n));
+    EXPECT_EQ(fresh.agent_id(n), cg.agent_id(n));
+    ASSERT_EQ(fresh.arcs_end(n) - fresh.arcs_begin(n),
+              cg.arcs_end(n) - cg.arcs_begin(n));
+    for (int i = fresh.arcs_begin(n); i != fresh.arcs_end(n); ++i) {
+      EXPECT_EQ(fresh.node_arc(i), cg.node_arc(i));
+    }
+  }
+  for (int a = 0; a < fresh.n_arcs(); ++a) {
+    EXPECT_EQ(fresh.unode(a), cg.unode(a));
+    EXPECT_EQ(fresh.vnode(a), cg.vnode(a));
+    EXPECT_DOUBLE_EQ(fresh.req_pref(a), cg.req_pref(a));
+  }
+
+  // a new node cannot be reordered into the snapshot
+  ExchangeNode::Ptr added(new ExchangeNode());
+  g.request_groups()[0]->AddExchangeNode(added);
+  EXPECT_FALSE(cg.Reorder());
+  EXPECT_EQ(fresh.node(0), cg.node(0));
+}
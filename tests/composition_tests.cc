@@ -1,4 +1,5 @@
 #include <map>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -6,9 +7,12 @@
 #include "composition.h"
 #include "comp_math.h"
 #include "env.h"
+#include "error.h"
 #include "pyne.h"
+#include "thread_pool.h"
 
 using cyclus::Composition;
+using cyclus::CompositionTable;
 using cyclus::CompMap;
 using pyne::nucname::id;
 
@@ -94,3 +98,123 @@ TEST(CompositionTests, decay) {
   EXPECT_NEAR(v[id("U238")], newv[id("U238")], 1e-4);
 }
 
+
+TEST(CompositionTests, Intern) {
+  CompositionTable tbl(1e-9);
+  CompMap v;
+  v[922350000] = 2;
+  v[922380000] = 98;
+  Composition::Ptr c1 = Composition::CreateFromMass(v);
+  EXPECT_EQ(c1, tbl.Intern(c1));
+
+  // same fractions scaled, and within the tolerance
+  CompMap v2;
+  v2[922350000] = 4;
+  v2[922380000] = 196 * (1 + 1e-13);
+  Composition::Ptr c2 = Composition::CreateFromMass(v2);
+  EXPECT_EQ(c1, tbl.Intern(c2));
+  EXPECT_EQ(c1->id(), tbl.Intern(c2)->id());
+
+  // different fractions and different nuclides
+  v2[922350000] = 3;
+  Composition::Ptr c3 = Composition::CreateFromMass(v2);
+  EXPECT_EQ(c3, tbl.Intern(c3));
+  v[942390000] = 1;
+  Composition::Ptr c4 = Composition::CreateFromMass(v);
+  EXPECT_EQ(c4, tbl.Intern(c4));
+  EXPECT_EQ(3, tbl.size());
+
+  EXPECT_THROW(CompositionTable(0), cyclus::ValueError);
+}
+
+TEST(CompositionTests, InternAcrossBuckets) {
+  // pairs within the tolerance are merged wherever the bucket boundaries fall
+  for (int k = 0; k < 100; ++k) {
+    CompositionTable tbl(1e-9);
+    double x = 0.3 + k * 1e-10;
+    CompMap v1;
+    v1[922350000] = x;
+    v1[922380000] = 1 - x;
+    CompMap v2;
+    v2[922350000] = x + 4e-10;
+    v2[922380000] = 1 - x - 4e-10;
+    Composition::Ptr c1 = Composition::CreateFromMass(v1);
+    Composition::Ptr c2 = Composition::CreateFromMass(v2);
+    EXPECT_EQ(c1, tbl.Intern(c1));
+    EXPECT_EQ(c1, tbl.Intern(c2)) << "x = " << x;
+    EXPECT_EQ(1, tbl.size());
+  }
+}
+
+TEST(CompositionTests, DecayAll) {
+  CompMap v1;
+  v1[551370000] = 1;
+  v1[922350000] = 2;
+  CompMap v2;
+  v2[551370000] = 3;
+
+  // decay separately...
+  Composition::Ptr r1 = Composition::CreateFromAtom(v1)->Decay(5, 3600);
+  Composition::Ptr r2 = Composition::CreateFromAtom(v2)->Decay(5, 3600);
+
+  // ...and together, with one composition repeated and one already decayed
+  Composition::Ptr c1 = Composition::CreateFromAtom(v1);
+  Composition::Ptr c2 = Composition::CreateFromAtom(v2);
+  Composition::Ptr cached = c2->Decay(5, 3600);
+  std::vector<Composition::Ptr> comps;
+  comps.push_back(c1);
+  comps.push_back(c2);
+  comps.push_back(c1);
+  std::vector<Composition::Ptr> decayed =
+      Composition::DecayAll(comps, 5, 3600);
+  ASSERT_EQ(3, decayed.size());
+  EXPECT_EQ(r1->atom(), decayed[0]->atom());
+  EXPECT_EQ(r2->atom(), decayed[1]->atom());
+  EXPECT_EQ(cached, decayed[1]);
+  EXPECT_EQ(decayed[0], decayed[2]);
+  EXPECT_EQ(decayed[0], c1->Decay(5, 3600));
+  EXPECT_NE(v1, decayed[0]->atom());
+}
+
+TEST(CompositionTests, ConcurrentDecay) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[551370000] = 1;
+  v[922350000] = 2;
+  Composition::Ptr c = Composition::CreateFromMass(v);
+  Composition::Ptr sibling = c->Decay(1, 3600);
+
+  // threads decaying compositions of one chain, and reading the lazily
+  // calculated members of the results, all get the same compositions
+  cyclus::ThreadPool pool(4);
+  std::vector<Composition::Ptr> decayed(16);
+  pool.ParallelFor(decayed.size(), [&](int i) {
+    Composition::Ptr from = i % 2 == 0 ? c : sibling;
+    decayed[i] = from->Decay(i % 2 == 0 ? 5 : 4, 3600);
+    decayed[i]->atom();
+    decayed[i]->max_decay_const();
+  });
+  for (int i = 0; i < decayed.size(); ++i) {
+    EXPECT_EQ(decayed[0], decayed[i]);
+  }
+  EXPECT_EQ(decayed[0], c->Decay(5, 3600));
+  EXPECT_EQ(decayed[0]->atom(), sibling->Decay(4, 3600)->atom());
+}
+
+TEST(CompositionTests, max_decay_const) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[10010000] = 1;
+  v[551370000] = 1;
+  v[922350000] = 1;
+  Composition::Ptr c = Composition::CreateFromAtom(v);
+  EXPECT_DOUBLE_EQ(pyne::decay_const(551370000), c->max_decay_const());
+  EXPECT_DOUBLE_EQ(pyne::decay_const(551370000), c->max_decay_const());
+
+  CompMap stable;
+  stable[10010000] = 1;
+  EXPECT_DOUBLE_EQ(0, Composition::CreateFromAtom(stable)->max_decay_const());
+  EXPECT_DOUBLE_EQ(0, Composition::CreateFromAtom(CompMap())->max_decay_const());
+}
@@ -1,12 +1,16 @@
 #include <gtest/gtest.h>
 
 #include "context.h"
+#include "decay_operators.h"
 #include "recorder.h"
 #include "test_agents/test_facility.h"
 #include "timer.h"
 
+using cyclus::CompMap;
+using cyclus::Composition;
 using cyclus::Context;
 using cyclus::Recorder;
+using cyclus::SimInfo;
 using cyclus::Agent;
 using cyclus::Timer;
 using cyclus::Trader;
@@ -147,4 +151,32 @@ TEST_F(ContextTests, DoubleTransportUnitNameThrow) {
   ASSERT_THROW(ctx->AddTransportUnit("foo"), cyclus::KeyError);
   
   delete ctx;
-  }
\ No newline at end of file
+  }
+
+TEST_F(ContextTests, InternComp) {
+  CompMap v;
+  v[922350000] = 1;
+  Composition::Ptr c1 = Composition::CreateFromMass(v);
+  Composition::Ptr c2 = Composition::CreateFromMass(v);
+
+  // interning is off by default
+  EXPECT_EQ(c2, ctx->InternComp(c2));
+
+  SimInfo si(5);
+  si.intern_compositions = true;
+  ctx->InitSim(si);
+  EXPECT_EQ(c1, ctx->InternComp(c1));
+  EXPECT_EQ(c1, ctx->InternComp(c2));
+}
+
+TEST_F(ContextTests, DecayOps) {
+  // the operator cache is off by default
+  EXPECT_TRUE(ctx->decay_ops() == NULL);
+
+  SimInfo si(5);
+  si.dt = 3600;
+  si.decay_operator_mb = 8;
+  ctx->InitSim(si);
+  ASSERT_TRUE(ctx->decay_ops() != NULL);
+  EXPECT_EQ(3600, ctx->decay_ops()->dt());
+}
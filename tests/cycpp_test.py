@@ -283,6 +283,27 @@ def test_notefilter():
     f.transform(statement, sep)
     assert m.context['']['doc'] == 'string'
 
+    m = MockMachine()
+    f = NoteDecorationFilter(m)
+    statement, sep = "#pragma cyclus note {'threadsafe': True} ", "\n"
+    assert  f.isvalid(statement)
+    f.transform(statement, sep)
+    assert m.context['']['threadsafe']
+
+    m = MockMachine()
+    f = NoteDecorationFilter(m)
+    statement, sep = "#pragma cyclus note {'threadsafe': 'yes'} ", "\n"
+    assert  f.isvalid(statement)
+    with pytest.raises(TypeError):
+        f.transform(statement, sep)
+
+    m = MockMachine()
+    f = NoteDecorationFilter(m)
+    statement, sep = "#pragma cyclus note {'reentrant': 1} ", "\n"
+    assert  f.isvalid(statement)
+    with pytest.raises(TypeError):
+        f.transform(statement, sep)
+
 class MockAliasCodeGenMachine(object):
     """Mock machine for testing aliasing on pass 3 filters"""
     def __init__(self):
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "composition.h"
+#include "decay_batch.h"
+#include "decay_operators.h"
+#include "error.h"
+#include "nuc_vec.h"
+
+using cyclus::CompMap;
+using cyclus::Composition;
+using cyclus::DecayBatch;
+using cyclus::DecayOperators;
+using cyclus::NucVec;
+
+static NucVec Atoms() {
+  CompMap v;
+  v[551370000] = 1;
+  v[922350000] = 2;
+  return NucVec(v);
+}
+
+// expects both vectors to hold the same nuclides in nearly equal amounts
+static void ExpectNear(const NucVec& want, const NucVec& got) {
+  ASSERT_EQ(want.nucs(), got.nucs());
+  for (int k = 0; k < want.size(); ++k) {
+    EXPECT_NEAR(want.vals()[k], got.vals()[k], 1e-12 * want.vals()[k]);
+  }
+}
+
+TEST(DecayOperatorsTests, Steps) {
+  DecayOperators ops(3600, 1);
+  EXPECT_EQ(3600, ops.dt());
+  EXPECT_EQ(1, ops.Steps(3600));
+  EXPECT_EQ(5, ops.Steps(5 * 3600));
+  EXPECT_EQ(0, ops.Steps(1800));
+  EXPECT_EQ(0, ops.Steps(5400));
+  EXPECT_EQ(0, ops.Steps(0));
+  EXPECT_EQ(0, ops.Steps(-3600));
+
+  EXPECT_THROW(DecayOperators(0, 1), cyclus::ValueError);
+  EXPECT_THROW(DecayOperators(3600, -1), cyclus::ValueError);
+}
+
+TEST(DecayOperatorsTests, SameAsCram) {
+  DecayOperators ops(3600, 1);
+  NucVec n0 = Atoms();
+  int ks[] = {1, 2, 5, 8, 13};
+  for (int i = 0; i < 5; ++i) {
+    DecayBatch cram(3600.0 * ks[i]);
+    DecayBatch cached(3600.0 * ks[i], &ops);
+    ExpectNear(cram.Decay(n0), cached.Decay(n0));
+  }
+  EXPECT_GT(ops.bytes(), 0);
+
+  // off-grid intervals are solved with CRAM
+  DecayBatch cram(1800);
+  DecayBatch off(1800, &ops);
+  EXPECT_EQ(cram.Decay(n0).vals(), off.Decay(n0).vals());
+}
+
+TEST(DecayOperatorsTests, Budget) {
+  // with no room for columns every step falls back to CRAM
+  DecayOperators ops(3600, 0);
+  NucVec n0 = Atoms();
+  DecayBatch cram(3600.0 * 3);
+  DecayBatch cached(3600.0 * 3, &ops);
+  ExpectNear(cram.Decay(n0), cached.Decay(n0));
+}
+
+TEST(DecayOperatorsTests, Composition) {
+  DecayOperators ops(3600, 1);
+  CompMap v;
+  v[551370000] = 1;
+  v[922350000] = 2;
+  Composition::Ptr c1 = Composition::CreateFromAtom(v);
+  Composition::Ptr c2 = Composition::CreateFromAtom(v);
+  Composition::Ptr d1 = c1->Decay(6, 3600);
+  Composition::Ptr d2 = c2->Decay(6, 3600, &ops);
+  ExpectNear(d1->atom_vec(), d2->atom_vec());
+  EXPECT_EQ(d2, c2->Decay(6, 3600, &ops));
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "error.h"
+#include "exchange_capture.h"
+#include "exchange_graph.h"
+#include "greedy_solver.h"
+
+using cyclus::Arc;
+using cyclus::ExchangeCapture;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::GreedySolver;
+using cyclus::RequestGroup;
+
+// a request group with an exclusive and a nonexclusive node and a supply
+// group with two capacities
+static ExchangeGraph::Ptr SmallGraph() {
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  RequestGroup::Ptr r(new RequestGroup(3));
+  r->AddCapacity(3);
+  ExchangeNode::Ptr u1(new ExchangeNode(1, true, "a", 4));
+  ExchangeNode::Ptr u2(new ExchangeNode(2, false, "b", 4));
+  r->AddExchangeNode(u1);
+  r->AddExchangeNode(u2);
+  g->AddRequestGroup(r);
+
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(5);
+  s->AddCapacity(2.5);
+  ExchangeNode::Ptr v1(new ExchangeNode(1, false, "a", 7));
+  ExchangeNode::Ptr v2(new ExchangeNode(4, false, "b", 7));
+  s->AddExchangeNode(v1);
+  s->AddExchangeNode(v2);
+  g->AddSupplyGroup(s);
+
+  ExchangeNode::Ptr us[] = {u1, u2};
+  ExchangeNode::Ptr vs[] = {v1, v2};
+  for (int i = 0; i < 2; ++i) {
+    Arc a(us[i], vs[i]);
+    a.pref(i + 1.5);
+    us[i]->prefs[a] = i + 1.5;
+    us[i]->unit_capacities[a].push_back(1);
+    vs[i]->unit_capacities[a].push_back(1);
+    vs[i]->unit_capacities[a].push_back(0.5 * i);
+    g->AddArc(a);
+  }
+  return g;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeCaptureTests, FromFingerprint) {
+  ExchangeGraph::Ptr g = SmallGraph();
+  ExchangeGraph::Ptr copy = ExchangeGraph::FromFingerprint(g->Fingerprint());
+  EXPECT_EQ(g->Fingerprint(), copy->Fingerprint());
+  ASSERT_EQ(2, copy->arcs().size());
+  EXPECT_TRUE(copy->arcs()[0].exclusive());
+  EXPECT_EQ(1, copy->request_groups()[0]->excl_node_groups().size());
+  EXPECT_EQ("b", copy->arcs()[1].unode()->commod);
+
+  GreedySolver s1;
+  GreedySolver s2;
+  EXPECT_DOUBLE_EQ(s1.Solve(g.get()), s2.Solve(copy.get()));
+  ASSERT_EQ(g->matches().size(), copy->matches().size());
+  for (int i = 0; i < g->matches().size(); ++i) {
+    EXPECT_EQ(g->arc_ids().at(g->matches()[i].first),
+              copy->arc_ids().at(copy->matches()[i].first));
+    EXPECT_DOUBLE_EQ(g->matches()[i].second, copy->matches()[i].second);
+  }
+
+  std::string fp = g->Fingerprint();
+  EXPECT_THROW(ExchangeGraph::FromFingerprint(fp.substr(0, fp.size() - 1)),
+               cyclus::ValueError);
+  EXPECT_THROW(ExchangeGraph::FromFingerprint(fp + "x"), cyclus::ValueError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeCaptureTests, ReadWrite) {
+  ExchangeGraph::Ptr g = SmallGraph();
+  std::stringstream ss;
+  ExchangeCapture(3, "Material", g).Write(ss);
+  ExchangeCapture(4, "Product", g).Write(ss);
+
+  ExchangeCapture cap;
+  ASSERT_TRUE(cap.Read(ss));
+  EXPECT_EQ(3, cap.time);
+  EXPECT_EQ("Material", cap.restype);
+  EXPECT_EQ(g->Fingerprint(), cap.graph->Fingerprint());
+  ASSERT_TRUE(cap.Read(ss));
+  EXPECT_EQ(4, cap.time);
+  EXPECT_EQ("Product", cap.restype);
+  EXPECT_FALSE(cap.Read(ss));
+
+  std::stringstream bad("not a capture");
+  EXPECT_THROW(cap.Read(bad), cyclus::ValueError);
+
+  std::stringstream trunc;
+  ExchangeCapture(3, "Material", g).Write(trunc);
+  std::stringstream cut(trunc.str().substr(0, trunc.str().size() - 3));
+  EXPECT_THROW(cap.Read(cut), cyclus::ValueError);
+}
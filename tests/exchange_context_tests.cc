@@ -162,10 +162,10 @@ TEST_F(ExchangeContextTests, AddBid1) {
 
   PrefMap<Resource>::type obs;
   obs[req1].insert(std::make_pair(bid, req1->preference()));
-  EXPECT_EQ(context.trader_prefs[req1->requester()], obs);
+  EXPECT_EQ(context.Prefs(req1->requester()), obs);
   obs.clear();
   obs[req1].insert(std::make_pair(bid, req1->preference() * 0.1));
-  EXPECT_NE(context.trader_prefs[req1->requester()], obs);
+  EXPECT_NE(context.Prefs(req1->requester()), obs);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -224,3 +224,39 @@ TEST_F(ExchangeContextTests, AddBid2) {
   bidders.insert(fac2);
   EXPECT_EQ(bidders, context.bidders);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ExchangeContextTests, ArcPrefs) {
+  ExchangeContext<Resource> context;
+  context.AddRequestPortfolio(rp1);
+  context.AddRequestPortfolio(rp2);
+
+  BidPortfolio<Resource>::Ptr bp1(new BidPortfolio<Resource>());
+  bp1->AddBid(req1, get_mat(), fac1);
+  bp1->AddBid(req2, get_mat(), fac1);
+  BidPortfolio<Resource>::Ptr bp2(new BidPortfolio<Resource>());
+  Bid<Resource>* bid = bp2->AddBid(req1, get_mat(), fac2);
+  context.AddBidPortfolio(bp1);
+  context.AddBidPortfolio(bp2);
+
+  // arcs are numbered by portfolio in bid order
+  ASSERT_EQ(3, context.arc_prefs.size());
+  std::vector<int> starts;
+  starts.push_back(0);
+  starts.push_back(2);
+  EXPECT_EQ(starts, context.bid_port_arcs);
+  EXPECT_EQ(bid, context.arc_bids[2]);
+  EXPECT_EQ(req1->preference(), context.arc_prefs[2]);
+  EXPECT_EQ(req1->preference(), context.pref(bid));
+
+  // adjusted preferences are stored by arc, and removed ones are zeroed
+  Trader* t = req1->requester();
+  PrefMap<Resource>::type prefs = context.Prefs(t);
+  prefs[req1][bid] = 42;
+  context.SetPrefs(t, prefs);
+  EXPECT_EQ(42, context.arc_prefs[2]);
+  EXPECT_EQ(prefs, context.Prefs(t));
+  prefs[req1].erase(bid);
+  context.SetPrefs(t, prefs);
+  EXPECT_EQ(0, context.arc_prefs[2]);
+}
@@ -130,3 +130,99 @@ TEST(ExGraphTests, AddMatch) {
   ASSERT_EQ(1, g.matches().size());
   EXPECT_EQ(match, g.matches().at(0));
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void FingerprintGraph(ExchangeGraph* g, double pref, double qty) {
+  RequestGroup::Ptr rgroup(new RequestGroup(qty));
+  ExchangeNode::Ptr u(new ExchangeNode(qty, false, "commod", 1));
+  rgroup->AddExchangeNode(u);
+  rgroup->AddCapacity(qty);
+
+  ExchangeNodeGroup::Ptr sgroup(new ExchangeNodeGroup());
+  ExchangeNode::Ptr v(new ExchangeNode(qty, false, "commod", 2));
+  sgroup->AddExchangeNode(v);
+  sgroup->AddCapacity(2 * qty);
+
+  Arc a(u, v);
+  u->unit_capacities[a].push_back(1);
+  v->unit_capacities[a].push_back(1);
+  u->prefs[a] = pref;
+
+  g->AddRequestGroup(rgroup);
+  g->AddSupplyGroup(sgroup);
+  g->AddArc(a);
+}
+
+TEST(ExGraphTests, Fingerprint) {
+  ExchangeGraph g1, g2, g3, g4;
+  FingerprintGraph(&g1, 1.0, 5.0);
+  FingerprintGraph(&g2, 1.0, 5.0);
+  FingerprintGraph(&g3, 2.0, 5.0);
+  FingerprintGraph(&g4, 1.0, 6.0);
+
+  EXPECT_EQ(g1.Fingerprint(), g2.Fingerprint());
+  EXPECT_NE(g1.Fingerprint(), g3.Fingerprint());
+  EXPECT_NE(g1.Fingerprint(), g4.Fingerprint());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, Components) {
+  // two requesters share a supplier, a third trades with its own supplier, and
+  // a fourth has no arcs at all
+  std::vector<RequestGroup::Ptr> rgs;
+  std::vector<ExchangeNode::Ptr> us;
+  for (int i = 0; i < 4; ++i) {
+    RequestGroup::Ptr rg(new RequestGroup(1));
+    ExchangeNode::Ptr u(new ExchangeNode(1));
+    rg->AddExchangeNode(u);
+    rgs.push_back(rg);
+    us.push_back(u);
+  }
+  std::vector<ExchangeNodeGroup::Ptr> sgs;
+  std::vector<ExchangeNode::Ptr> vs;
+  for (int i = 0; i < 2; ++i) {
+    ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+    ExchangeNode::Ptr v(new ExchangeNode(1));
+    sg->AddExchangeNode(v);
+    sgs.push_back(sg);
+    vs.push_back(v);
+  }
+
+  // request group 2 trades with supply group 0, so it is in the first
+  // component even though its arc is added first
+  ExchangeGraph g;
+  g.AddRequestGroup(rgs[2]);
+  g.AddRequestGroup(rgs[0]);
+  g.AddRequestGroup(rgs[1]);
+  g.AddRequestGroup(rgs[3]);
+  g.AddSupplyGroup(sgs[1]);
+  g.AddSupplyGroup(sgs[0]);
+  Arc a2(us[2], vs[0]);
+  Arc a0(us[0], vs[1]);
+  Arc a1(us[1], vs[1]);
+  g.AddArc(a2);
+  g.AddArc(a0);
+  g.AddArc(a1);
+
+  std::vector<ExchangeGraph::Ptr> comps = g.Components();
+  ASSERT_EQ(2, comps.size());
+
+  ExchangeGraph::Ptr c = comps[0];
+  ASSERT_EQ(1, c->request_groups().size());
+  EXPECT_EQ(rgs[2], c->request_groups()[0]);
+  ASSERT_EQ(1, c->supply_groups().size());
+  EXPECT_EQ(sgs[0], c->supply_groups()[0]);
+  ASSERT_EQ(1, c->arcs().size());
+  EXPECT_EQ(a2, c->arcs()[0]);
+
+  c = comps[1];
+  ASSERT_EQ(2, c->request_groups().size());
+  EXPECT_EQ(rgs[0], c->request_groups()[0]);
+  EXPECT_EQ(rgs[1], c->request_groups()[1]);
+  ASSERT_EQ(1, c->supply_groups().size());
+  EXPECT_EQ(sgs[1], c->supply_groups()[0]);
+  ASSERT_EQ(2, c->arcs().size());
+  EXPECT_EQ(a0, c->arcs()[0]);
+  EXPECT_EQ(a1, c->arcs()[1]);
+  EXPECT_EQ(2, c->node_arc_map().at(vs[1]).size());
+}
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include "exchange_capture.h"
 #include "greedy_solver.h"
 #include "logger.h"
 #include "pyhooks.h"
+#include "sqlite_back.h"
 #include "test_context.h"
 #include "test_trader.h"
 
@@ -118,4 +124,209 @@ TEST(FullSimTests, Trade) {
   EXPECT_EQ(requester->mat, exp_mat);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(FullSimTests, ExchangeStats) {
+  TestContext tc;
+  GreedySolver* solver = new GreedySolver();  // context deletes
+  tc.get()->solver(solver);
+  SqliteBack b(":memory:");
+  tc.recorder()->RegisterBackend(&b);
+  TestObjFactory fac;
+  bool is_requester = true;
+
+  TestTrader* base_supplier = new TestTrader(tc.get(), &fac, !is_requester);
+  TestTrader* supplier =
+      dynamic_cast<TestTrader*>(base_supplier->Clone());
+  supplier->Build(NULL);
+
+  TestTrader* base_requester = new TestTrader(tc.get(), &fac, is_requester);
+  TestTrader* requester =
+      dynamic_cast<TestTrader*>(base_requester->Clone());
+  requester->Build(NULL);
+
+  int nsteps = 2;
+
+  PyStart();
+  tc.timer()->Initialize(tc.get(), SimInfo(nsteps));
+  tc.timer()->RunSim();
+  PyStop();
+  tc.recorder()->Close();
+
+  // one row per material exchange per timestep; the product exchanges are
+  // empty and not recorded
+  QueryResult qr = b.Query("ExchangeStats", NULL);
+  ASSERT_EQ(nsteps, qr.rows.size());
+
+  std::vector<Cond> conds;
+  conds.push_back(Cond("ResourceType", "==", Material::kType));
+  qr = b.Query("ExchangeStats", &conds);
+  ASSERT_EQ(nsteps, qr.rows.size());
+  double qty = fac.mat->quantity();
+  for (int i = 0; i < nsteps; ++i) {
+    EXPECT_EQ(2, qr.GetVal<int>("Traders", i));
+    EXPECT_EQ(1, qr.GetVal<int>("RequestPortfolios", i));
+    EXPECT_EQ(1, qr.GetVal<int>("BidPortfolios", i));
+    EXPECT_EQ(1, qr.GetVal<int>("Requests", i));
+    EXPECT_EQ(1, qr.GetVal<int>("Bids", i));
+    EXPECT_EQ(1, qr.GetVal<int>("Arcs", i));
+    EXPECT_EQ(0, qr.GetVal<int>("ExclusiveArcs", i));
+    EXPECT_LE(0, qr.GetVal<double>("SolveSeconds", i));
+    EXPECT_DOUBLE_EQ(0, qr.GetVal<double>("Unmatched", i));
+    std::map<std::string, double> matched =
+        qr.GetVal<std::map<std::string, double> >("Matched", i);
+    ASSERT_EQ(1, matched.size());
+    EXPECT_DOUBLE_EQ(qty, matched[fac.commod]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(FullSimTests, CaptureExchanges) {
+  std::string path = "full_sim_capture.dre";
+  std::remove(path.c_str());
+  setenv("CYCLUS_CAPTURE_DRE", path.c_str(), 1);
+
+  TestContext tc;
+  GreedySolver* solver = new GreedySolver();  // context deletes
+  tc.get()->solver(solver);
+  TestObjFactory fac;
+  bool is_requester = true;
+
+  TestTrader* base_supplier = new TestTrader(tc.get(), &fac, !is_requester);
+  TestTrader* supplier =
+      dynamic_cast<TestTrader*>(base_supplier->Clone());
+  supplier->Build(NULL);
+
+  TestTrader* base_requester = new TestTrader(tc.get(), &fac, is_requester);
+  TestTrader* requester =
+      dynamic_cast<TestTrader*>(base_requester->Clone());
+  requester->Build(NULL);
+
+  int nsteps = 2;
+
+  PyStart();
+  tc.timer()->Initialize(tc.get(), SimInfo(nsteps));
+  tc.timer()->RunSim();
+  PyStop();
+  unsetenv("CYCLUS_CAPTURE_DRE");
+
+  // only the material exchanges have bids to translate
+  std::ifstream is(path.c_str(), std::ios::in | std::ios::binary);
+  ExchangeCapture cap;
+  for (int i = 0; i < nsteps; ++i) {
+    ASSERT_TRUE(cap.Read(is));
+    EXPECT_EQ(Material::kType, cap.restype);
+    EXPECT_EQ(1, cap.graph->arcs().size());
+    EXPECT_TRUE(cap.graph->matches().empty());
+  }
+  EXPECT_FALSE(cap.Read(is));
+  is.close();
+  std::remove(path.c_str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class CountingSolver : public GreedySolver {
+ public:
+  CountingSolver() : solves(0) {}
+  int solves;
+
+ protected:
+  virtual double SolveGraph() {
+    solves++;
+    return GreedySolver::SolveGraph();
+  }
+};
+
+TEST(FullSimTests, IncrementalTrade) {
+  TestContext tc;
+  CountingSolver* solver = new CountingSolver();  // context deletes
+  tc.get()->solver(solver);
+  TestObjFactory fac;
+  bool is_requester = true;
+
+  TestTrader* base_supplier = new TestTrader(tc.get(), &fac, !is_requester);
+  TestTrader* supplier =
+      dynamic_cast<TestTrader*>(base_supplier->Clone());
+  supplier->Build(NULL);
+
+  TestTrader* base_requester = new TestTrader(tc.get(), &fac, is_requester);
+  TestTrader* requester =
+      dynamic_cast<TestTrader*>(base_requester->Clone());
+  requester->Build(NULL);
+
+  int nsteps = 3;
+  SimInfo si(nsteps);
+  si.incremental_exchange = true;
+
+  PyStart();
+  tc.get()->InitSim(si);
+  tc.timer()->RunSim();
+  PyStop();
+
+  // the same graph is presented every step, so only the first is solved
+  EXPECT_EQ(1, solver->solves);
+  EXPECT_EQ(nsteps, supplier->offer);
+  EXPECT_EQ(nsteps, requester->accept);
+  EXPECT_EQ(requester->obs_trade, supplier->obs_trade);
+}
+
+// requests (and is offered) one more unit of its factory's material each step
+class GrowingTrader : public TestTrader {
+ public:
+  GrowingTrader(Context* ctx, TestObjFactory* fac = NULL)
+      : TestTrader(ctx, fac) {}
+
+  virtual Agent* Clone() {
+    GrowingTrader* m = new GrowingTrader(context());
+    m->InitFrom(this);
+    return m;
+  }
+
+  virtual std::set<RequestPortfolio<Material>::Ptr> GetMatlRequests() {
+    obj_fac->mat = Material::CreateUntracked(context()->time() + 1,
+                                             obj_fac->mat->comp());
+    return TestTrader::GetMatlRequests();
+  }
+};
+
+TEST(FullSimTests, IncrementalComponents) {
+  TestContext tc;
+  CountingSolver* solver = new CountingSolver();  // context deletes
+  solver->decompose(true);
+  tc.get()->solver(solver);
+  bool is_requester = true;
+
+  // one market stays the same and the other grows every step
+  TestObjFactory same;
+  TestTrader* base_supplier = new TestTrader(tc.get(), &same, !is_requester);
+  TestTrader* supplier = dynamic_cast<TestTrader*>(base_supplier->Clone());
+  supplier->Build(NULL);
+  TestTrader* base_requester = new TestTrader(tc.get(), &same, is_requester);
+  TestTrader* requester = dynamic_cast<TestTrader*>(base_requester->Clone());
+  requester->Build(NULL);
+
+  TestObjFactory growing;
+  growing.commod = "growing";
+  TestTrader* base_grower = new TestTrader(tc.get(), &growing, !is_requester);
+  TestTrader* grower = dynamic_cast<TestTrader*>(base_grower->Clone());
+  grower->Build(NULL);
+  GrowingTrader* base_buyer = new GrowingTrader(tc.get(), &growing);
+  TestTrader* buyer = dynamic_cast<TestTrader*>(base_buyer->Clone());
+  buyer->Build(NULL);
+
+  int nsteps = 3;
+  SimInfo si(nsteps);
+  si.incremental_exchange = true;
+
+  PyStart();
+  tc.get()->InitSim(si);
+  tc.timer()->RunSim();
+  PyStop();
+
+  // both markets are solved in the first step, then only the growing one
+  EXPECT_EQ(2 + nsteps - 1, solver->solves);
+  EXPECT_EQ(nsteps, requester->accept);
+  EXPECT_EQ(nsteps, buyer->accept);
+  EXPECT_DOUBLE_EQ(nsteps, buyer->mat->quantity());
+}
+
 }  // namespace cyclus
@@ -1,18 +1,26 @@
 #include <gtest/gtest.h>
 
+#include <map>
+#include <set>
+
+#include "compact_graph.h"
+#include "context.h"
 #include "exchange_graph.h"
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
 #include "error.h"
+#include "test_context.h"
 
 using cyclus::Arc;
 using cyclus::AvgPrefComp;
+using cyclus::CompactGraph;
 using cyclus::ExchangeGraph;
 using cyclus::ExchangeNode;
 using cyclus::ExchangeNodeGroup;
 using cyclus::RequestGroup;
 using cyclus::GreedySolver;
 using cyclus::GreedyPreconditioner;
+using cyclus::Match;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(GreedySolverTests, AvgPref) {
@@ -83,3 +91,201 @@ TEST(GreedySolverTests, General) {
   EXPECT_EQ(g.request_groups()[1], gu1);
   EXPECT_EQ(g.request_groups()[0], gu2);
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// builds n independent markets, each with two competing requesters and one
+// supplier that can only satisfy one of them
+// adds markets first, ..., first + n - 1, each an independent component whose
+// supplier has the market's number as its agent id
+static void MarketsGraph(ExchangeGraph* g, int n, int first = 0) {
+  for (int i = first; i < first + n; ++i) {
+    ExchangeNode::Ptr v(new ExchangeNode());
+    v->agent_id = i;
+    ExchangeNodeGroup::Ptr gv(new ExchangeNodeGroup());
+    gv->AddExchangeNode(v);
+    gv->AddCapacity(1 + i);
+    g->AddSupplyGroup(gv);
+
+    for (int j = 0; j < 2; ++j) {
+      ExchangeNode::Ptr u(new ExchangeNode());
+      Arc a(u, v);
+      u->prefs[a] = (1 + j) * (1 + i);
+      u->unit_capacities[a].push_back(1);
+      v->unit_capacities[a].push_back(1);
+      RequestGroup::Ptr gu(new RequestGroup(1 + i));
+      gu->AddExchangeNode(u);
+      gu->AddCapacity(1 + i);
+      g->AddRequestGroup(gu);
+      g->AddArc(a);
+    }
+  }
+}
+
+static std::map<int, double> MatchedById(ExchangeGraph& g) {
+  std::map<int, double> flows;
+  const std::vector<Match>& matches = g.matches();
+  for (int i = 0; i < matches.size(); ++i) {
+    flows[g.arc_ids().at(matches[i].first)] += matches[i].second;
+  }
+  return flows;
+}
+
+TEST(GreedySolverTests, Decompose) {
+  ExchangeGraph whole;
+  MarketsGraph(&whole, 5);
+  GreedySolver s1(false);
+  double obj = s1.Solve(&whole);
+
+  // without a context the components are solved one after another
+  ExchangeGraph serial;
+  MarketsGraph(&serial, 5);
+  GreedySolver s2(false);
+  s2.decompose(true);
+  double serial_obj = s2.Solve(&serial);
+  EXPECT_EQ(5, MatchedById(whole).size());
+  EXPECT_EQ(MatchedById(whole), MatchedById(serial));
+
+  // unmet demand in every component is costed like in the whole graph
+  EXPECT_NEAR(obj, serial_obj, 1e-9);
+
+  // with a worker pool each component gets its own clone of the solver
+  cyclus::TestContext tc;
+  cyclus::SimInfo si(1);
+  si.threads = 4;
+  tc.get()->InitSim(si);
+  ExchangeGraph parallel;
+  MarketsGraph(&parallel, 5);
+  GreedySolver s3(false);
+  s3.decompose(true);
+  s3.sim_ctx(tc.get());
+  double parallel_obj = s3.Solve(&parallel);
+  EXPECT_EQ(MatchedById(whole), MatchedById(parallel));
+  EXPECT_NEAR(obj, parallel_obj, 1e-9);
+}
+
+TEST(GreedySolverTests, GivenCompactGraph) {
+  ExchangeGraph built;
+  MarketsGraph(&built, 3);
+  GreedySolver s1(false);
+  double obj = s1.Solve(&built);
+
+  // a snapshot taken before the solver ordered the graph is reordered and
+  // kept rather than rebuilt
+  ExchangeGraph given;
+  MarketsGraph(&given, 3);
+  CompactGraph::Ptr cg(new CompactGraph(&given));
+  GreedySolver s2(false);
+  s2.compact_graph(cg);
+  EXPECT_DOUBLE_EQ(obj, s2.Solve(&given));
+  EXPECT_EQ(cg, s2.compact_graph());
+  EXPECT_EQ(MatchedById(built), MatchedById(given));
+}
+
+// keeps its clones like a persistent solver, counting the live solvers and
+// the graphs they solved, and logging the markets each one solved
+class KeepingSolver : public GreedySolver {
+ public:
+  KeepingSolver() : GreedySolver(false) { live++; }
+  virtual ~KeepingSolver() { live--; }
+
+  virtual cyclus::ExchangeSolver* Clone() const { return new KeepingSolver(); }
+
+  static int live;
+  static int solves;
+  static std::map<const KeepingSolver*, std::set<int> > markets;
+
+ protected:
+  virtual double SolveGraph() {
+    solves++;
+    markets[this].insert(graph_->arcs()[0].vnode()->agent_id);
+    return GreedySolver::SolveGraph();
+  }
+
+  virtual bool KeepsClones() const { return true; }
+};
+
+int KeepingSolver::live = 0;
+int KeepingSolver::solves = 0;
+std::map<const KeepingSolver*, std::set<int> > KeepingSolver::markets;
+
+TEST(GreedySolverTests, DecomposeKeepsClones) {
+  ExchangeGraph whole;
+  MarketsGraph(&whole, 5);
+  GreedySolver s1(false);
+  s1.Solve(&whole);
+
+  // each component is solved by a clone, even without a worker pool, and the
+  // clones are reused for the components of the next graph
+  KeepingSolver::solves = 0;
+  KeepingSolver s2;
+  s2.decompose(true);
+  for (int i = 0; i < 2; ++i) {
+    ExchangeGraph g;
+    MarketsGraph(&g, 5);
+    s2.Solve(&g);
+    EXPECT_EQ(MatchedById(whole), MatchedById(g));
+  }
+  EXPECT_EQ(1 + 5, KeepingSolver::live);
+  EXPECT_EQ(2 * 5, KeepingSolver::solves);
+
+  // clones of missing components are dropped, and the others keep solving
+  // the component with the same columns even though it moved
+  ExchangeGraph fewer;
+  MarketsGraph(&fewer, 3, 2);
+  s2.Solve(&fewer);
+  EXPECT_EQ(1 + 3, KeepingSolver::live);
+  EXPECT_EQ(5, KeepingSolver::markets.size());
+  std::map<const KeepingSolver*, std::set<int> >::iterator it;
+  for (it = KeepingSolver::markets.begin();
+       it != KeepingSolver::markets.end(); ++it) {
+    EXPECT_EQ(1, it->second.size());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(GreedySolverTests, MatchOrder) {
+  ExchangeNode::Ptr u1(new ExchangeNode(1));
+  ExchangeNode::Ptr u2(new ExchangeNode(1));
+  ExchangeNode::Ptr v1(new ExchangeNode(1));
+  ExchangeNode::Ptr v2(new ExchangeNode(1));
+
+  Arc a1(u1, v1);
+  Arc a2(u2, v1);
+  Arc a3(u2, v2);
+  Arc arcs[] = {a1, a2, a3};
+  double prefs[] = {1, 1, 3};
+
+  RequestGroup::Ptr r(new RequestGroup(1));
+  r->AddExchangeNode(u1);
+  r->AddExchangeNode(u2);
+  r->AddCapacity(1);
+  ExchangeNodeGroup::Ptr s1(new ExchangeNodeGroup());
+  s1->AddExchangeNode(v1);
+  s1->AddCapacity(10);
+  ExchangeNodeGroup::Ptr s2(new ExchangeNodeGroup());
+  s2->AddExchangeNode(v2);
+  s2->AddCapacity(10);
+
+  ExchangeGraph g;
+  g.AddRequestGroup(r);
+  g.AddSupplyGroup(s1);
+  g.AddSupplyGroup(s2);
+  for (int i = 0; i < 3; ++i) {
+    Arc& a = arcs[i];
+    a.unode()->prefs[a] = prefs[i];
+    a.unode()->unit_capacities[a].push_back(1);
+    a.vnode()->unit_capacities[a].push_back(1);
+    g.AddArc(a);
+  }
+
+  GreedySolver s(false);
+  s.Solve(&g);
+
+  // the node with the larger average preference is visited first, and its
+  // most preferred arc is matched first
+  EXPECT_EQ(u2, r->nodes()[0]);
+  EXPECT_EQ(u1, r->nodes()[1]);
+  ASSERT_EQ(1, g.matches().size());
+  EXPECT_EQ(a3, g.matches()[0].first);
+  EXPECT_DOUBLE_EQ(1, g.matches()[0].second);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "error.h"
+#include "id_seq.h"
+#include "thread_pool.h"
+
+using cyclus::IdBlocks;
+using cyclus::IdHints;
+using cyclus::IdSeq;
+using cyclus::ThreadPool;
+
+static IdSeq seq(IdSeq::kFirstFreeKey, 1);
+
+// runs a batch of six tasks on pool, task i drawing i + extra ids, and returns
+// the ids drawn by each task
+static std::vector<std::vector<int> > Draw(ThreadPool* pool, IdHints* hints,
+                                           int extra) {
+  std::vector<int> keys;
+  for (int i = 0; i < 6; ++i) {
+    keys.push_back(10 + i);
+  }
+  std::vector<std::vector<int> > ids(keys.size());
+  IdBlocks blocks(keys, hints);
+  pool->ParallelFor(keys.size(), [&](int i) {
+    blocks.Run(i, [&] {
+      for (int k = 0; k < i + extra; ++k) {
+        ids[i].push_back(seq++);
+      }
+    });
+  });
+  return ids;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, Next) {
+  seq = 5;
+  EXPECT_EQ(5, seq++);
+  EXPECT_EQ(6, seq.Next());
+  EXPECT_EQ(7, seq.load());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, Keys) {
+  // a key is taken by at most one sequence, whatever order they are built in
+  EXPECT_THROW(IdSeq dup(IdSeq::kFirstFreeKey, 1), cyclus::ValueError);
+  EXPECT_THROW(IdSeq neg(-1, 1), cyclus::ValueError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, NoHints) {
+  // without blocks, tasks draw from the counter one after another
+  ThreadPool pool(4);
+  seq = 1;
+  std::vector<std::vector<int> > ids = Draw(&pool, NULL, 1);
+  int want = 1;
+  for (int i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(i + 1, ids[i].size());
+    for (int k = 0; k < ids[i].size(); ++k) {
+      EXPECT_EQ(want++, ids[i][k]);
+    }
+  }
+  EXPECT_EQ(want, seq.load());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, SameOnAnyPool) {
+  ThreadPool serial(1);
+  ThreadPool pool(4);
+  IdHints serial_hints;
+  IdHints pool_hints;
+
+  // the second batch fits its blocks, the third overflows them, and the last
+  // leaves some ids unused
+  int extras[] = {1, 1, 3, 0};
+  for (int b = 0; b < 4; ++b) {
+    seq = 1;
+    std::vector<std::vector<int> > want = Draw(&serial, &serial_hints,
+                                               extras[b]);
+    int next = seq.load();
+    seq = 1;
+    EXPECT_EQ(want, Draw(&pool, &pool_hints, extras[b]));
+    EXPECT_EQ(next, seq.load());
+
+    std::set<int> unique;
+    for (int i = 0; i < want.size(); ++i) {
+      unique.insert(want[i].begin(), want[i].end());
+      EXPECT_EQ(i + extras[b], want[i].size());
+    }
+    EXPECT_EQ(15 + 6 * extras[b], unique.size());
+  }
+  EXPECT_EQ(serial_hints, pool_hints);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, UnusedIdsLeaveGaps) {
+  // even on a single thread, ids a task reserved but did not use are skipped;
+  // tasks without hints reserve default blocks
+  ThreadPool serial(1);
+  IdHints hints;
+  seq = 1;
+  std::vector<std::vector<int> > first = Draw(&serial, &hints, 2);
+  for (int i = 0; i < first.size(); ++i) {
+    ASSERT_EQ(i + 2, first[i].size());
+    EXPECT_EQ(1 + i * IdBlocks::kDefaultBlock, first[i][0]);
+  }
+  EXPECT_EQ(1 + 6 * IdBlocks::kDefaultBlock, seq.load());
+
+  seq = 1;
+  std::vector<std::vector<int> > ids = Draw(&serial, &hints, 0);
+  int block = 1;
+  for (int i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(i, ids[i].size());
+    for (int k = 0; k < i; ++k) {
+      EXPECT_EQ(block + k, ids[i][k]);
+    }
+    block += i + 2;
+  }
+  EXPECT_EQ(block, seq.load());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(IdSeqTests, WaitTurn) {
+  // later tasks get to the shared state first, but wait for earlier ones
+  ThreadPool pool(4);
+  std::vector<int> keys;
+  for (int i = 0; i < 6; ++i) {
+    keys.push_back(i);
+  }
+  std::mutex mtx;
+  std::vector<int> order;
+  IdBlocks blocks(keys, NULL);
+  pool.ParallelFor(keys.size(), [&](int i) {
+    blocks.Run(i, [&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5 * (6 - i)));
+      IdBlocks::WaitTurn();
+      std::lock_guard<std::mutex> lk(mtx);
+      order.push_back(i);
+    });
+  });
+  EXPECT_EQ(keys, order);
+
+  // outside of a batch it returns right away
+  IdBlocks::WaitTurn();
+}
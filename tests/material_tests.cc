@@ -234,6 +234,30 @@ TEST_F(MaterialTest, DecayResBuf) {
   EXPECT_NE(sr89_qty, mq.mass(sr89_));
 }
 
+TEST_F(MaterialTest, DecayAll) {
+  // decay a material on its own for reference
+  Material::Ptr ref = Material::CreateUntracked(
+      1, Composition::CreateFromMass(diff_comp_->mass()));
+  ref->Decay(100);
+
+  Material::Ptr m1 = Material::CreateUntracked(1, diff_comp_);
+  Material::Ptr m2 = Material::CreateUntracked(2, diff_comp_);
+  Material::Ptr m3 = Material::CreateUntracked(3, test_comp_);
+  std::vector<Material::Ptr> mats;
+  mats.push_back(m1);
+  mats.push_back(m2);
+  mats.push_back(m1);
+  mats.push_back(m3);
+  Material::DecayAll(mats, 100);
+
+  EXPECT_EQ(ref->comp()->mass(), m1->comp()->mass());
+  EXPECT_EQ(m1->comp(), m2->comp());
+  EXPECT_NE(diff_comp_, m1->comp());
+  EXPECT_EQ(100, m1->prev_decay_time());
+  EXPECT_EQ(100, m3->prev_decay_time());
+  EXPECT_DOUBLE_EQ(3, m3->quantity());
+}
+
 TEST_F(MaterialTest, DecayManual) {
   // prequeries
   cyclus::toolkit::MatQuery orig(tracked_mat_);
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include "compact_graph.h"
+#include "exchange_graph.h"
+#include "greedy_solver.h"
+#include "network_solver.h"
+
+using cyclus::Arc;
+using cyclus::CompactGraph;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::GreedySolver;
+using cyclus::NetworkSolver;
+using cyclus::RequestGroup;
+
+// adds a request group for qty with one node per supply group, each with the
+// given preference (or no arc if the preference is zero)
+static void AddRequest(ExchangeGraph* g, double qty, const double* prefs) {
+  RequestGroup::Ptr r(new RequestGroup(qty));
+  r->AddCapacity(qty);
+  g->AddRequestGroup(r);
+  for (int i = 0; i < g->supply_groups().size(); ++i) {
+    if (prefs[i] == 0) {
+      continue;
+    }
+    ExchangeNode::Ptr u(new ExchangeNode(qty));
+    r->AddExchangeNode(u);
+    ExchangeNode::Ptr v(new ExchangeNode());
+    g->supply_groups()[i]->AddExchangeNode(v);
+    Arc a(u, v);
+    a.pref(prefs[i]);
+    u->prefs[a] = prefs[i];
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    g->AddArc(a);
+  }
+}
+
+// two requests for 1 and two suppliers of 1, where the first request
+// slightly prefers the only supplier that the second request can use
+static void CrossedGraph(ExchangeGraph* g) {
+  for (int i = 0; i < 2; ++i) {
+    ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+    s->AddCapacity(1);
+    g->AddSupplyGroup(s);
+  }
+  double prefs1[] = {2, 1.9};
+  double prefs2[] = {1, 0};
+  AddRequest(g, 1, prefs1);
+  AddRequest(g, 1, prefs2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, IsNetwork) {
+  ExchangeGraph g;
+  CrossedGraph(&g);
+  EXPECT_TRUE(NetworkSolver::IsNetwork(CompactGraph(&g), true));
+
+  // mismatched unit capacities
+  ExchangeNode::Ptr v = g.arcs()[0].vnode();
+  v->unit_capacities[g.arcs()[0]][0] = 2;
+  EXPECT_FALSE(NetworkSolver::IsNetwork(CompactGraph(&g), true));
+  v->unit_capacities[g.arcs()[0]][0] = 1;
+
+  // multiple capacities
+  ExchangeGraph g2;
+  CrossedGraph(&g2);
+  g2.supply_groups()[0]->AddCapacity(1);
+  EXPECT_FALSE(NetworkSolver::IsNetwork(CompactGraph(&g2), true));
+
+  // exclusive arcs
+  ExchangeGraph g3;
+  CrossedGraph(&g3);
+  ExchangeNode::Ptr u(new ExchangeNode(1, true));
+  ExchangeNode::Ptr w(new ExchangeNode());
+  g3.request_groups()[0]->AddExchangeNode(u);
+  g3.supply_groups()[0]->AddExchangeNode(w);
+  Arc a(u, w);
+  a.pref(1);
+  u->prefs[a] = 1;
+  u->unit_capacities[a].push_back(1);
+  w->unit_capacities[a].push_back(1);
+  g3.AddArc(a);
+  EXPECT_FALSE(NetworkSolver::IsNetwork(CompactGraph(&g3), true));
+  EXPECT_TRUE(NetworkSolver::IsNetwork(CompactGraph(&g3), false));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, Optimal) {
+  // greedy gives the first request its preferred supplier, leaving the
+  // second request unmet
+  ExchangeGraph greedy_g;
+  CrossedGraph(&greedy_g);
+  GreedySolver greedy(false);
+  greedy.Solve(&greedy_g);
+  EXPECT_EQ(1, greedy_g.matches().size());
+
+  // the optimal solution meets both requests at a cost of 1 / 1.9 + 1 / 1,
+  // rather than 1 / 2 plus the pseudo cost of 1.1 for the unmet request
+  ExchangeGraph g;
+  CrossedGraph(&g);
+  NetworkSolver solver(false);
+  double obj = solver.Solve(&g);
+  ASSERT_EQ(2, g.matches().size());
+  EXPECT_DOUBLE_EQ(1 / 1.9 + 1, obj);
+  EXPECT_DOUBLE_EQ(2.9, g.matches()[0].first.pref() +
+                        g.matches()[1].first.pref());
+  EXPECT_DOUBLE_EQ(1, g.matches()[0].second);
+  EXPECT_DOUBLE_EQ(1, g.matches()[1].second);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, Unmet) {
+  // one supplier of 1.5 for requests of 1 and 2
+  ExchangeGraph g;
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(1.5);
+  g.AddSupplyGroup(s);
+  double prefs1[] = {1};
+  double prefs2[] = {4};
+  AddRequest(&g, 1, prefs1);
+  AddRequest(&g, 2, prefs2);
+
+  NetworkSolver solver(false);
+  solver.Solve(&g);
+
+  // the preferred request gets everything
+  ASSERT_EQ(1, g.matches().size());
+  EXPECT_DOUBLE_EQ(4, g.matches()[0].first.pref());
+  EXPECT_DOUBLE_EQ(1.5, g.matches()[0].second);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, GivenCompactGraph) {
+  ExchangeGraph g;
+  CrossedGraph(&g);
+  CompactGraph::Ptr cg(new CompactGraph(&g));
+  NetworkSolver solver(false);
+  solver.compact_graph(cg);
+  EXPECT_DOUBLE_EQ(1 / 1.9 + 1, solver.Solve(&g));
+  EXPECT_EQ(cg, solver.compact_graph());
+
+  // the snapshot is only given for one solve
+  ExchangeGraph g2;
+  CrossedGraph(&g2);
+  solver.Solve(&g2);
+  ASSERT_TRUE(solver.compact_graph() != NULL);
+  EXPECT_NE(cg, solver.compact_graph());
+  EXPECT_EQ(&g2, solver.compact_graph()->graph());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, Fallback) {
+  ExchangeGraph g;
+  CrossedGraph(&g);
+  g.supply_groups()[0]->AddCapacity(10);
+  g.supply_groups()[1]->AddCapacity(10);
+  for (int i = 0; i < g.arcs().size(); ++i) {
+    const Arc& a = g.arcs()[i];
+    a.vnode()->unit_capacities[a].push_back(1);
+  }
+
+  NetworkSolver solver(false);
+  EXPECT_NO_THROW(solver.Solve(&g));
+  EXPECT_FALSE(g.matches().empty());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NetworkSolverTests, FallbackPseudoCost) {
+  // one supplier of 1.5 with two capacities for requests of 1 and 2, so 1.5
+  // is unmet in a graph that is not a network
+  double obj[2];
+  double costs[] = {10, 100};
+  for (int i = 0; i < 2; ++i) {
+    ExchangeGraph g;
+    ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+    s->AddCapacity(1.5);
+    s->AddCapacity(10);
+    g.AddSupplyGroup(s);
+    double prefs1[] = {1};
+    double prefs2[] = {4};
+    AddRequest(&g, 1, prefs1);
+    AddRequest(&g, 2, prefs2);
+    for (int j = 0; j < g.arcs().size(); ++j) {
+      const Arc& a = g.arcs()[j];
+      a.vnode()->unit_capacities[a].push_back(1);
+    }
+
+    // the fallback prices unmet demand at the fixed pseudo cost
+    NetworkSolver solver(false);
+    solver.pseudo_cost(costs[i]);
+    obj[i] = solver.Solve(&g);
+  }
+  EXPECT_NEAR(1.5 * (costs[1] - costs[0]), obj[1] - obj[0], 1e-6);
+}
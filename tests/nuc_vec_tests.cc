@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "error.h"
+#include "nuc_vec.h"
+
+using cyclus::CompMap;
+using cyclus::NucVec;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NucVecTests, CompMap) {
+  CompMap m;
+  m[922380000] = 2;
+  m[10010000] = 1;
+  m[922350000] = 3;
+  NucVec v(m);
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ(10010000, v.nucs()[0]);
+  EXPECT_EQ(922380000, v.nucs()[2]);
+  EXPECT_DOUBLE_EQ(3, v.Get(922350000));
+  EXPECT_DOUBLE_EQ(0, v.Get(942390000));
+  EXPECT_EQ(m, v.ToMap());
+  EXPECT_TRUE(NucVec().empty());
+
+  v.PushBack(942390000, 4);
+  EXPECT_DOUBLE_EQ(4, v.Get(942390000));
+  EXPECT_THROW(v.PushBack(922350000, 1), cyclus::ValueError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(NucVecTests, Dense) {
+  int n = NucVec::DenseSize();
+  ASSERT_GT(n, 0);
+
+  // round trip every nuclide the solver knows through a dense vector
+  std::vector<double> x(n);
+  for (int i = 0; i < n; ++i) {
+    x[i] = i + 1;
+  }
+  NucVec v = NucVec::FromDense(x.data());
+  ASSERT_EQ(n, v.size());
+  for (int k = 0; k < n; ++k) {
+    if (k > 0) {
+      EXPECT_LT(v.nucs()[k - 1], v.nucs()[k]);
+    }
+    EXPECT_EQ(NucVec::DenseIndex(v.nucs()[k]), v.dense()[k]);
+    EXPECT_DOUBLE_EQ(v.dense()[k] + 1, v.vals()[k]);
+  }
+
+  std::vector<double> y(n, 0.0);
+  v.ScatterDense(y.data());
+  EXPECT_EQ(x, y);
+
+  // non-positive entries are dropped
+  x[0] = 0;
+  EXPECT_EQ(n - 1, NucVec::FromDense(x.data()).size());
+
+  // nuclides unknown to the solver are kept but not scattered
+  CompMap m;
+  m[-1] = 7;
+  NucVec u(m);
+  EXPECT_EQ(-1, u.dense()[0]);
+  std::vector<double> z(n, 0.0);
+  u.ScatterDense(z.data());
+  EXPECT_EQ(std::vector<double>(n, 0.0), z);
+}
@@ -212,7 +212,12 @@ TEST(ProgTranslatorTests, translation) {
   double row_val_7[] = {1, 1};
   m.appendRow(2, row_ind_7, row_val_7);
 
+  // the translator assembles the matrix column by column
+  m.reverseOrdering();
   EXPECT_TRUE(m.isEquivalent2(pt.ctx().m));
+  ASSERT_EQ(narcs + nfaux + 1, pt.ctx().col_starts.size());
+  EXPECT_EQ(m.getNumElements(), pt.ctx().col_starts.back());
+  EXPECT_EQ(m.getNumElements(), pt.ctx().elements.size());
 
   // test population
   EXPECT_NO_THROW(pt.Populate());
@@ -216,6 +216,41 @@ TEST(RecorderTest, Datum_addVal) {
   EXPECT_EQ(d, back.data.back());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(RecorderTest, BufferMerge) {
+  using cyclus::Recorder;
+  TestBack back;
+  Recorder m;
+  m.set_dump_count(1);
+  m.RegisterBackend(&back);
+
+  cyclus::DatumBuffer buf;
+  Recorder::BindBuffer(&buf);
+  m.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("monkey"))
+      ->Record();
+  m.NewDatum("DumbTitle")
+      ->AddVal("animal", std::string("elephant"))
+      ->Record();
+  m.NewDatum("DumbTitle");  // never recorded
+  Recorder::BindBuffer(NULL);
+
+  EXPECT_EQ(back.notify_count, 0);
+  EXPECT_EQ(buf.created.size(), 3);
+  EXPECT_EQ(buf.recorded.size(), 2);
+
+  m.Merge(&buf);
+  EXPECT_EQ(back.notify_count, 2);
+  EXPECT_EQ(buf.created.size(), 0);
+  EXPECT_EQ(buf.recorded.size(), 0);
+
+  cyclus::Datum* d = back.data.back();
+  ASSERT_EQ(d->vals().size(), 2);
+  EXPECT_STREQ(d->vals()[0].first, "SimId");
+  EXPECT_STREQ(d->vals()[1].first, "animal");
+  EXPECT_EQ(d->vals()[1].second.cast<std::string>(), "elephant");
+}
+
 
 //
 // Raw Recorder Test
@@ -109,6 +109,59 @@ class Bidder: public TestFacility {
   int bid_ctr_;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class ReentrantBidder: public Bidder {
+ public:
+  ReentrantBidder(Context* ctx, std::string commod) : Bidder(ctx, commod) {
+    cyclus::Agent::spec(":test:ReentrantBidder");
+  }
+
+  virtual cyclus::Agent* Clone() {
+    ReentrantBidder* m = new ReentrantBidder(context(), commod_);
+    m->InitFrom(this);
+    m->port_ = port_;
+    return m;
+  }
+
+  virtual Json::Value annotations() {
+    Json::Value a(Json::objectValue);
+    a["reentrant"] = true;
+    return a;
+  }
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// creates a different number of materials every time it is asked for bids
+class MintingBidder: public ReentrantBidder {
+ public:
+  MintingBidder(Context* ctx, std::string commod, int seed)
+      : ReentrantBidder(ctx, commod),
+        seed_(seed) {}
+
+  virtual cyclus::Agent* Clone() {
+    MintingBidder* m = new MintingBidder(context(), commod_, seed_);
+    m->InitFrom(this);
+    m->port_ = port_;
+    return m;
+  }
+
+  set<BidPortfolio<Material>::Ptr> GetMatlBids(
+      CommodMap<Material>::type& commod_requests) {
+    cyclus::CompMap cm;
+    cm[922350000] = 1;
+    int n = (seed_ + bid_ctr_) % 3 + 1;
+    for (int i = 0; i < n; ++i) {
+      Material::Ptr m = Material::Create(this, 1,
+                                         Composition::CreateFromMass(cm));
+      minted_.push_back(m->state_id());
+    }
+    return Bidder::GetMatlBids(commod_requests);
+  }
+
+  std::vector<int> minted_;
+  int seed_;
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 class ResourceExchangeTests: public ::testing::Test {
  protected:
@@ -223,6 +276,141 @@ TEST_F(ResourceExchangeTests, Bids) {
   clone->Decommission();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, ParallelBids) {
+  cyclus::SimInfo si(1);
+  si.threads = 4;
+  si.parallel_exchange = true;
+  tc.get()->InitSim(si);
+  delete exchng;
+  exchng = new ResourceExchange<Material>(tc.get());
+  ExchangeContext<Material>& ctx = exchng->ex_ctx();
+
+  RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+  req = rp->AddRequest(mat, reqr, commod, pref);
+  ctx.AddRequestPortfolio(rp);
+
+  // a serial bidder in the middle must keep its place among the shards
+  std::vector<Bidder*> bidders;
+  std::vector<Bid<Material>*> exp;
+  for (int i = 0; i < 6; ++i) {
+    Bidder* proto = i == 2 ? new Bidder(tc.get(), commod)
+                           : new ReentrantBidder(tc.get(), commod);
+    BidPortfolio<Material>::Ptr bp(new BidPortfolio<Material>());
+    proto->port_ = bp;
+    Bidder* b = dynamic_cast<Bidder*>(proto->Clone());
+    b->Build(NULL);
+    exp.push_back(bp->AddBid(req, mat, b));
+    bidders.push_back(b);
+  }
+
+  exchng->AddAllBids();
+
+  ASSERT_EQ(6, ctx.bids.size());
+  EXPECT_EQ(exp, ctx.bids_by_request[req]);
+  for (int i = 0; i < bidders.size(); ++i) {
+    EXPECT_EQ(1, bidders[i]->bid_ctr_);
+    EXPECT_EQ(bidders[i]->port_, ctx.bids[i]);
+    bidders[i]->Decommission();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// runs a few bid rounds of re-entrant bidders that create materials on the
+// given number of threads and returns the materials' ids in bidder order,
+// relative to the first one
+static std::vector<int> MintedBidIds(int threads) {
+  TestContext tc;
+  cyclus::SimInfo si(1);
+  si.threads = threads;
+  si.parallel_exchange = true;
+  tc.get()->InitSim(si);
+
+  cyclus::CompMap cm;
+  cm[922350000] = 1;
+  Material::Ptr mat = Material::CreateUntracked(1,
+      Composition::CreateFromMass(cm));
+  Requester* reqr = new Requester(tc.get());
+  RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+  rp->AddRequest(mat, reqr, "name", 1);
+
+  std::vector<MintingBidder*> bidders;
+  for (int i = 0; i < 5; ++i) {
+    MintingBidder* proto = new MintingBidder(tc.get(), "name", i);
+    proto->port_.reset(new BidPortfolio<Material>());
+    MintingBidder* b = dynamic_cast<MintingBidder*>(proto->Clone());
+    b->Build(NULL);
+    bidders.push_back(b);
+  }
+
+  cyclus::IdHints hints;
+  for (int round = 0; round < 3; ++round) {
+    ResourceExchange<Material> exchng(tc.get());
+    exchng.ex_ctx().AddRequestPortfolio(rp);
+    exchng.AddAllBids(&hints);
+  }
+
+  std::vector<int> ids;
+  int first = bidders[0]->minted_[0];
+  for (int i = 0; i < bidders.size(); ++i) {
+    std::vector<int>& minted = bidders[i]->minted_;
+    for (int j = 0; j < minted.size(); ++j) {
+      ids.push_back(minted[j] - first);
+    }
+    bidders[i]->Decommission();
+  }
+  return ids;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, ParallelBidsMintSameIds) {
+  std::vector<int> serial = MintedBidIds(1);
+  ASSERT_EQ(30, serial.size());
+  EXPECT_EQ(serial, MintedBidIds(4));
+  EXPECT_EQ(serial, MintedBidIds(8));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, SubscribedBids) {
+  ExchangeContext<Material>& ctx = exchng->ex_ctx();
+  RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+  req = rp->AddRequest(mat, reqr, commod, pref);
+  ctx.AddRequestPortfolio(rp);
+
+  // subscribed to the requested commodity, subscribed to another one, and
+  // not subscribed at all
+  std::vector<Bidder*> bidders;
+  for (int i = 0; i < 3; ++i) {
+    Bidder* proto = new Bidder(tc.get(), commod);
+    proto->port_.reset(new BidPortfolio<Material>());
+    Bidder* b = dynamic_cast<Bidder*>(proto->Clone());
+    b->Build(NULL);
+    bidders.push_back(b);
+  }
+  tc.get()->SubscribeBids(bidders[0], "other");
+  tc.get()->SubscribeBids(bidders[0], commod);
+  tc.get()->SubscribeBids(bidders[1], "other");
+
+  exchng->AddAllBids();
+  EXPECT_EQ(1, bidders[0]->bid_ctr_);
+  EXPECT_EQ(0, bidders[1]->bid_ctr_);
+  EXPECT_EQ(1, bidders[2]->bid_ctr_);
+
+  // subscriptions are dropped with the trader
+  bidders[1]->Decommission();
+  EXPECT_EQ(1, tc.get()->bid_commods().size());
+  EXPECT_EQ(1, tc.get()->commod_bidders().at("other").size());
+  bidders[0]->Decommission();
+  bidders[2]->Decommission();
+  EXPECT_TRUE(tc.get()->bid_commods().empty());
+  EXPECT_TRUE(tc.get()->commod_bidders().empty());
+
+  // only registered traders can subscribe
+  Bidder* loose = new Bidder(tc.get(), commod);
+  EXPECT_THROW(tc.get()->SubscribeBids(loose, commod), cyclus::ValueError);
+  EXPECT_TRUE(tc.get()->bid_commods().empty());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(ResourceExchangeTests, PrefCalls) {
   Facility* parent = dynamic_cast<Facility*>(reqr->Clone());
@@ -268,6 +456,60 @@ TEST_F(ResourceExchangeTests, PrefCalls) {
   parent->Decommission();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, AncestorPrefs) {
+  Facility* parent = dynamic_cast<Facility*>(reqr->Clone());
+  parent->Build(NULL);
+  Requester* pcast = dynamic_cast<Requester*>(parent);
+  RequestPortfolio<Material>::Ptr prp(new RequestPortfolio<Material>());
+  Request<Material>* preq = prp->AddRequest(mat, pcast, commod, pref);
+  pcast->port_ = prp;
+
+  Bidder* bidr = new Bidder(tc.get(), commod);
+  BidPortfolio<Material>::Ptr bp(new BidPortfolio<Material>());
+  Bid<Material>* pbid = bp->AddBid(preq, mat, bidr);
+
+  std::vector<Requester*> children;
+  std::vector<Bid<Material>*> cbids;
+  for (int i = 0; i < 3; ++i) {
+    Facility* child = dynamic_cast<Facility*>(reqr->Clone());
+    child->Build(parent);
+    Requester* ccast = dynamic_cast<Requester*>(child);
+    RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
+    Request<Material>* creq = rp->AddRequest(mat, ccast, commod, pref);
+    ccast->port_ = rp;
+    cbids.push_back(bp->AddBid(creq, mat, bidr));
+    children.push_back(ccast);
+  }
+  bidr->port_ = bp;
+  Facility* bclone = dynamic_cast<Facility*>(bidr->Clone());
+  bclone->Build(NULL);
+
+  exchng->AddAllRequests();
+  exchng->AddAllBids();
+  exchng->AdjustAll();
+
+  // the parent adjusts its own request and then each child's request, right
+  // after the child does
+  EXPECT_EQ(4, pcast->pref_ctr_);
+  ExchangeContext<Material>& context = exchng->ex_ctx();
+  EXPECT_DOUBLE_EQ(std::pow(pref, 2),
+                   context.Prefs(pcast)[pbid->request()][pbid]);
+  for (int i = 0; i < children.size(); ++i) {
+    EXPECT_EQ(1, children[i]->pref_ctr_);
+    Request<Material>* creq = cbids[i]->request();
+    ASSERT_EQ(1, context.Prefs(children[i]).size());
+    EXPECT_DOUBLE_EQ(std::pow(pref, 4),
+                     context.Prefs(children[i])[creq][cbids[i]]);
+  }
+
+  for (int i = 0; i < children.size(); ++i) {
+    children[i]->Decommission();
+  }
+  bclone->Decommission();
+  parent->Decommission();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(ResourceExchangeTests, PrefValues) {
   Facility* parent = dynamic_cast<Facility*>(reqr->Clone());
@@ -309,15 +551,15 @@ TEST_F(ResourceExchangeTests, PrefValues) {
   cobs[creq].insert(std::make_pair(cbid, creq->preference()));
 
   ExchangeContext<Material>& context = exchng->ex_ctx();
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.Prefs(parent), pobs);
+  EXPECT_EQ(context.Prefs(child), cobs);
 
   EXPECT_NO_THROW(exchng->AdjustAll());
 
   pobs[preq].begin()->second = std::pow(preq->preference(), 2);
   cobs[creq].begin()->second = std::pow(std::pow(creq->preference(), 2), 2);
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.Prefs(parent), pobs);
+  EXPECT_EQ(context.Prefs(child), cobs);
 
   child->Decommission();
   parent->Decommission();
@@ -102,7 +102,11 @@ class SimInitTest : public ::testing::Test {
         ->AddVal("Solver", std::string("greedy")) // str constructor for macs
         ->AddVal("ExclusiveOrders", true)
         ->Record();
-    ctx->InitSim(cy::SimInfo(5));
+    cy::SimInfo si(5);
+    si.threads = 2;
+    si.incremental_exchange = true;
+    si.parallel_exchange = true;
+    ctx->InitSim(si);
 
     cy::CompMap v;
     v[922350000] = 1;
@@ -220,6 +224,9 @@ TEST_F(SimInitTest, InitSimInfo) {
   EXPECT_EQ(si_orig.parent_sim, si_init.parent_sim);
   EXPECT_EQ(si_orig.parent_type, si_init.parent_type);
   EXPECT_EQ(si_orig.branch_time, si_init.branch_time);
+  EXPECT_EQ(si_orig.threads, si_init.threads);
+  EXPECT_EQ(si_orig.incremental_exchange, si_init.incremental_exchange);
+  EXPECT_EQ(si_orig.parallel_exchange, si_init.parallel_exchange);
 }
 
 TEST_F(SimInitTest, InitRecipes) {
@@ -148,4 +148,45 @@ TYPED_TEST(ExchangeSolverTest, ExclusiveGreedySolver) {
 
 #endif  // GTEST_HAS_TYPED_TEST
 
+#if CYCLUS_HAS_COIN
+// a request for 1 unit with two bids, the second of which is preferred
+static void TwoBidGraph(ExchangeGraph* g) {
+  ExchangeNode::Ptr u(new ExchangeNode(1, false, "commod", 1));
+  RequestGroup::Ptr r(new RequestGroup(1));
+  r->AddExchangeNode(u);
+  r->AddCapacity(1);
+  g->AddRequestGroup(r);
+
+  for (int i = 0; i < 2; i++) {
+    ExchangeNode::Ptr v(new ExchangeNode(1, false, "commod", 2 + i));
+    ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+    s->AddExchangeNode(v);
+    s->AddCapacity(1);
+    g->AddSupplyGroup(s);
+
+    Arc a(u, v);
+    a.pref(1 + i);
+    u->prefs[a] = 1 + i;
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    g->AddArc(a);
+  }
+}
+
+TEST(ProgSolverTests, Persistent) {
+  ProgSolver solver("cbc");
+  solver.persistent(true);
+
+  // the second, identical, exchange is warm started from the first
+  for (int i = 0; i < 2; i++) {
+    ExchangeGraph g;
+    TwoBidGraph(&g);
+    solver.Solve(&g);
+    ASSERT_EQ(1, g.matches().size());
+    EXPECT_EQ(3, g.matches()[0].first.vnode()->agent_id);
+    EXPECT_DOUBLE_EQ(1, g.matches()[0].second);
+  }
+}
+#endif  // CYCLUS_HAS_COIN
+
 }  // namespace cyclus
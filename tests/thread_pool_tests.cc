@@ -0,0 +1,56 @@
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "thread_pool.h"
+
+using cyclus::ThreadPool;
+
+static void Square(std::vector<int>* vals, int i) {
+  (*vals)[i] = i * i;
+}
+
+static void ThrowOnOdd(int i) {
+  if (i % 2 == 1) {
+    throw std::runtime_error("odd");
+  }
+}
+
+TEST(ThreadPoolTests, Size) {
+  EXPECT_EQ(1, ThreadPool().size());
+  EXPECT_EQ(1, ThreadPool(0).size());
+  EXPECT_EQ(4, ThreadPool(4).size());
+}
+
+TEST(ThreadPoolTests, ParallelFor) {
+  ThreadPool pool(4);
+  // reuse the pool to make sure workers pick up every job
+  for (int n = 0; n < 50; ++n) {
+    std::vector<int> vals(n, -1);
+    pool.ParallelFor(n, std::bind(&Square, &vals, std::placeholders::_1));
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(i * i, vals[i]);
+    }
+  }
+}
+
+TEST(ThreadPoolTests, Serial) {
+  ThreadPool pool(1);
+  std::vector<int> vals(10, -1);
+  pool.ParallelFor(10, std::bind(&Square, &vals, std::placeholders::_1));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i * i, vals[i]);
+  }
+}
+
+TEST(ThreadPoolTests, Exception) {
+  ThreadPool pool(4);
+  EXPECT_THROW(pool.ParallelFor(100, &ThrowOnOdd), std::runtime_error);
+
+  // the pool remains usable after a failed job
+  std::vector<int> vals(10, -1);
+  pool.ParallelFor(10, std::bind(&Square, &vals, std::placeholders::_1));
+  EXPECT_EQ(81, vals[9]);
+}
@@ -1,3 +1,7 @@
+#include <limits>
+#include <set>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "context.h"
@@ -97,6 +101,188 @@ class SnapperDec : public cyclus::Facility {
   bool snap;
 };
 
+// records one row per tick; the archetype optionally declares itself thread
+// safe so that its ticks may run concurrently
+class Ticker : public cyclus::Facility {
+ public:
+  Ticker(cyclus::Context* ctx, bool threadsafe)
+      : cyclus::Facility(ctx),
+        threadsafe_(threadsafe) {
+    cyclus::Agent::spec(threadsafe ? ":test:SafeTicker" : ":test:Ticker");
+  }
+  virtual ~Ticker() {}
+
+  virtual cyclus::Agent* Clone() { return new Ticker(context(), threadsafe_); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual Json::Value annotations() {
+    Json::Value a(Json::objectValue);
+    a["threadsafe"] = threadsafe_;
+    return a;
+  }
+
+  void Tick() {
+    context()->NewDatum("Ticks")
+        ->AddVal("AgentId", id())
+        ->AddVal("Time", context()->time())
+        ->Record();
+  }
+  void Tock() {}
+  void Decision() {}
+
+ private:
+  bool threadsafe_;
+};
+
+// creates and splits a few materials every tick, a different number each
+// timestep; the archetype optionally declares itself thread safe
+class Minter : public cyclus::Facility {
+ public:
+  Minter(cyclus::Context* ctx, bool threadsafe, int seed)
+      : cyclus::Facility(ctx),
+        threadsafe_(threadsafe),
+        seed_(seed) {
+    cyclus::Agent::spec(threadsafe ? ":test:SafeMinter" : ":test:Minter");
+  }
+  virtual ~Minter() {}
+
+  virtual cyclus::Agent* Clone() {
+    return new Minter(context(), threadsafe_, seed_);
+  }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual Json::Value annotations() {
+    Json::Value a(Json::objectValue);
+    a["threadsafe"] = threadsafe_;
+    return a;
+  }
+
+  void Tick() {
+    cyclus::CompMap v;
+    v[922350000] = 1;
+    int n = (seed_ + context()->time()) % 3 + 1;
+    for (int i = 0; i < n; ++i) {
+      cyclus::Material::Ptr m = cyclus::Material::Create(
+          this, 2, cyclus::Composition::CreateFromMass(v));
+      m->ExtractQty(1);
+    }
+  }
+  void Tock() {}
+  void Decision() {}
+
+ private:
+  bool threadsafe_;
+  int seed_;
+};
+
+// counts its notifications and goes to sleep for nap timesteps every time it
+// ticks
+class Sleeper : public cyclus::Facility {
+ public:
+  Sleeper(cyclus::Context* ctx)
+      : cyclus::Facility(ctx),
+        nap(0),
+        ticks(0),
+        tocks(0),
+        decisions(0) {}
+  virtual ~Sleeper() {}
+
+  virtual cyclus::Agent* Clone() { return new Sleeper(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  void Tick() {
+    ticks++;
+    if (nap > 0) {
+      context()->SchedWake(this, context()->time() + nap);
+    }
+  }
+  void Tock() { tocks++; }
+  void Decision() { decisions++; }
+
+  int nap;
+  int ticks;
+  int tocks;
+  int decisions;
+};
+
+// a trader that is not a time listener and only makes requests at a given
+// time, logging every time it is asked
+class Alarm : public cyclus::Trader {
+ public:
+  Alarm(cyclus::Agent* manager, int at) : cyclus::Trader(manager), at(at) {}
+
+  virtual std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr>
+      GetMatlRequests() {
+    asked.push_back(manager()->context()->time());
+    return std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr>();
+  }
+
+  virtual int NextRequestTime() {
+    int time = manager()->context()->time();
+    return at >= time ? at : std::numeric_limits<int>::max();
+  }
+
+  int at;
+  std::vector<int> asked;
+};
+
+// logs the id and time of every decommissioning
+class Retiree : public cyclus::Facility {
+ public:
+  Retiree(cyclus::Context* ctx) : cyclus::Facility(ctx) {}
+  virtual ~Retiree() {}
+
+  virtual cyclus::Agent* Clone() { return new Retiree(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual void Decommission() {
+    log.push_back(std::make_pair(id(), context()->time()));
+    cyclus::Facility::Decommission();
+  }
+
+  void Tick() {}
+  void Tock() {}
+  void Decision() {}
+  static std::vector<std::pair<int, int> > log;
+};
+
+std::vector<std::pair<int, int> > Retiree::log;
+
+// holds two materials with different compositions in an inventory that is
+// emptied at t = 3
+class Holder : public cyclus::Facility {
+ public:
+  Holder(cyclus::Context* ctx) : cyclus::Facility(ctx) {
+    cyclus::CompMap v;
+    v[922350000] = 1;
+    inv.push_back(cyclus::Material::CreateUntracked(
+        1, cyclus::Composition::CreateFromMass(v)));
+    v[922380000] = 1;
+    inv.push_back(cyclus::Material::CreateUntracked(
+        2, cyclus::Composition::CreateFromMass(v)));
+  }
+  virtual ~Holder() {}
+
+  virtual cyclus::Agent* Clone() { return new Holder(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() {
+    cyclus::Inventories invs;
+    invs["store"] = inv;
+    return invs;
+  }
+
+  void Tick() {
+    if (context()->time() == 3) {
+      inv.clear();
+    }
+  }
+  void Tock() {}
+  void Decision() {}
+
+  std::vector<cyclus::Resource::Ptr> inv;
+};
+
 TEST(TimerTests, BareSim) {
   cyclus::PyStart();
   cyclus::Recorder rec;
@@ -260,3 +446,471 @@ TEST(TimerTests, DoubleDecom) {
   EXPECT_EQ(1, Dier::decom_count);
   cyclus::PyStop();
 }
+
+TEST(TimerTests, ThreadSafeListenersKeepOrder) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(3);
+  si.threads = 4;
+  ti.Initialize(&ctx, si);
+
+  // a serial ticker in the middle splits the thread safe ones into two runs
+  std::vector<int> ids;
+  for (int i = 0; i < 9; ++i) {
+    Ticker* t = new Ticker(&ctx, i != 4);
+    t->Build(NULL);
+    ids.push_back(t->id());
+  }
+
+  ti.RunSim();
+  rec.Close();
+
+  cyclus::QueryResult qr = b.Query("Ticks", NULL);
+  ASSERT_EQ(27, qr.rows.size());
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    EXPECT_EQ(i / 9, qr.GetVal<int>("Time", i));
+    EXPECT_EQ(ids[i % 9], qr.GetVal<int>("AgentId", i));
+  }
+  cyclus::PyStop();
+}
+
+// runs a sim of thread safe minters (and one serial one, or only serial ones
+// if safe is false) on the given number of threads and returns the ids in its
+// Resources table, relative to the first row
+static std::vector<std::vector<int> > MintedIds(int threads,
+                                                bool safe = true) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(4);
+  si.threads = threads;
+  ti.Initialize(&ctx, si);
+  for (int i = 0; i < 7; ++i) {
+    Minter* m = new Minter(&ctx, safe && i != 3, i);
+    m->Build(NULL);
+  }
+  ti.RunSim();
+  rec.Close();
+
+  // parents are resource ids
+  const char* cols[] = {"ResourceId", "ObjId", "QualId", "Parent1"};
+  const char* bases[] = {"ResourceId", "ObjId", "QualId", "ResourceId"};
+  cyclus::QueryResult qr = b.Query("Resources", NULL);
+  std::vector<std::vector<int> > ids;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    std::vector<int> row;
+    for (int c = 0; c < 4; ++c) {
+      int id = qr.GetVal<int>(cols[c], i);
+      row.push_back(id == 0 ? 0 : id - qr.GetVal<int>(bases[c], 0));
+    }
+    ids.push_back(row);
+  }
+  cyclus::PyStop();
+  return ids;
+}
+
+TEST(TimerTests, ThreadSafeListenersMintSameIds) {
+  std::vector<std::vector<int> > two = MintedIds(2);
+  ASSERT_LT(0, two.size());
+  EXPECT_EQ(two, MintedIds(4));
+  EXPECT_EQ(two, MintedIds(8));
+
+  // on a single thread the annotation does not change ids
+  EXPECT_EQ(MintedIds(1, false), MintedIds(1));
+}
+
+TEST(TimerTests, PhaseTimings) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(2);
+  si.phase_timings = true;
+  ti.Initialize(&ctx, si);
+
+  for (int i = 0; i < 3; ++i) {
+    Ticker* t = new Ticker(&ctx, false);
+    t->prototype("ticker");
+    t->Build(NULL);
+  }
+
+  ti.RunSim();
+  rec.Close();
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("Time", "==", 1));
+  conds.push_back(cyclus::Cond("Prototype", "==", std::string("")));
+  cyclus::QueryResult qr = b.Query("PhaseTimings", &conds);
+  std::set<std::string> phases;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    phases.insert(qr.GetVal<std::string>("Phase", i));
+    EXPECT_LE(0, qr.GetVal<double>("Seconds", i));
+  }
+  EXPECT_EQ(1, phases.count("Build"));
+  EXPECT_EQ(1, phases.count("Tick"));
+  EXPECT_EQ(1, phases.count("ResEx"));
+  EXPECT_EQ(1, phases.count("ResEx.Requests"));
+  EXPECT_EQ(1, phases.count("ResEx.Bids"));
+  EXPECT_EQ(1, phases.count("ResEx.Prefs"));
+  EXPECT_EQ(1, phases.count("Tock"));
+  EXPECT_EQ(1, phases.count("Decision"));
+  EXPECT_EQ(1, phases.count("Decom"));
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("Prototype", "==", std::string("ticker")));
+  conds.push_back(cyclus::Cond("Phase", "==", std::string("Tick")));
+  qr = b.Query("PhaseTimings", &conds);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(3, qr.GetVal<int>("Calls", 0));
+  EXPECT_EQ(3, qr.GetVal<int>("Calls", 1));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, SchedWake) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(10));
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->nap = 4;
+  s->Build(NULL);
+
+  // notified at t = 0, 4, 8
+  ti.RunSim();
+  EXPECT_EQ(3, s->ticks);
+  EXPECT_EQ(3, s->tocks);
+  EXPECT_EQ(3, s->decisions);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, SchedWakeEarly) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(5));
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->Build(NULL);
+  ctx.SchedWake(s, 100);
+  ctx.SchedWake(s, 3);
+
+  // the later call replaces the first, so s wakes at t = 3
+  ti.RunSim();
+  EXPECT_EQ(3, s->ticks);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, PhaseSubscription) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(5));
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->Build(NULL);
+  ctx.RegisterTimeListener(s, cyclus::kTockPhase | cyclus::kDecisionPhase);
+
+  ti.RunSim();
+  EXPECT_EQ(0, s->ticks);
+  EXPECT_EQ(5, s->tocks);
+  EXPECT_EQ(5, s->decisions);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, FastForward) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(10);
+  si.fast_forward = true;
+  ti.Initialize(&ctx, si);
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->nap = 4;
+  s->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+  EXPECT_EQ(3, s->ticks);
+
+  // runs t = 0, 4, 8 and skips everything in between
+  cyclus::QueryResult qr = b.Query("FastForward", NULL);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("StartTime", 0));
+  EXPECT_EQ(3, qr.GetVal<int>("Duration", 0));
+  EXPECT_EQ(5, qr.GetVal<int>("StartTime", 1));
+  EXPECT_EQ(3, qr.GetVal<int>("Duration", 1));
+  EXPECT_EQ(9, qr.GetVal<int>("StartTime", 2));
+  EXPECT_EQ(1, qr.GetVal<int>("Duration", 2));
+
+  qr = b.Query("Finish", NULL);
+  EXPECT_EQ(9, qr.GetVal<int>("EndTime"));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, FastForwardSleepingFacilities) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(10);
+  si.fast_forward = true;
+  ti.Initialize(&ctx, si);
+
+  // plain facilities are traders too, but do not keep the timer from fast
+  // forwarding while they sleep
+  Sleeper* s1 = new Sleeper(&ctx);
+  s1->nap = 3;
+  s1->Build(NULL);
+  Sleeper* s2 = new Sleeper(&ctx);
+  s2->nap = 5;
+  s2->Build(NULL);
+  ASSERT_EQ(2, ctx.traders().size());
+
+  ti.RunSim();
+  rec.Close();
+  EXPECT_EQ(4, s1->ticks);
+  EXPECT_EQ(2, s2->ticks);
+
+  // runs t = 0, 3, 5, 6, 9
+  cyclus::QueryResult qr = b.Query("FastForward", NULL);
+  ASSERT_EQ(3, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("StartTime", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("Duration", 0));
+  EXPECT_EQ(4, qr.GetVal<int>("StartTime", 1));
+  EXPECT_EQ(1, qr.GetVal<int>("Duration", 1));
+  EXPECT_EQ(7, qr.GetVal<int>("StartTime", 2));
+  EXPECT_EQ(2, qr.GetVal<int>("Duration", 2));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, FastForwardStopsForTraders) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  cyclus::SimInfo si(10);
+  si.fast_forward = true;
+  ti.Initialize(&ctx, si);
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->nap = 4;
+  s->Build(NULL);
+  // the alarm's manager neither listens nor trades itself
+  Dier* d = new Dier(&ctx);
+  d->Build(NULL);
+  ctx.UnregisterTimeListener(d);
+  ctx.UnregisterTrader(d);
+  Alarm alarm(d, 6);
+  ctx.RegisterTrader(&alarm);
+
+  ti.RunSim();
+  ctx.UnregisterTrader(&alarm);
+  std::vector<int> exp;
+  exp.push_back(0);
+  exp.push_back(4);
+  exp.push_back(6);
+  exp.push_back(8);
+  EXPECT_EQ(exp, alarm.asked);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, FastForwardStopsAtDecom) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  cyclus::SimInfo si(10);
+  si.fast_forward = true;
+  ti.Initialize(&ctx, si);
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->nap = 100;
+  s->Build(NULL);
+  Dier* d = new Dier(&ctx);
+  d->Build(NULL);
+  ctx.UnregisterTimeListener(d);
+  ctx.SchedDecom(d, 6);
+
+  Dier::decom_count = 0;
+  ti.RunSim();
+  EXPECT_EQ(1, s->ticks);
+  EXPECT_EQ(1, Dier::decom_count);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, FastForwardSkipsRescheduledDecom) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(10);
+  si.fast_forward = true;
+  ti.Initialize(&ctx, si);
+
+  Sleeper* s = new Sleeper(&ctx);
+  s->nap = 100;
+  s->Build(NULL);
+  Dier* d = new Dier(&ctx);
+  d->Build(NULL);
+  ctx.UnregisterTimeListener(d);
+  ctx.UnregisterTrader(d);
+  ctx.SchedDecom(d, 4);
+  ctx.SchedDecom(d, 7);
+
+  Dier::decom_count = 0;
+  ti.RunSim();
+  rec.Close();
+  EXPECT_EQ(1, Dier::decom_count);
+
+  // the emptied slot at t = 4 does not stop fast forwarding
+  cyclus::QueryResult qr = b.Query("FastForward", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("StartTime", 0));
+  EXPECT_EQ(6, qr.GetVal<int>("Duration", 0));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, RescheduleDecom) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+
+  std::vector<int> ids;
+  std::vector<Retiree*> rs;
+  for (int i = 0; i < 4; ++i) {
+    Retiree* r = new Retiree(&ctx);
+    r->Build(NULL);
+    ctx.SchedDecom(r, 2);
+    rs.push_back(r);
+    ids.push_back(r->id());
+  }
+  // move the first and last agents' decommissioning earlier
+  ctx.SchedDecom(rs[0], 1);
+  ctx.SchedDecom(rs[3], 0);
+
+  Retiree::log.clear();
+  ti.RunSim();
+  ASSERT_EQ(4, Retiree::log.size());
+  EXPECT_EQ(std::make_pair(ids[3], 0), Retiree::log[0]);
+  EXPECT_EQ(std::make_pair(ids[0], 1), Retiree::log[1]);
+  EXPECT_EQ(std::make_pair(ids[1], 2), Retiree::log[2]);
+  EXPECT_EQ(std::make_pair(ids[2], 2), Retiree::log[3]);
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, CancelDecom) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+
+  std::vector<Retiree*> rs;
+  for (int i = 0; i < 3; ++i) {
+    Retiree* r = new Retiree(&ctx);
+    r->Build(NULL);
+    ctx.SchedDecom(r, 1);
+    rs.push_back(r);
+  }
+  EXPECT_TRUE(ctx.CancelDecom(rs[1]));
+  EXPECT_FALSE(ctx.CancelDecom(rs[1]));
+  EXPECT_EQ(-1, ctx.DecomTime(rs[1]));
+  ctx.SchedDecom(rs[2], 2);
+  EXPECT_EQ(1, ctx.DecomTime(rs[0]));
+  EXPECT_EQ(2, ctx.DecomTime(rs[2]));
+
+  int id0 = rs[0]->id();
+  int id2 = rs[2]->id();
+  Retiree::log.clear();
+  ti.RunSim();
+  ASSERT_EQ(2, Retiree::log.size());
+  EXPECT_EQ(std::make_pair(id0, 1), Retiree::log[0]);
+  EXPECT_EQ(std::make_pair(id2, 2), Retiree::log[1]);
+  EXPECT_EQ(-1, ctx.DecomTime(rs[1]));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, ExplicitInventoryIntervalDelta) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(6);
+  si.explicit_inventory = true;
+  si.explicit_inventory_compact = true;
+  si.explicit_inventory_delta = true;
+  si.explicit_inventory_interval = 2;
+  ti.Initialize(&ctx, si);
+
+  Holder* h = new Holder(&ctx);
+  h->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  // recorded at t = 0 and 2 only; the inventory is empty from t = 3 on
+  cyclus::QueryResult qr = b.Query("ExplicitInventoryCompact", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_EQ(2, qr.GetVal<int>("Time", 1));
+  EXPECT_DOUBLE_EQ(3, qr.GetVal<double>("Quantity", 1));
+  cyclus::CompMap c = qr.GetVal<cyclus::CompMap>("Composition", 1);
+  EXPECT_DOUBLE_EQ(2.0 / 3, c[922350000]);
+  EXPECT_DOUBLE_EQ(1.0 / 3, c[922380000]);
+
+  qr = b.Query("ExplicitInventory", NULL);
+  ASSERT_EQ(4, qr.rows.size());
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    int nuc = qr.GetVal<int>("NucId", i);
+    double want = nuc == 922350000 ? 2 : 1;
+    EXPECT_DOUBLE_EQ(want, qr.GetVal<double>("Quantity", i));
+  }
+
+  // only the first record and the emptying are in the delta table
+  qr = b.Query("ExplicitInventoryDelta", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  EXPECT_EQ(0, qr.GetVal<int>("Time", 0));
+  EXPECT_DOUBLE_EQ(3, qr.GetVal<double>("Quantity", 0));
+  EXPECT_EQ(4, qr.GetVal<int>("Time", 1));
+  EXPECT_DOUBLE_EQ(0, qr.GetVal<double>("Quantity", 1));
+  cyclus::PyStop();
+}
@@ -76,6 +76,31 @@ TEST_F(MatlSellPolicyTests, StartStop) {
   ASSERT_THROW(p.Stop(), ValueError);
 }
 
+TEST_F(MatlSellPolicyTests, Subscriptions) {
+  MatlSellPolicy p;
+  p.Init(fac1, &buff, "").Set("a").Start();
+  std::set<std::string> exp;
+  exp.insert("a");
+  ASSERT_EQ(1, tc.get()->bid_commods().count(&p));
+  EXPECT_EQ(exp, tc.get()->bid_commods().at(&p));
+
+  p.Set("b");
+  exp.insert("b");
+  EXPECT_EQ(exp, tc.get()->bid_commods().at(&p));
+
+  ASSERT_EQ(1, tc.get()->commod_bidders().count("b"));
+  EXPECT_EQ(1, tc.get()->commod_bidders().at("b").count(&p));
+
+  p.Stop();
+  EXPECT_EQ(0, tc.get()->bid_commods().count(&p));
+  EXPECT_TRUE(tc.get()->commod_bidders().empty());
+
+  // policies that are set but never started do not subscribe
+  MatlSellPolicy q;
+  q.Init(fac1, &buff, "").Set("a");
+  EXPECT_EQ(0, tc.get()->bid_commods().count(&q));
+}
+
 TEST_F(MatlSellPolicyTests, Bids) {
   MatlSellPolicy p;
   std::string commod("commod");